@@ -1,37 +1,104 @@
 #include "Allocator.h"
 #include "DataTypes.h"
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
 #include <new>
 #include <assert.h>
+#ifdef WIN32
+#include <malloc.h>
+#else
+#include <sys/mman.h>
+#endif
+
+// The address of this variable identifies the calling thread
+static thread_local CHAR _thread;
+
+// Round the block size up to the alignment. Pool blocks are carved back to back, so
+// they are also rounded to a pointer so the free-list link in each block is aligned.
+static size_t BlockSize(size_t size, size_t alignment, UINT objects)
+{
+    if (objects && alignment < alignof(void*))
+        alignment = alignof(void*);
+    else if (alignment == 0)
+        alignment = 1;
+    if (size < sizeof(long*))
+        size = sizeof(long*);
+    return (size + alignment - 1) & ~(alignment - 1);
+}
 
 //------------------------------------------------------------------------------
 // Constructor
 //------------------------------------------------------------------------------
-Allocator::Allocator(size_t size, UINT objects, CHAR* memory, const CHAR* name) :
-    m_blockSize(size < sizeof(long*) ? sizeof(long*):size),
-    m_objectSize(size),
+Allocator::Allocator(size_t size, UINT objects, CHAR* memory, const CHAR* name, size_t alignment, Flags flags) :
+    m_alignment(alignment),
+    m_blockSize(BlockSize(size, alignment, objects)),
     m_maxObjects(objects),
     m_pHead(NULL),
+    m_pRemoteHead(NULL),
+    m_pPool(NULL),
+    m_pSlabs(NULL),
+    m_pSlabNext(NULL),
+    m_pSlabEnd(NULL),
+    m_slabHeaderSize(0),
+    m_hugePages(FALSE),
+    m_threadSafe((flags & THREAD_SAFE) ? TRUE : FALSE),
+    m_pOwner(NULL),
+    m_sharedHead(0),
     m_poolIndex(0),
     m_blockCnt(0),
     m_blocksInUse(0),
+    m_highWater(0),
     m_allocations(0),
     m_deallocations(0),
+    m_failedAllocations(0),
+    m_bytesReserved(0),
+    m_sharedAllocations(0),
+    m_sharedDeallocations(0),
     m_name(name)
 {
+    BOOL slabs = (flags & SLABS) ? TRUE : FALSE;
+    assert((alignment & (alignment - 1)) == 0);
+    assert(!(slabs && m_threadSafe));
+
     // If using a fixed memory pool 
 	if (m_maxObjects)
 	{
 		// If caller provided an external memory pool
 		if (memory)
 		{
+			// The caller sized the memory as size x objects, so the size must not
+			// need rounding to keep each block's free-list link aligned
+			assert(alignment == 0 || ((size_t)memory & (alignment - 1)) == 0);
+			assert(m_blockSize == size);
 			m_pPool = memory;
 			m_allocatorMode = STATIC_POOL;
 		}
+		else if (flags & HUGE_PAGES)
+		{
+			// Page aligned, so any block alignment up to the page size is kept
+			m_pPool = NewHugePages(m_blockSize * m_maxObjects, &m_hugePages);
+			m_allocatorMode = HUGE_PAGE_POOL;
+		}
 		else 
 		{
-			m_pPool = (CHAR*)new CHAR[m_blockSize * m_maxObjects];
+			m_pPool = NewMemory(m_blockSize * m_maxObjects);
 			m_allocatorMode = HEAP_POOL;
 		}
+		m_bytesReserved = m_blockSize * m_maxObjects;
+	}
+	else if (slabs)
+	{
+		// Blocks start after the slab header, aligned to the block alignment. The header 
+		// has a cache line of its own so that writes to blocks by other threads do not 
+		// slow down the owner lookup.
+		size_t blockAlignment = alignment > 64 ? alignment : 64;
+		m_slabHeaderSize = (sizeof(SlabHeader) + blockAlignment - 1) & ~(blockAlignment - 1);
+		assert(m_slabHeaderSize < ALLOCATOR_SLAB_SIZE);
+
+		// Slab blocks are contiguous, so the size keeps each block's free-list link aligned
+		assert(m_blockSize % sizeof(long*) == 0);
+		m_allocatorMode = HEAP_SLABS;
 	}
 	else
 		m_allocatorMode = HEAP_BLOCKS;
@@ -42,14 +109,34 @@ Allocator::Allocator(size_t size, UINT objects, CHAR* memory, const CHAR* name)
 //------------------------------------------------------------------------------
 Allocator::~Allocator()
 {
+	ReclaimRemoteBlocks();
+
 	// If using pool then destroy it, otherwise traverse free-list and 
 	// destroy each individual block
 	if (m_allocatorMode == HEAP_POOL)
-		delete [] m_pPool;
+		DeleteMemory(m_pPool);
+	else if (m_allocatorMode == HUGE_PAGE_POOL)
+		DeleteHugePages(m_pPool, m_blockSize * m_maxObjects);
 	else if (m_allocatorMode == HEAP_BLOCKS)
 	{
 		while(m_pHead)
-			delete [] (CHAR*)Pop();
+			DeleteMemory((CHAR*)Pop());
+		void* pBlock;
+		while ((pBlock = PopShared()) != NULL)
+			DeleteMemory((CHAR*)pBlock);
+	}
+	else if (m_allocatorMode == HEAP_SLABS)
+	{
+		while (m_pSlabs)
+		{
+			SlabHeader* pSlab = m_pSlabs;
+			m_pSlabs = pSlab->pNext;
+#ifdef WIN32
+			_aligned_free(pSlab);
+#else
+			free(pSlab);
+#endif
+		}
 	}
 }
 
@@ -58,55 +145,362 @@ Allocator::~Allocator()
 //------------------------------------------------------------------------------
 void* Allocator::Allocate(size_t size)
 {
-    assert(size <= m_objectSize);
+    assert(size <= m_blockSize);
+
+    if (m_threadSafe && !IsOwner())
+        return AllocateShared();
 	
-    // If can't obtain existing block then get a new one
+    // If can't obtain existing block then reclaim remotely freed blocks, or get a new one
     void* pBlock = Pop();
+    if (!pBlock && ReclaimRemoteBlocks())
+        pBlock = Pop();
+    if (!pBlock && m_threadSafe)
+        pBlock = PopShared();
     if (!pBlock)
     {
-        // If using a pool method then get block from pool,
-        // otherwise using dynamic so get block from heap
-        if (m_maxObjects)
+        pBlock = CreateBlock();
+        if (!pBlock)
+            return NULL;
+    }
+
+    UINT blocksInUse = m_blocksInUse.load(std::memory_order_relaxed) + 1;
+    m_blocksInUse.store(blocksInUse, std::memory_order_relaxed);
+    if (m_threadSafe)
+        blocksInUse = GetBlocksInUse();
+    if (blocksInUse > m_highWater.load(std::memory_order_relaxed))
+        m_highWater.store(blocksInUse, std::memory_order_relaxed);
+    AddStat(m_allocations, 1u);
+	
+    return pBlock;
+}
+
+//------------------------------------------------------------------------------
+// Deallocate
+//------------------------------------------------------------------------------
+void Allocator::Deallocate(void* pBlock)
+{
+    // Other threads return blocks to the owner through the remote free-list
+    if (m_threadSafe && !IsOwner())
+    {
+        DeallocateRemote(pBlock, pBlock);
+        m_sharedDeallocations.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    Push(pBlock);
+	AddStat(m_blocksInUse, (UINT)-1);
+	AddStat(m_deallocations, 1u);
+}
+
+//------------------------------------------------------------------------------
+// IsOwner
+//------------------------------------------------------------------------------
+BOOL Allocator::IsOwner()
+{
+    void* pOwner = m_pOwner.load(std::memory_order_relaxed);
+    if (pOwner == &_thread)
+        return TRUE;
+    return (pOwner == NULL && m_pOwner.compare_exchange_strong(pOwner, &_thread)) ? TRUE : FALSE;
+}
+
+//------------------------------------------------------------------------------
+// AllocateShared
+//------------------------------------------------------------------------------
+void* Allocator::AllocateShared()
+{
+    // Take a block from the shared free-list, else take the remotely freed blocks 
+    // and share all but one of them with the other threads
+    void* pBlock = PopShared();
+    if (!pBlock)
+    {
+        Block* pChain = (Block*)ReclaimRemote();
+        if (pChain)
         {
-            // If we have not exceeded the pool maximum
-            if(m_poolIndex < m_maxObjects)
+            Block* pRest = pChain->pNext.load(std::memory_order_relaxed);
+            if (pRest)
             {
-                pBlock = (void*)(m_pPool + (m_poolIndex++ * m_blockSize));
+                Block* pLast = pRest;
+                while (Block* pNext = pLast->pNext.load(std::memory_order_relaxed))
+                    pLast = pNext;
+                PushShared(pRest, pLast);
             }
-            else
+            pBlock = pChain;
+        }
+        else
+        {
+            pBlock = CreateBlock();
+            if (!pBlock)
+                return NULL;
+        }
+    }
+    m_sharedAllocations.fetch_add(1, std::memory_order_relaxed);
+    return pBlock;
+}
+
+//------------------------------------------------------------------------------
+// CreateBlock
+//------------------------------------------------------------------------------
+void* Allocator::CreateBlock()
+{
+    // If using a pool method then get block from pool,
+    // otherwise using dynamic so get block from heap
+    if (!m_maxObjects)
+        return NewBlock();
+
+    // Claim the next unused pool block unless the pool is exhausted
+    UINT index = m_poolIndex.load(std::memory_order_relaxed);
+    if (m_threadSafe)
+    {
+        while (index < m_maxObjects &&
+            !m_poolIndex.compare_exchange_weak(index, index + 1, std::memory_order_relaxed))
+            ;
+    }
+    else if (index < m_maxObjects)
+        m_poolIndex.store(index + 1, std::memory_order_relaxed);
+
+    if (index < m_maxObjects)
+        return (void*)(m_pPool + (index * m_blockSize));
+
+    AddSharedStat(m_failedAllocations, 1u);
+
+    // Get the pointer to the new handler
+    std::new_handler handler = std::set_new_handler(0);
+    std::set_new_handler(handler);
+
+    // If a new handler is defined, call it
+    if (handler)
+        (*handler)();
+    else
+        assert(0);
+    return NULL;
+}
+
+//------------------------------------------------------------------------------
+// Reserve
+//------------------------------------------------------------------------------
+BOOL Allocator::Reserve(UINT blocks, BOOL lockPages)
+{
+    // Pool blocks are handed out in order, so touch the next unused blocks. Freed 
+    // blocks may be anywhere in the used part of the pool, so lock all of it.
+    if (m_maxObjects)
+    {
+        UINT poolIndex = m_poolIndex.load(std::memory_order_relaxed);
+        UINT count = (blocks < m_maxObjects - poolIndex) ? blocks : m_maxObjects - poolIndex;
+        PrefaultMemory(m_pPool + poolIndex * m_blockSize, count * m_blockSize, FALSE);
+        if (!lockPages)
+            return TRUE;
+        return LockMemory(m_pPool, (poolIndex + count) * m_blockSize);
+    }
+
+    // Free-list blocks were touched when first used, so only lock them. Only the 
+    // owner may walk its free-list, and the shared lists of a thread safe allocator 
+    // are popped concurrently, so blocks there cannot be locked.
+    BOOL locked = TRUE;
+    UINT freeBlocks = GetBlockCount() - GetBlocksInUse();
+    UINT reserved = (freeBlocks < blocks) ? freeBlocks : blocks;
+    if (lockPages)
+    {
+        UINT lockedBlocks = 0;
+        if (!m_threadSafe || m_pOwner.load(std::memory_order_relaxed) == &_thread)
+        {
+            for (Block* pBlock = m_pHead; pBlock && lockedBlocks < reserved; lockedBlocks++)
             {
-                // Get the pointer to the new handler
-                std::new_handler handler = std::set_new_handler(0);
-                std::set_new_handler(handler);
-
-                // If a new handler is defined, call it
-                if (handler)
-                    (*handler)();
-                else
-                    assert(0);
+                if (!LockMemory(pBlock, m_blockSize))
+                    locked = FALSE;
+                pBlock = pBlock->pNext.load(std::memory_order_relaxed);
             }
         }
+        if (lockedBlocks < reserved)
+            locked = FALSE;
+    }
+
+    for (UINT i = freeBlocks; i < blocks; i++)
+    {
+        void* pBlock = NewBlock();
+        if (!PrefaultMemory(pBlock, m_blockSize, lockPages))
+            locked = FALSE;
+
+        // Any thread of a thread safe allocator may take the shared blocks
+        if (m_threadSafe)
+            PushShared((Block*)pBlock, (Block*)pBlock);
         else
+            Push(pBlock);
+    }
+    return locked;
+}
+
+//------------------------------------------------------------------------------
+// PrefaultMemory
+//------------------------------------------------------------------------------
+BOOL Allocator::PrefaultMemory(void* pMemory, size_t size, BOOL lockPages)
+{
+    if (size == 0)
+        return TRUE;
+
+    memset(pMemory, 0, size);
+    if (!lockPages)
+        return TRUE;
+    return LockMemory(pMemory, size);
+}
+
+//------------------------------------------------------------------------------
+// LockMemory
+//------------------------------------------------------------------------------
+BOOL Allocator::LockMemory(void* pMemory, size_t size)
+{
+    if (size == 0)
+        return TRUE;
+#ifdef WIN32
+    return VirtualLock(pMemory, size) ? TRUE : FALSE;
+#else
+    return (mlock(pMemory, size) == 0) ? TRUE : FALSE;
+#endif
+}
+
+//------------------------------------------------------------------------------
+// NewHugePages
+//------------------------------------------------------------------------------
+CHAR* Allocator::NewHugePages(size_t size, BOOL* pHugePages)
+{
+    BOOL hugePages = FALSE;
+    void* pMemory;
+#ifdef WIN32
+    // Large pages require the SeLockMemoryPrivilege
+    SIZE_T largePage = GetLargePageMinimum();
+    pMemory = NULL;
+    if (largePage)
+    {
+        pMemory = VirtualAlloc(NULL, (size + largePage - 1) & ~(largePage - 1), 
+            MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+        hugePages = (pMemory != NULL) ? TRUE : FALSE;
+    }
+    if (pMemory == NULL)
+        pMemory = VirtualAlloc(NULL, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+#else
+    size_t hugeSize = (size + ALLOCATOR_HUGE_PAGE_SIZE - 1) & ~(size_t)(ALLOCATOR_HUGE_PAGE_SIZE - 1);
+    pMemory = MAP_FAILED;
+#ifdef MAP_HUGETLB
+    pMemory = mmap(NULL, hugeSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    hugePages = (pMemory != MAP_FAILED) ? TRUE : FALSE;
+#endif
+    if (pMemory == MAP_FAILED)
+    {
+        // Map an extra huge page and trim the ends so the memory is huge page aligned, 
+        // which transparent huge pages require
+        CHAR* pMap = (CHAR*)mmap(NULL, hugeSize + ALLOCATOR_HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE, 
+            MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (pMap != MAP_FAILED)
         {
-        	m_blockCnt++;
-            pBlock = (void*)new CHAR[m_blockSize];
+            CHAR* pAligned = (CHAR*)(((size_t)pMap + ALLOCATOR_HUGE_PAGE_SIZE - 1) & ~(size_t)(ALLOCATOR_HUGE_PAGE_SIZE - 1));
+            if (pAligned != pMap)
+                munmap(pMap, pAligned - pMap);
+            munmap(pAligned + hugeSize, (pMap + ALLOCATOR_HUGE_PAGE_SIZE) - pAligned);
+            pMemory = pAligned;
+#ifdef MADV_HUGEPAGE
+            hugePages = (madvise(pMemory, hugeSize, MADV_HUGEPAGE) == 0) ? TRUE : FALSE;
+#endif
         }
     }
+    if (pMemory == MAP_FAILED)
+        pMemory = NULL;
+#endif
+    if (pMemory == NULL)
+        throw std::bad_alloc();
 
-    m_blocksInUse++;
-    m_allocations++;
-	
+    if (pHugePages)
+        *pHugePages = hugePages;
+    return (CHAR*)pMemory;
+}
+
+//------------------------------------------------------------------------------
+// DeleteHugePages
+//------------------------------------------------------------------------------
+void Allocator::DeleteHugePages(CHAR* pMemory, size_t size)
+{
+#ifdef WIN32
+    VirtualFree(pMemory, 0, MEM_RELEASE);
+#else
+    munmap(pMemory, (size + ALLOCATOR_HUGE_PAGE_SIZE - 1) & ~(size_t)(ALLOCATOR_HUGE_PAGE_SIZE - 1));
+#endif
+}
+
+//------------------------------------------------------------------------------
+// NewBlock
+//------------------------------------------------------------------------------
+void* Allocator::NewBlock()
+{
+    if (m_allocatorMode == HEAP_SLABS)
+        return NewSlabBlock();
+
+    void* pBlock = (void*)NewMemory(m_blockSize);
+    AddSharedStat(m_blockCnt, 1u);
+    AddSharedStat(m_bytesReserved, m_blockSize);
     return pBlock;
 }
 
 //------------------------------------------------------------------------------
-// Deallocate
+// NewMemory
 //------------------------------------------------------------------------------
-void Allocator::Deallocate(void* pBlock)
+CHAR* Allocator::NewMemory(size_t size)
 {
-    Push(pBlock);
-	m_blocksInUse--;
-	m_deallocations++;
+    if (m_alignment <= alignof(std::max_align_t))
+        return new CHAR[size];
+
+    // Over allocate, align, and keep the original pointer just below the aligned 
+    // memory for DeleteMemory()
+    CHAR* pRaw = new CHAR[size + m_alignment + sizeof(CHAR*)];
+    CHAR* pAligned = (CHAR*)(((size_t)pRaw + sizeof(CHAR*) + m_alignment - 1) & ~(m_alignment - 1));
+    ((CHAR**)pAligned)[-1] = pRaw;
+    return pAligned;
+}
+
+//------------------------------------------------------------------------------
+// DeleteMemory
+//------------------------------------------------------------------------------
+void Allocator::DeleteMemory(CHAR* pMemory)
+{
+    if (m_alignment <= alignof(std::max_align_t))
+        delete [] pMemory;
+    else
+        delete [] ((CHAR**)pMemory)[-1];
+}
+
+//------------------------------------------------------------------------------
+// NewSlabBlock
+//------------------------------------------------------------------------------
+void* Allocator::NewSlabBlock()
+{
+    if (m_pSlabNext == m_pSlabEnd)
+    {
+        // Every block must start within the first ALLOCATOR_SLAB_SIZE bytes so that 
+        // masking its address finds the header. A block larger than the slab gets 
+        // a slab of its own that extends past ALLOCATOR_SLAB_SIZE.
+        size_t blocks = (ALLOCATOR_SLAB_SIZE - m_slabHeaderSize + m_blockSize - 1) / m_blockSize;
+        size_t size = m_slabHeaderSize + blocks * m_blockSize;
+
+        void* pMemory;
+#ifdef WIN32
+        pMemory = _aligned_malloc(size, ALLOCATOR_SLAB_SIZE);
+#else
+        if (posix_memalign(&pMemory, ALLOCATOR_SLAB_SIZE, size) != 0)
+            pMemory = NULL;
+#endif
+        if (pMemory == NULL)
+            throw std::bad_alloc();
+
+        SlabHeader* pSlab = (SlabHeader*)pMemory;
+        pSlab->pOwner = this;
+        pSlab->pNext = m_pSlabs;
+        m_pSlabs = pSlab;
+        m_pSlabNext = (CHAR*)pMemory + m_slabHeaderSize;
+        m_pSlabEnd = m_pSlabNext + blocks * m_blockSize;
+        AddStat(m_bytesReserved, size);
+    }
+
+    void* pBlock = m_pSlabNext;
+    m_pSlabNext += m_blockSize;
+    AddStat(m_blockCnt, 1u);
+    return pBlock;
 }
 
 //------------------------------------------------------------------------------
@@ -115,7 +509,7 @@ void Allocator::Deallocate(void* pBlock)
 void Allocator::Push(void* pMemory)
 {
     Block* pBlock = (Block*)pMemory;
-    pBlock->pNext = m_pHead;
+    pBlock->pNext.store(m_pHead, std::memory_order_relaxed);
     m_pHead = pBlock;
 }
 
@@ -129,13 +523,99 @@ void* Allocator::Pop()
     if (m_pHead)
     {
         pBlock = m_pHead;
-        m_pHead = m_pHead->pNext;
+        m_pHead = m_pHead->pNext.load(std::memory_order_relaxed);
     }
 
     return (void*)pBlock;
 }
 
+//------------------------------------------------------------------------------
+// DeallocateRemote
+//------------------------------------------------------------------------------
+void Allocator::DeallocateRemote(void* pFirst, void* pLast)
+{
+    // Push the whole chain with one compare-and-swap. Blocks are only removed by 
+    // exchanging the entire list for NULL, so there is no ABA hazard.
+    Block* pHead = m_pRemoteHead.load(std::memory_order_relaxed);
+    do
+    {
+        ((Block*)pLast)->pNext.store(pHead, std::memory_order_relaxed);
+    } while (!m_pRemoteHead.compare_exchange_weak(pHead, (Block*)pFirst,
+        std::memory_order_release, std::memory_order_relaxed));
+}
+
+//------------------------------------------------------------------------------
+// ReclaimRemote
+//------------------------------------------------------------------------------
+void* Allocator::ReclaimRemote()
+{
+    if (m_pRemoteHead.load(std::memory_order_relaxed) == NULL)
+        return NULL;
+    return m_pRemoteHead.exchange(NULL, std::memory_order_acquire);
+}
+
+//------------------------------------------------------------------------------
+// ReclaimRemoteBlocks
+//------------------------------------------------------------------------------
+BOOL Allocator::ReclaimRemoteBlocks()
+{
+    Block* pBlock = (Block*)ReclaimRemote();
+    if (!pBlock)
+        return FALSE;
 
+    // A thread safe allocator counted the blocks when other threads deallocated them
+    while (pBlock)
+    {
+        Block* pNext = pBlock->pNext.load(std::memory_order_relaxed);
+        if (m_threadSafe)
+            Push(pBlock);
+        else
+            Deallocate(pBlock);
+        pBlock = pNext;
+    }
+    return TRUE;
+}
 
+//------------------------------------------------------------------------------
+// PushShared
+//------------------------------------------------------------------------------
+void Allocator::PushShared(Block* pFirst, Block* pLast)
+{
+    TaggedPtr head = m_sharedHead.load(std::memory_order_relaxed);
+    do
+    {
+        pLast->pNext.store(GetPtr(head), std::memory_order_relaxed);
+    } while (!m_sharedHead.compare_exchange_weak(head, NextTag(head, pFirst),
+        std::memory_order_release, std::memory_order_relaxed));
+}
 
+//------------------------------------------------------------------------------
+// TagBitsInUse
+//------------------------------------------------------------------------------
+void Allocator::TagBitsInUse(void* pBlock)
+{
+    // The process maps memory above 47 bits, e.g. with 5-level paging. The ABA tag 
+    // would overwrite the top address bits, so stop rather than corrupt the list.
+    (void)pBlock;
+    assert(0);
+    abort();
+}
 
+//------------------------------------------------------------------------------
+// PopShared
+//------------------------------------------------------------------------------
+void* Allocator::PopShared()
+{
+    TaggedPtr head = m_sharedHead.load(std::memory_order_acquire);
+    while (Block* pBlock = GetPtr(head))
+    {
+        // pBlock may be popped and written by another thread before the exchange.
+        // Blocks are never returned to the heap while the allocator is in use, so
+        // the read is safe and a stale pNext fails the exchange on the changed tag.
+        Block* pNext = pBlock->pNext.load(std::memory_order_relaxed);
+        if (m_sharedHead.compare_exchange_weak(head, NextTag(head, pNext),
+            std::memory_order_acquire, std::memory_order_acquire))
+            return (void*)pBlock;
+    }
+    return NULL;
+}
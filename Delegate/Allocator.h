@@ -2,22 +2,68 @@
 #define __ALLOCATOR_H
 
 #include "DataTypes.h"
+#include <atomic>
+#include <cstdint>
 #include <stddef.h>
 
+// Size and alignment of the slabs used by slab mode allocators. Must be a power of two.
+#ifndef ALLOCATOR_SLAB_SIZE
+#define ALLOCATOR_SLAB_SIZE	(64 * 1024)
+#endif
+
+// Huge page size used to round and align huge page memory. Must be a power of two.
+#ifndef ALLOCATOR_HUGE_PAGE_SIZE
+#define ALLOCATOR_HUGE_PAGE_SIZE	(2 * 1024 * 1024)
+#endif
+
 /// @see https://github.com/endurodave/Allocator
 /// David Lafreniere
+///
+/// By default an allocator must only be used by one thread. A thread safe allocator 
+/// lets blocks be allocated and deallocated by any thread, e.g. a delegate message 
+/// created on one thread and deleted on another. The first thread to allocate owns 
+/// the free-list and uses it as cheaply as a single thread allocator. Other threads 
+/// return blocks to the lock-free remote free-list, which the owner reclaims in bulk, 
+/// and allocate from a lock-free stack whose head pairs the block pointer with a tag 
+/// incremented on every update, so a compare-and-swap fails if the head was popped and 
+/// pushed back by another thread in between (the ABA problem).
 class Allocator
 {
 public:
+    /// Options of the constructor's flags argument, combined with |.
+    enum Flags
+    {
+        NO_FLAGS = 0,
+
+        /// Carve blocks from heap slabs of ALLOCATOR_SLAB_SIZE bytes aligned to their 
+        /// size, so GetSlabOwner() finds the allocator of a block without any per-block 
+        /// header. The objects argument must be 0. Not supported with THREAD_SAFE.
+        SLABS = 1,
+
+        /// Back a pool obtained from the system (objects not 0 and memory NULL) by huge 
+        /// pages where available. See NewHugePages().
+        HUGE_PAGES = 2,
+
+        /// Let any thread allocate and deallocate blocks.
+        THREAD_SAFE = 4
+    };
+
     /// Constructor
     /// @param[in]  size - size of the fixed blocks
     /// @param[in]  objects - maximum number of object. If 0, new blocks are
 	///		created off the heap as necessary.
 	/// @param[in]	memory - pointer to a block of static memory for allocator or NULL 
 	///		to obtain memory from global heap. If not NULL, the objects argument 
-	///		defines the size of the memory block (size x objects = memory size in bytes).
+	///		defines the size of the memory block (size x objects = memory size in bytes),
+	///		and size must be a multiple of a pointer and of the alignment so that it is
+	///		also the block size.
 	///	@param[in]	name - optional allocator name string.
-    Allocator(size_t size, UINT objects=0, CHAR* memory = NULL, const CHAR* name=NULL);
+	///	@param[in]	alignment - block alignment, a power of two, or 0 for the default 
+	///		new alignment. The block size is rounded up to a multiple of the alignment, 
+	///		and for a pool also of a pointer, so the free-list link in each block is aligned. 
+	///		A static memory block must be aligned by the caller.
+	///	@param[in]	flags - Flags options combined with |, e.g. THREAD_SAFE.
+    Allocator(size_t size, UINT objects=0, CHAR* memory = NULL, const CHAR* name=NULL, size_t alignment=0, Flags flags=NO_FLAGS);
 
     /// Destructor
     ~Allocator();
@@ -31,6 +77,65 @@ public:
     /// @param[in]  pBlock - block of memory deallocate (i.e push onto free-list)
     void Deallocate(void* pBlock);
 
+    /// Create and pre-fault free blocks ahead of use, so that the first allocations 
+    /// after startup do not pay for heap calls and page faults. Pool allocators touch 
+    /// their unused pool blocks. 
+    /// @param[in]  blocks - the number of free blocks to have ready, limited to the 
+    ///     pool size with a memory pool.
+    /// @param[in]  lockPages - if TRUE, also lock the pages of the free blocks counted 
+    ///     toward blocks in memory (mlock) so they are never paged out, including blocks 
+    ///     that were already free. A pool locks every block handed out so far along with 
+    ///     the reserved ones. The pages remain locked while the process runs.
+    /// @return     TRUE if successful. FALSE if the pages could not be locked, e.g. 
+    ///     beyond RLIMIT_MEMLOCK, or if some of the free blocks are on a thread safe 
+    ///     allocator's shared lists, which cannot be walked, or on another thread's 
+    ///     free-list; the blocks are still reserved.
+    BOOL Reserve(UINT blocks, BOOL lockPages=FALSE);
+
+    /// Return a chain of blocks from a thread that does not own the allocator. 
+    /// Lock-free and safe to call from any thread concurrently with the owner. 
+    /// The blocks are reclaimed in bulk by the owner's next Allocate() that finds 
+    /// the free-list empty. Not for thread safe allocators, whose Deallocate() 
+    /// already does this.
+    /// @param[in]  pFirst - first block of the chain. Each block's first word links 
+    ///     to the next block; see LinkBlock().
+    /// @param[in]  pLast - last block of the chain. 
+    void DeallocateRemote(void* pFirst, void* pLast);
+
+    /// Take every block returned by DeallocateRemote(). Lock-free. The blocks 
+    /// remain counted as in use. 
+    /// @return     The first block of the chain, linked with NextBlock(), or NULL.
+    void* ReclaimRemote();
+
+    /// Link a block to the next block of a chain passed to DeallocateRemote().
+    static void LinkBlock(void* pBlock, void* pNext) { 
+        static_cast<Block*>(pBlock)->pNext.store(static_cast<Block*>(pNext), std::memory_order_relaxed); }
+
+    /// Get the block following a block of a chain.
+    static void* NextBlock(void* pBlock) { return static_cast<Block*>(pBlock)->pNext.load(std::memory_order_relaxed); }
+
+    /// Get the allocator that owns a block of a slab mode allocator by masking the block 
+    /// address to its slab header. 
+    /// @param[in]  pBlock - a block returned by Allocate() of a slab mode allocator.
+    /// @return     The allocator that owns the block.
+    static Allocator* GetSlabOwner(void* pBlock) {
+        return ((SlabHeader*)((size_t)pBlock & ~(size_t)(ALLOCATOR_SLAB_SIZE - 1)))->pOwner; }
+
+    /// Get memory backed by huge pages to reduce TLB misses over large pools. Uses 
+    /// explicit huge pages (mmap MAP_HUGETLB, or large pages on Windows) if the system 
+    /// has any free, otherwise ALLOCATOR_HUGE_PAGE_SIZE aligned memory advised to use 
+    /// transparent huge pages (madvise MADV_HUGEPAGE), otherwise ordinary pages.
+    /// @param[in]  size - the memory size in bytes.
+    /// @param[out] pHugePages - optional; set to TRUE if the memory is backed by, or 
+    ///     advised to use, huge pages.
+    /// @return     Page aligned, zero filled memory. Free with DeleteHugePages(). 
+    static CHAR* NewHugePages(size_t size, BOOL* pHugePages=NULL);
+
+    /// Free memory obtained with NewHugePages().
+    /// @param[in]  pMemory - the memory.
+    /// @param[in]  size - the size passed to NewHugePages().
+    static void DeleteHugePages(CHAR* pMemory, size_t size);
+
     /// Get the allocator name string.
     /// @return		A pointer to the allocator name or NULL if none was assigned.
     const CHAR* GetName() { return m_name; }
@@ -39,21 +144,50 @@ public:
     /// @return		The fixed block size in bytes.
     size_t GetBlockSize() { return m_blockSize; }
 
-    /// Gets the maximum number of blocks created by the allocator.
+    /// Gets whether the pool is backed by, or advised to use, huge pages.
+    /// @return		TRUE if the pool uses huge pages.
+    BOOL GetHugePages() { return m_hugePages; }
+
+    /// Gets the block alignment requested at construction.
+    /// @return		The alignment in bytes or 0 for the default new alignment.
+    size_t GetAlignment() { return m_alignment; }
+
+    /// Gets whether any thread may allocate and deallocate blocks.
+    /// @return		TRUE if the allocator is thread safe.
+    BOOL GetThreadSafe() { return m_threadSafe; }
+
+    /// Gets the maximum number of blocks created by the allocator. The statistics 
+    /// getters may be called from any thread. A thread safe allocator counts the 
+    /// blocks deallocated by other threads once the blocks are reclaimed, and its 
+    /// high water mark is only updated by the owning thread.
     /// @return		The number of fixed memory blocks created.
-    UINT GetBlockCount() { return m_blockCnt; }
+    UINT GetBlockCount() { return m_blockCnt.load(std::memory_order_relaxed); }
 
     /// Gets the number of blocks in use.
     /// @return		The number of blocks in use by the application.
-    UINT GetBlocksInUse() { return m_blocksInUse; }
+    UINT GetBlocksInUse() { return m_blocksInUse.load(std::memory_order_relaxed) + 
+        m_sharedAllocations.load(std::memory_order_relaxed) - m_sharedDeallocations.load(std::memory_order_relaxed); }
+
+    /// Gets the most blocks in use at any one time.
+    /// @return		The high water mark of blocks in use.
+    UINT GetHighWater() { return m_highWater.load(std::memory_order_relaxed); }
 
     /// Gets the total number of allocations for this allocator instance.
     /// @return		The total number of allocations.
-    UINT GetAllocations() { return m_allocations; }
+    UINT GetAllocations() { return m_allocations.load(std::memory_order_relaxed) + m_sharedAllocations.load(std::memory_order_relaxed); }
 
     /// Gets the total number of deallocations for this allocator instance.
     /// @return		The total number of deallocations.
-    UINT GetDeallocations() { return m_deallocations; }
+    UINT GetDeallocations() { return m_deallocations.load(std::memory_order_relaxed) + m_sharedDeallocations.load(std::memory_order_relaxed); }
+
+    /// Gets the number of allocations that failed because the pool was exhausted.
+    /// @return		The total number of failed allocations.
+    UINT GetFailedAllocations() { return m_failedAllocations.load(std::memory_order_relaxed); }
+
+    /// Gets the memory obtained for blocks: the whole pool, or every heap block or 
+    /// slab created so far.
+    /// @return		The reserved memory size in bytes.
+    size_t GetBytesReserved() { return m_bytesReserved.load(std::memory_order_relaxed); }
 	
 private:
     /// Push a memory block onto head of free-list.
@@ -64,37 +198,154 @@ private:
     /// @return     Returns pointer to the block. Otherwise NULL if unsuccessful.
     void* Pop();
 
+    /// A free block. The link is atomic as a thread safe allocator may read it while 
+    /// another thread reuses the block; relaxed accesses are plain loads and stores.
     struct Block
     {
-        Block* pNext;
+        std::atomic<Block*> pNext;
+    };
+
+    /// Shared free-list head: a block pointer and an ABA tag packed into one word. On 
+    /// 64-bit targets the tag is kept in the upper 16 address bits that user space 
+    /// pointers do not use with 4-level paging; on 32-bit targets the tag is 32 bits 
+    /// wide. Every pointer entering the head is checked, so a block above 47 bits, 
+    /// e.g. mapped by a 5-level paging (LA57) process, fails instead of being corrupted.
+    typedef uint64_t TaggedPtr;
+    static const INT TAG_SHIFT = sizeof(void*) == 4 ? 32 : 48;
+    static const TaggedPtr PTR_MASK = ((TaggedPtr)1 << TAG_SHIFT) - 1;
+
+    static Block* GetPtr(TaggedPtr head) { return (Block*)(uintptr_t)(head & PTR_MASK); }
+    static TaggedPtr NextTag(TaggedPtr head, Block* pBlock) {
+        if ((TaggedPtr)(uintptr_t)pBlock & ~PTR_MASK)
+            TagBitsInUse(pBlock);
+        return (head & ~PTR_MASK) + ((TaggedPtr)1 << TAG_SHIFT) + (TaggedPtr)(uintptr_t)pBlock; }
+
+    /// Called when a block address uses the tag bits of the shared free-list head. 
+    /// Aborts, as the block cannot be kept on the list without corrupting it.
+    static void TagBitsInUse(void* pBlock);
+
+    /// Header at the start of every slab. Blocks follow at m_slabHeaderSize. 
+    struct SlabHeader
+    {
+        Allocator* pOwner;
+        SlabHeader* pNext;
     };
 
-	enum AllocatorMode { HEAP_BLOCKS, HEAP_POOL, STATIC_POOL };
+	enum AllocatorMode { HEAP_BLOCKS, HEAP_POOL, STATIC_POOL, HEAP_SLABS, HUGE_PAGE_POOL };
+
+    /// Get a new block from the pool, the heap or, in slab mode, the current slab.
+    /// @return     The block or NULL if the pool is exhausted.
+    void* CreateBlock();
+
+    /// Get a new block from the heap or, in slab mode, from the current slab.
+    void* NewBlock();
+
+    /// Returns TRUE if the calling thread owns the free-list of a thread safe 
+    /// allocator. The first thread to ask becomes the owner.
+    BOOL IsOwner();
+
+    /// Allocate a block of a thread safe allocator on a thread other than the owner.
+    void* AllocateShared();
+
+    /// Push a chain of blocks onto the shared free-list. Lock-free.
+    void PushShared(Block* pFirst, Block* pLast);
+
+    /// Pop a block from the shared free-list. Lock-free.
+    /// @return     Returns pointer to the block. Otherwise NULL if empty.
+    void* PopShared();
+
+    /// Get a new block from the current slab, starting a new slab if it is used up.
+    void* NewSlabBlock();
+
+    /// Touch memory so that its pages are faulted in, and optionally lock it in memory.
+    /// @return     FALSE if the pages could not be locked.
+    static BOOL PrefaultMemory(void* pMemory, size_t size, BOOL lockPages);
+
+    /// Lock memory so that its pages are never paged out.
+    /// @return     FALSE if the pages could not be locked.
+    static BOOL LockMemory(void* pMemory, size_t size);
+
+    /// Allocate heap memory with the allocator's alignment.
+    CHAR* NewMemory(size_t size);
+
+    /// Free memory obtained with NewMemory().
+    void DeleteMemory(CHAR* pMemory);
 
+    /// Move remotely freed blocks onto the free-list. 
+    /// @return     TRUE if any blocks were reclaimed.
+    BOOL ReclaimRemoteBlocks();
+
+    /// Add to a statistics counter. Counters are only written by the thread using 
+    /// the allocator, so a relaxed load and store costs no more than a plain add 
+    /// and lets other threads read the counters without a data race.
+    template <class T>
+    static void AddStat(std::atomic<T>& stat, T value) {
+        stat.store(stat.load(std::memory_order_relaxed) + value, std::memory_order_relaxed); }
+
+    /// Add to a counter that any thread of a thread safe allocator may write. Only 
+    /// used when creating blocks, so the atomic add stays off the fast path.
+    template <class T>
+    void AddSharedStat(std::atomic<T>& stat, T value) {
+        if (m_threadSafe)
+            stat.fetch_add(value, std::memory_order_relaxed);
+        else
+            AddStat(stat, value);
+    }
+
+    const size_t m_alignment;
     const size_t m_blockSize;
-    const size_t m_objectSize;
     const UINT m_maxObjects;
 	AllocatorMode m_allocatorMode;
     Block* m_pHead;
+    std::atomic<Block*> m_pRemoteHead;
     CHAR* m_pPool;
-    UINT m_poolIndex;
-    UINT m_blockCnt;
-    UINT m_blocksInUse;
-    UINT m_allocations;
-    UINT m_deallocations;
+    SlabHeader* m_pSlabs;
+    CHAR* m_pSlabNext;
+    CHAR* m_pSlabEnd;
+    size_t m_slabHeaderSize;
+    BOOL m_hugePages;
+    const BOOL m_threadSafe;
+    std::atomic<void*> m_pOwner;                // Thread owning m_pHead, if thread safe
+    std::atomic<TaggedPtr> m_sharedHead;        // Free-list of the other threads
+    std::atomic<UINT> m_poolIndex;
+    std::atomic<UINT> m_blockCnt;
+    std::atomic<UINT> m_blocksInUse;
+    std::atomic<UINT> m_highWater;
+    std::atomic<UINT> m_allocations;
+    std::atomic<UINT> m_deallocations;
+    std::atomic<UINT> m_failedAllocations;
+    std::atomic<size_t> m_bytesReserved;
+    std::atomic<UINT> m_sharedAllocations;      // Allocations by other threads
+    std::atomic<UINT> m_sharedDeallocations;    // Deallocations by other threads
     const CHAR* m_name;
 };
 
-// Template class to create external memory pool
-template <class T, UINT Objects>
+/// Combine Allocator constructor flags.
+inline Allocator::Flags operator|(Allocator::Flags a, Allocator::Flags b) {
+    return static_cast<Allocator::Flags>(static_cast<UINT>(a) | static_cast<UINT>(b)); }
+
+// Template class to create external memory pool. Blocks are sizeof(T) rounded up to 
+// a multiple of a pointer. If ThreadSafe, any thread may allocate and deallocate blocks.
+template <class T, UINT Objects, BOOL ThreadSafe = FALSE>
 class AllocatorPool : public Allocator
 {
 public:
-	AllocatorPool() : Allocator(sizeof(T), Objects, m_memory)
+	AllocatorPool() : Allocator(BLOCK_SIZE, Objects, m_memory, NULL, 0, ThreadSafe ? Allocator::THREAD_SAFE : Allocator::NO_FLAGS)
 	{
 	}
 private:
-	CHAR m_memory[sizeof(T) * Objects];
+	static const size_t BLOCK_SIZE = (sizeof(T) + alignof(void*) - 1) / alignof(void*) * alignof(void*);
+	alignas(void*) CHAR m_memory[BLOCK_SIZE * Objects];
+};
+
+// Template class to create a pool backed by huge pages where available
+template <class T, UINT Objects>
+class HugePageAllocatorPool : public Allocator
+{
+public:
+	HugePageAllocatorPool() : Allocator(sizeof(T), Objects, NULL, NULL, 0, Allocator::HUGE_PAGES)
+	{
+	}
 };
 
 // macro to provide header file interface
@@ -113,6 +364,11 @@ private:
 #define IMPLEMENT_ALLOCATOR(class, objects, memory) \
 	Allocator class::_allocator(sizeof(class), objects, memory, #class);
 
+// macro to provide source file interface for objects created and deleted on 
+// different threads
+#define IMPLEMENT_THREAD_SAFE_ALLOCATOR(class, objects, memory) \
+	Allocator class::_allocator(sizeof(class), objects, memory, #class, 0, Allocator::THREAD_SAFE);
+
 #endif
 
 
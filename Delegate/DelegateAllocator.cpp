@@ -0,0 +1,146 @@
+#include "DelegateAllocator.h"
+#include "Allocator.h"
+#include "Fault.h"
+#include <algorithm>
+
+using namespace std;
+
+namespace DelegateLib
+{
+
+//------------------------------------------------------------------------------
+// Constructor
+//------------------------------------------------------------------------------
+DelegatePoolAllocator::DelegatePoolAllocator(const CHAR* name) :
+	m_heapAllocations(0),
+	m_wastedBytes(0),
+	m_name(name)
+{
+	size_t blockSizes[8];
+	UINT count = 0;
+	for (size_t size = 16; size <= MAX_BLOCK_SIZE; size <<= 1)
+		blockSizes[count++] = size;
+	CreatePools(blockSizes, count, 0);
+}
+
+//------------------------------------------------------------------------------
+// Constructor
+//------------------------------------------------------------------------------
+DelegatePoolAllocator::DelegatePoolAllocator(const size_t* blockSizes, UINT count, UINT reserve, const CHAR* name) :
+	m_heapAllocations(0),
+	m_wastedBytes(0),
+	m_name(name)
+{
+	CreatePools(blockSizes, count, reserve);
+}
+
+//------------------------------------------------------------------------------
+// Destructor
+//------------------------------------------------------------------------------
+DelegatePoolAllocator::~DelegatePoolAllocator()
+{
+	for (Allocator* pool : m_pools)
+		delete pool;
+}
+
+//------------------------------------------------------------------------------
+// CreatePools
+//------------------------------------------------------------------------------
+void DelegatePoolAllocator::CreatePools(const size_t* blockSizes, UINT count, UINT reserve)
+{
+	ASSERT_TRUE(count > 0);
+	for (UINT i = 0; i < count; i++)
+	{
+		ASSERT_TRUE(i == 0 || blockSizes[i] > blockSizes[i - 1]);
+		m_blockSizes.push_back(blockSizes[i]);
+		m_pools.push_back(new Allocator(blockSizes[i], 0, NULL, m_name, 0, Allocator::THREAD_SAFE));
+
+		// Create the reserved blocks on the free-list shared by every thread
+		m_pools[i]->Reserve(reserve);
+	}
+}
+
+//------------------------------------------------------------------------------
+// GetPoolIndex
+//------------------------------------------------------------------------------
+INT DelegatePoolAllocator::GetPoolIndex(size_t size) const
+{
+	auto it = std::lower_bound(m_blockSizes.begin(), m_blockSizes.end(), size);
+	if (it == m_blockSizes.end())
+		return -1;
+	return (INT)(it - m_blockSizes.begin());
+}
+
+//------------------------------------------------------------------------------
+// Allocate
+//------------------------------------------------------------------------------
+void* DelegatePoolAllocator::Allocate(size_t size, size_t alignment)
+{
+	// Pool blocks and operator new are both aligned for any fundamental type. Over 
+	// allocate heap memory for an over-aligned type, align, and keep the original 
+	// pointer just below the aligned memory for Deallocate().
+	if (alignment > alignof(max_align_t))
+	{
+		m_heapAllocations.fetch_add(1, memory_order_relaxed);
+		CHAR* pRaw = static_cast<CHAR*>(::operator new(size + alignment + sizeof(CHAR*)));
+		CHAR* pAligned = (CHAR*)(((size_t)pRaw + sizeof(CHAR*) + alignment - 1) & ~(alignment - 1));
+		((CHAR**)pAligned)[-1] = pRaw;
+		return pAligned;
+	}
+
+	INT index = GetPoolIndex(size);
+	if (index < 0)
+	{
+		m_heapAllocations.fetch_add(1, memory_order_relaxed);
+		return ::operator new(size);
+	}
+
+	void* block = m_pools[index]->Allocate(size);
+	if (!block)
+		throw bad_alloc();
+	if (m_blockSizes[index] != size)
+		m_wastedBytes.fetch_add(m_blockSizes[index] - size, memory_order_relaxed);
+	return block;
+}
+
+//------------------------------------------------------------------------------
+// Deallocate
+//------------------------------------------------------------------------------
+void DelegatePoolAllocator::Deallocate(void* block, size_t size, size_t alignment)
+{
+	if (alignment > alignof(max_align_t))
+	{
+		::operator delete(((CHAR**)block)[-1]);
+		return;
+	}
+
+	INT index = GetPoolIndex(size);
+	if (index < 0)
+		::operator delete(block);
+	else
+		m_pools[index]->Deallocate(block);
+}
+
+//------------------------------------------------------------------------------
+// GetBlocksInUse
+//------------------------------------------------------------------------------
+UINT DelegatePoolAllocator::GetBlocksInUse() const
+{
+	UINT inUse = 0;
+	for (Allocator* pool : m_pools)
+		inUse += pool->GetBlocksInUse();
+	return inUse;
+}
+
+//------------------------------------------------------------------------------
+// GetAllocations
+//------------------------------------------------------------------------------
+UINT DelegatePoolAllocator::GetAllocations() const
+{
+	UINT allocations = 0;
+	for (Allocator* pool : m_pools)
+		allocations += pool->GetAllocations();
+	return allocations;
+}
+
+}
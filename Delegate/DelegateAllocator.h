@@ -0,0 +1,141 @@
+#ifndef _DELEGATE_ALLOCATOR_H
+#define _DELEGATE_ALLOCATOR_H
+
+// DelegateAllocator.h
+// @see https://github.com/endurodave/AsyncMulticastDelegateCpp11
+
+#include "DataTypes.h"
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <vector>
+
+class Allocator;
+
+namespace DelegateLib {
+
+/// @brief A runtime memory source for asynchronous delegates, in the spirit of
+/// std::pmr::memory_resource. Pass an instance to MakeDelegate() or set one on a
+/// WorkerThread, and the messages, delegate clones and argument copies created
+/// for that path are allocated from it instead of the global heap or xallocator.
+///
+/// Memory is allocated on the thread invoking the delegate and deallocated on the
+/// target thread, so implementations must be thread safe. The allocator must
+/// outlive every delegate and message that uses it.
+class IDelegateAllocator
+{
+public:
+	/// Destructor
+	virtual ~IDelegateAllocator() = default;
+
+	/// Allocate memory. Never returns NULL.
+	/// @param[in] size - size of the memory in bytes.
+	/// @param[in] alignment - required alignment, a power of two.
+	/// @return Pointer to the memory.
+	virtual void* Allocate(size_t size, size_t alignment) = 0;
+
+	/// Deallocate memory obtained from Allocate().
+	/// @param[in] block - the memory.
+	/// @param[in] size - the size passed to Allocate().
+	/// @param[in] alignment - the alignment passed to Allocate().
+	virtual void Deallocate(void* block, size_t size, size_t alignment) = 0;
+};
+
+/// @brief A thread safe pool allocator for one subsystem. Requests are rounded up
+/// to the next pool block size, each pool a thread safe Allocator that grows on 
+/// demand and keeps freed blocks for reuse. Requests larger than the largest block, or 
+/// for types aligned beyond std::max_align_t, use operator new. The default pools 
+/// are powers of two from 16 to MAX_BLOCK_SIZE bytes; DelegatePoolSizes computes 
+/// exact block sizes for a set of delegates.
+class DelegatePoolAllocator : public IDelegateAllocator
+{
+public:
+	static const size_t MAX_BLOCK_SIZE = 2048;
+
+	/// Constructor for power of two pools.
+	/// @param[in] name - optional allocator name string.
+	DelegatePoolAllocator(const CHAR* name = NULL);
+
+	/// Constructor for pools of the given block sizes.
+	/// @param[in] blockSizes - the block sizes in increasing order.
+	/// @param[in] count - the number of block sizes.
+	/// @param[in] reserve - number of blocks to create up front in each pool.
+	/// @param[in] name - optional allocator name string.
+	DelegatePoolAllocator(const size_t* blockSizes, UINT count, UINT reserve = 0, const CHAR* name = NULL);
+
+	/// Destructor. Returns every pooled block to the heap.
+	~DelegatePoolAllocator();
+
+	virtual void* Allocate(size_t size, size_t alignment) override;
+	virtual void Deallocate(void* block, size_t size, size_t alignment) override;
+
+	/// Get the allocator name string.
+	/// @return A pointer to the allocator name or NULL if none was assigned.
+	const CHAR* GetName() const { return m_name; }
+
+	/// Gets the number of pooled blocks in use. Exact only when no other thread
+	/// is allocating or deallocating.
+	/// @return The number of blocks in use.
+	UINT GetBlocksInUse() const;
+
+	/// Gets the total number of pooled allocations.
+	/// @return The total number of allocations.
+	UINT GetAllocations() const;
+
+	/// Gets the number of requests too large for any pool or aligned beyond 
+	/// std::max_align_t.
+	/// @return The number of operator new allocations.
+	UINT GetHeapAllocations() const { return m_heapAllocations.load(std::memory_order_relaxed); }
+
+	/// Gets the total bytes lost rounding requests up to a pool block size.
+	/// @return The wasted bytes over all pooled allocations.
+	size_t GetWastedBytes() const { return m_wastedBytes.load(std::memory_order_relaxed); }
+
+private:
+	DelegatePoolAllocator(const DelegatePoolAllocator&) = delete;
+	DelegatePoolAllocator& operator=(const DelegatePoolAllocator&) = delete;
+
+	void CreatePools(const size_t* blockSizes, UINT count, UINT reserve);
+
+	/// Get the pool index for a request size, or -1 if too large.
+	INT GetPoolIndex(size_t size) const;
+
+	std::vector<size_t> m_blockSizes;
+	std::vector<Allocator*> m_pools;
+	std::atomic<UINT> m_heapAllocations;
+	std::atomic<size_t> m_wastedBytes;
+	const CHAR* m_name;
+};
+
+/// @brief A standard library allocator over an IDelegateAllocator. Used with
+/// std::allocate_shared so a message or clone and its shared_ptr control block
+/// share one allocation.
+template <class T>
+class DelegateAllocatorAdapter
+{
+public:
+	typedef T value_type;
+
+	DelegateAllocatorAdapter(IDelegateAllocator* allocator) : m_allocator(allocator) { }
+
+	template <class U>
+	DelegateAllocatorAdapter(const DelegateAllocatorAdapter<U>& other) : m_allocator(other.GetAllocator()) { }
+
+	T* allocate(size_t n) { return static_cast<T*>(m_allocator->Allocate(n * sizeof(T), alignof(T))); }
+	void deallocate(T* p, size_t n) { m_allocator->Deallocate(p, n * sizeof(T), alignof(T)); }
+
+	IDelegateAllocator* GetAllocator() const { return m_allocator; }
+
+private:
+	IDelegateAllocator* m_allocator;
+};
+
+template <class T, class U>
+bool operator==(const DelegateAllocatorAdapter<T>& a, const DelegateAllocatorAdapter<U>& b) { return a.GetAllocator() == b.GetAllocator(); }
+
+template <class T, class U>
+bool operator!=(const DelegateAllocatorAdapter<T>& a, const DelegateAllocatorAdapter<U>& b) { return a.GetAllocator() != b.GetAllocator(); }
+
+}
+
+#endif
@@ -44,19 +44,22 @@ template <typename Param>
 class DelegateParam
 {
 public:
-	static Param New(Param param) {	return param; }
-	static void Delete(Param param) { }
+	static Param New(Param param, IDelegateAllocator* = nullptr) { return param; }
+	static void Delete(Param param, IDelegateAllocator* = nullptr) { }
 };
 
-/// @brief Implement new/delete for pointer parameter values. If USE_ALLOCATOR is
-/// defined, get memory from the fixed block allocator and not global heap.
+/// @brief Implement new/delete for pointer parameter values. If an allocator is
+/// given get memory from it. Otherwise if USE_ALLOCATOR is defined, get memory 
+/// from the fixed block allocator and not global heap.
 template <typename Param>
 class DelegateParam<Param *>
 {
 public:
-	static Param* New(Param* param)	{
+	static Param* New(Param* param, IDelegateAllocator* allocator = nullptr) {
+		if (allocator)
+			return new (allocator->Allocate(sizeof(Param), alignof(Param))) Param(*param);
 #ifdef USE_XALLOCATOR
-		void* mem = xmalloc(sizeof(*param));
+		void* mem = xmalloc_aligned(sizeof(*param), alignof(Param));
 		Param* newParam = new (mem) Param(*param);
 #else
 		Param* newParam = new Param(*param);
@@ -64,7 +67,12 @@ public:
 		return newParam;
 	}
 
-	static void Delete(Param* param) {
+	static void Delete(Param* param, IDelegateAllocator* allocator = nullptr) {
+		if (allocator) {
+			param->~Param();
+			allocator->Deallocate((void*)param, sizeof(Param), alignof(Param));
+			return;
+		}
 #ifdef USE_XALLOCATOR
 		param->~Param();
 		xfree((void*)param);
@@ -79,12 +87,17 @@ template <typename Param>
 class DelegateParam<Param **>
 {
 public:
-	static Param** New(Param** param) {
+	static Param** New(Param** param, IDelegateAllocator* allocator = nullptr) {
+		if (allocator) {
+			Param** newParam = new (allocator->Allocate(sizeof(Param*), alignof(Param*))) Param*();
+			*newParam = new (allocator->Allocate(sizeof(Param), alignof(Param))) Param(**param);
+			return newParam;
+		}
 #ifdef USE_XALLOCATOR
 		void* mem = xmalloc(sizeof(*param));
 		Param** newParam = new (mem) Param*();
 
-		void* mem2 = xmalloc(sizeof(**param));
+		void* mem2 = xmalloc_aligned(sizeof(**param), alignof(Param));
 		*newParam = new (mem2) Param(**param);
 #else
 		Param** newParam = new Param*();
@@ -93,7 +106,13 @@ public:
 		return newParam;
 	}
 
-	static void Delete(Param** param) {
+	static void Delete(Param** param, IDelegateAllocator* allocator = nullptr) {
+		if (allocator) {
+			(*param)->~Param();
+			allocator->Deallocate((void*)(*param), sizeof(Param), alignof(Param));
+			allocator->Deallocate((void*)param, sizeof(Param*), alignof(Param*));
+			return;
+		}
 #ifdef USE_XALLOCATOR
 		(*param)->~Param();
 		xfree((void*)(*param));
@@ -111,9 +130,11 @@ template <typename Param>
 class DelegateParam<Param &>
 {
 public:
-	static Param& New(Param& param)	{
+	static Param& New(Param& param, IDelegateAllocator* allocator = nullptr) {
+		if (allocator)
+			return *new (allocator->Allocate(sizeof(Param), alignof(Param))) Param(param);
 #ifdef USE_XALLOCATOR
-		void* mem = xmalloc(sizeof(param));
+		void* mem = xmalloc_aligned(sizeof(param), alignof(Param));
 		Param* newParam = new (mem) Param(param);
 #else
 		Param* newParam = new Param(param);
@@ -121,7 +142,12 @@ public:
 		return *newParam;
 	}
 
-	static void Delete(Param& param) {
+	static void Delete(Param& param, IDelegateAllocator* allocator = nullptr) {
+		if (allocator) {
+			(&param)->~Param();
+			allocator->Deallocate((void*)(&param), sizeof(Param), alignof(Param));
+			return;
+		}
 #ifdef USE_XALLOCATOR
 		(&param)->~Param();
 		xfree((void*)(&param));
@@ -131,6 +157,36 @@ public:
 	}
 };
 
+// Call DelegateParam<Param>::New/Delete with the allocator when the DelegateParam
+// specialization accepts one. User specializations taking only the parameter 
+// manage their own memory.
+template <typename Param>
+auto NewDelegateParam(Param param, IDelegateAllocator* allocator, int) -> decltype(DelegateParam<Param>::New(param, allocator)) {
+	return DelegateParam<Param>::New(param, allocator); }
+
+template <typename Param>
+Param NewDelegateParam(Param param, IDelegateAllocator*, long) { 
+	return DelegateParam<Param>::New(param); }
+
+template <typename Param>
+auto DeleteDelegateParam(Param param, IDelegateAllocator* allocator, int) -> decltype(DelegateParam<Param>::Delete(param, allocator)) {
+	DelegateParam<Param>::Delete(param, allocator); }
+
+template <typename Param>
+void DeleteDelegateParam(Param param, IDelegateAllocator*, long) { 
+	DelegateParam<Param>::Delete(param); }
+
+/// Create the delegate clone sent with an asynchronous message. 
+/// @param[in] delegate - the delegate to copy.
+/// @param[in] allocator - the allocator for the clone, or nullptr to use Clone().
+/// @return The clone.
+template <class TDelegate>
+std::shared_ptr<TDelegate> MakeDelegateClone(const TDelegate& delegate, IDelegateAllocator* allocator) {
+	if (allocator)
+		return std::allocate_shared<TDelegate>(DelegateAllocatorAdapter<TDelegate>(allocator), delegate);
+	return std::shared_ptr<TDelegate>(delegate.Clone());
+}
+
 // Declare DelegateMemberAsync as a class template. It will be specialized for all number of arguments.
 template <typename Signature>
 class DelegateMemberAsync;
@@ -146,8 +202,8 @@ public:
     using BaseType = DelegateMember<void(TClass(void))>;
 
 	// Contructors take a class instance, member function, and delegate thread
-	DelegateMemberAsync(ObjectPtr object, MemberFunc func, DelegateThread& thread) : BaseType(object, func), m_thread(thread) { Bind(object, func, thread); }
-	DelegateMemberAsync(ObjectPtr object, ConstMemberFunc func, DelegateThread& thread) : BaseType(object, func), m_thread(thread) { Bind(object, func, thread); }
+	DelegateMemberAsync(ObjectPtr object, MemberFunc func, DelegateThread& thread, IDelegateAllocator* allocator = nullptr) : BaseType(object, func), m_thread(thread), m_allocator(allocator) { Bind(object, func, thread); }
+	DelegateMemberAsync(ObjectPtr object, ConstMemberFunc func, DelegateThread& thread, IDelegateAllocator* allocator = nullptr) : BaseType(object, func), m_thread(thread), m_allocator(allocator) { Bind(object, func, thread); }
 	DelegateMemberAsync() = delete;
 
 	/// Bind a member function to a delegate. 
@@ -160,6 +216,9 @@ public:
 		m_thread = thread;
 		BaseType::Bind(object, func); }
 
+	/// Get the allocator for messages, clones and argument copies, or nullptr for the default.
+	IDelegateAllocator* GetAllocator() const { return m_allocator ? m_allocator : m_thread.GetAllocator(); }
+
 	virtual ClassType* Clone() const override {	return new ClassType(*this); }
 
 	virtual bool operator==(const DelegateBase& rhs) const override {
@@ -171,10 +230,10 @@ public:
 	/// Invoke delegate function asynchronously
 	virtual void operator()() override {
 		// Create a clone instance of this delegate 
-		auto delegate = std::shared_ptr<ClassType>(Clone());
+		auto delegate = MakeDelegateClone(*this, GetAllocator());
 
 		// Create a new message instance 
-		auto msg = std::make_shared<DelegateMsgBase>(delegate);
+		auto msg = MakeDelegateMsg<DelegateMsgBase>(GetAllocator(), m_thread, delegate);
 
 		// Dispatch message onto the callback destination thread. DelegateInvoke()
 		// will be called by the target thread. 
@@ -190,6 +249,9 @@ public:
 private:
 	/// Target thread to invoke the delegate function
 	DelegateThread& m_thread;
+
+	/// Allocator for messages, clones and argument copies, or nullptr for the thread default
+	IDelegateAllocator* m_allocator;
 };
 
 template <class TClass, class Param1> 
@@ -202,8 +264,8 @@ public:
     using BaseType = DelegateMember<void(TClass(Param1))>;
 
 	// Contructors take a class instance, member function, and callback thread
-	DelegateMemberAsync(ObjectPtr object, MemberFunc func, DelegateThread& thread) : BaseType(object, func), m_thread(thread) { Bind(object, func, thread); }
-	DelegateMemberAsync(ObjectPtr object, ConstMemberFunc func, DelegateThread& thread) : BaseType(object, func), m_thread(thread) { Bind(object, func, thread); }
+	DelegateMemberAsync(ObjectPtr object, MemberFunc func, DelegateThread& thread, IDelegateAllocator* allocator = nullptr) : BaseType(object, func), m_thread(thread), m_allocator(allocator) { Bind(object, func, thread); }
+	DelegateMemberAsync(ObjectPtr object, ConstMemberFunc func, DelegateThread& thread, IDelegateAllocator* allocator = nullptr) : BaseType(object, func), m_thread(thread), m_allocator(allocator) { Bind(object, func, thread); }
 	DelegateMemberAsync() = delete;
 
 	/// Bind a member function to a delegate. 
@@ -216,6 +278,9 @@ public:
 		m_thread = thread;
 		BaseType::Bind(object, func); }
 
+	/// Get the allocator for messages, clones and argument copies, or nullptr for the default.
+	IDelegateAllocator* GetAllocator() const { return m_allocator ? m_allocator : m_thread.GetAllocator(); }
+
 	virtual ClassType* Clone() const override {	return new ClassType(*this); }
 
 	virtual bool operator==(const DelegateBase& rhs) const override {
@@ -227,13 +292,13 @@ public:
 	/// Invoke delegate function asynchronously
 	virtual void operator()(Param1 p1) override {
 		// Create a new instance of the function argument data and copy
-		Param1 heapParam1 = DelegateParam<Param1>::New(p1);
+		Param1 heapParam1 = NewDelegateParam<Param1>(p1, GetAllocator(), 0);
 
 		// Create a clone instance of this delegate 
-		auto delegate = std::shared_ptr<ClassType>(Clone());
+		auto delegate = MakeDelegateClone(*this, GetAllocator());
 
 		// Create a new message instance 
-		auto msg = std::make_shared<DelegateMsg1<Param1>>(delegate, heapParam1);
+		auto msg = MakeDelegateMsg<DelegateMsg1<Param1>>(GetAllocator(), m_thread, delegate, heapParam1);
 
 		// Dispatch message onto the callback destination thread. DelegateInvoke()
 		// will be called by the target thread. 
@@ -257,12 +322,15 @@ public:
 		BaseType::operator()(param1);
 
 		// Delete heap data created inside operator()
-		DelegateParam<Param1>::Delete(param1);
+		DeleteDelegateParam<Param1>(param1, GetAllocator(), 0);
 	}
 
 private:
 	/// Target thread to invoke the delegate function
 	DelegateThread& m_thread;
+
+	/// Allocator for messages, clones and argument copies, or nullptr for the thread default
+	IDelegateAllocator* m_allocator;
 };
 
 template <class TClass, class Param1, class Param2> 
@@ -275,8 +343,8 @@ public:
     using BaseType = DelegateMember<void(TClass(Param1, Param2))>;
 
 	// Contructors take a class instance, member function, and callback thread
-	DelegateMemberAsync(ObjectPtr object, MemberFunc func, DelegateThread& thread) : BaseType(object, func), m_thread(thread) { Bind(object, func, thread); }
-	DelegateMemberAsync(ObjectPtr object, ConstMemberFunc func, DelegateThread& thread) : BaseType(object, func), m_thread(thread) { Bind(object, func, thread); }
+	DelegateMemberAsync(ObjectPtr object, MemberFunc func, DelegateThread& thread, IDelegateAllocator* allocator = nullptr) : BaseType(object, func), m_thread(thread), m_allocator(allocator) { Bind(object, func, thread); }
+	DelegateMemberAsync(ObjectPtr object, ConstMemberFunc func, DelegateThread& thread, IDelegateAllocator* allocator = nullptr) : BaseType(object, func), m_thread(thread), m_allocator(allocator) { Bind(object, func, thread); }
 	DelegateMemberAsync() = delete;
 
 	/// Bind a member function to a delegate. 
@@ -289,6 +357,9 @@ public:
 		m_thread = thread;
 		BaseType::Bind(object, func); }
 
+	/// Get the allocator for messages, clones and argument copies, or nullptr for the default.
+	IDelegateAllocator* GetAllocator() const { return m_allocator ? m_allocator : m_thread.GetAllocator(); }
+
 	virtual ClassType* Clone() const override {	return new ClassType(*this); }
 
 	virtual bool operator==(const DelegateBase& rhs) const override {
@@ -300,14 +371,14 @@ public:
 	/// Invoke delegate function asynchronously
 	virtual void operator()(Param1 p1, Param2 p2) override {
 		// Create a new instance of the function argument data and copy
-		Param1 heapParam1 = DelegateParam<Param1>::New(p1);
-		Param2 heapParam2 = DelegateParam<Param2>::New(p2);
+		Param1 heapParam1 = NewDelegateParam<Param1>(p1, GetAllocator(), 0);
+		Param2 heapParam2 = NewDelegateParam<Param2>(p2, GetAllocator(), 0);
 
 		// Create a clone instance of this delegate 
-		auto delegate = std::shared_ptr<ClassType>(Clone());
+		auto delegate = MakeDelegateClone(*this, GetAllocator());
 
 		// Create a new message instance 
-		auto msg = std::make_shared<DelegateMsg2<Param1, Param2>>(delegate, heapParam1, heapParam2);
+		auto msg = MakeDelegateMsg<DelegateMsg2<Param1, Param2>>(GetAllocator(), m_thread, delegate, heapParam1, heapParam2);
 
 		// Dispatch message onto the callback destination thread. DelegateInvoke()
 		// will be called by the target thread. 
@@ -333,13 +404,16 @@ public:
 		BaseType::operator()(param1, param2);
 
 		// Delete heap data created inside operator()
-		DelegateParam<Param1>::Delete(param1);
-		DelegateParam<Param2>::Delete(param2);
+		DeleteDelegateParam<Param1>(param1, GetAllocator(), 0);
+		DeleteDelegateParam<Param2>(param2, GetAllocator(), 0);
 	}
 
 private:
 	/// Target thread to invoke the delegate function
 	DelegateThread& m_thread;
+
+	/// Allocator for messages, clones and argument copies, or nullptr for the thread default
+	IDelegateAllocator* m_allocator;
 };
 
 template <class TClass, class Param1, class Param2, class Param3> 
@@ -352,8 +426,8 @@ public:
     using BaseType = DelegateMember<void(TClass(Param1, Param2, Param3))>;
 
 	// Contructors take a class instance, member function, and callback thread
-	DelegateMemberAsync(ObjectPtr object, MemberFunc func, DelegateThread& thread) : BaseType(object, func), m_thread(thread) { Bind(object, func, thread); }
-	DelegateMemberAsync(ObjectPtr object, ConstMemberFunc func, DelegateThread& thread) : BaseType(object, func), m_thread(thread) { Bind(object, func, thread); }
+	DelegateMemberAsync(ObjectPtr object, MemberFunc func, DelegateThread& thread, IDelegateAllocator* allocator = nullptr) : BaseType(object, func), m_thread(thread), m_allocator(allocator) { Bind(object, func, thread); }
+	DelegateMemberAsync(ObjectPtr object, ConstMemberFunc func, DelegateThread& thread, IDelegateAllocator* allocator = nullptr) : BaseType(object, func), m_thread(thread), m_allocator(allocator) { Bind(object, func, thread); }
 	DelegateMemberAsync() = delete;
 
 	/// Bind a member function to a delegate. 
@@ -366,6 +440,9 @@ public:
 		m_thread = thread;
 		BaseType::Bind(object, func); }
 
+	/// Get the allocator for messages, clones and argument copies, or nullptr for the default.
+	IDelegateAllocator* GetAllocator() const { return m_allocator ? m_allocator : m_thread.GetAllocator(); }
+
 	virtual ClassType* Clone() const override {	return new ClassType(*this); }
 
 	virtual bool operator==(const DelegateBase& rhs) const override {
@@ -377,15 +454,15 @@ public:
 	/// Invoke delegate function asynchronously
 	virtual void operator()(Param1 p1, Param2 p2, Param3 p3) override {
 		// Create a new instance of the function argument data and copy
-		Param1 heapParam1 = DelegateParam<Param1>::New(p1);
-		Param2 heapParam2 = DelegateParam<Param2>::New(p2);
-		Param3 heapParam3 = DelegateParam<Param3>::New(p3);
+		Param1 heapParam1 = NewDelegateParam<Param1>(p1, GetAllocator(), 0);
+		Param2 heapParam2 = NewDelegateParam<Param2>(p2, GetAllocator(), 0);
+		Param3 heapParam3 = NewDelegateParam<Param3>(p3, GetAllocator(), 0);
 
 		// Create a clone instance of this delegate 
-		auto delegate = std::shared_ptr<ClassType>(Clone());
+		auto delegate = MakeDelegateClone(*this, GetAllocator());
 
 		// Create a new message instance 
-		auto msg = std::make_shared<DelegateMsg3<Param1, Param2, Param3>>(delegate, heapParam1, heapParam2, heapParam3);
+		auto msg = MakeDelegateMsg<DelegateMsg3<Param1, Param2, Param3>>(GetAllocator(), m_thread, delegate, heapParam1, heapParam2, heapParam3);
 
 		// Dispatch message onto the callback destination thread. DelegateInvoke()
 		// will be called by the target thread. 
@@ -413,14 +490,17 @@ public:
 		BaseType::operator()(param1, param2, param3);
 
 		// Delete heap data created inside operator()
-		DelegateParam<Param1>::Delete(param1);
-		DelegateParam<Param2>::Delete(param2);
-		DelegateParam<Param3>::Delete(param3);
+		DeleteDelegateParam<Param1>(param1, GetAllocator(), 0);
+		DeleteDelegateParam<Param2>(param2, GetAllocator(), 0);
+		DeleteDelegateParam<Param3>(param3, GetAllocator(), 0);
 	}
 
 private:
 	/// Target thread to invoke the delegate function
 	DelegateThread& m_thread;
+
+	/// Allocator for messages, clones and argument copies, or nullptr for the thread default
+	IDelegateAllocator* m_allocator;
 };
 
 template <class TClass, class Param1, class Param2, class Param3, class Param4> 
@@ -433,8 +513,8 @@ public:
     using BaseType = DelegateMember<void(TClass(Param1, Param2, Param3, Param4))>;
 
 	// Contructors take a class instance, member function, and callback thread
-	DelegateMemberAsync(ObjectPtr object, MemberFunc func, DelegateThread& thread) : BaseType(object, func), m_thread(thread) { Bind(object, func, thread); }
-	DelegateMemberAsync(ObjectPtr object, ConstMemberFunc func, DelegateThread& thread) : BaseType(object, func), m_thread(thread) { Bind(object, func, thread); }
+	DelegateMemberAsync(ObjectPtr object, MemberFunc func, DelegateThread& thread, IDelegateAllocator* allocator = nullptr) : BaseType(object, func), m_thread(thread), m_allocator(allocator) { Bind(object, func, thread); }
+	DelegateMemberAsync(ObjectPtr object, ConstMemberFunc func, DelegateThread& thread, IDelegateAllocator* allocator = nullptr) : BaseType(object, func), m_thread(thread), m_allocator(allocator) { Bind(object, func, thread); }
 	DelegateMemberAsync() = delete;
 
 	/// Bind a member function to a delegate. 
@@ -447,6 +527,9 @@ public:
 		m_thread = thread;
 		BaseType::Bind(object, func); }
 
+	/// Get the allocator for messages, clones and argument copies, or nullptr for the default.
+	IDelegateAllocator* GetAllocator() const { return m_allocator ? m_allocator : m_thread.GetAllocator(); }
+
 	virtual ClassType* Clone() const override {	return new ClassType(*this); }
 
 	virtual bool operator==(const DelegateBase& rhs) const override {
@@ -458,16 +541,16 @@ public:
 	/// Invoke delegate function asynchronously
 	virtual void operator()(Param1 p1, Param2 p2, Param3 p3, Param4 p4) override {
 		// Create a new instance of the function argument data and copy
-		Param1 heapParam1 = DelegateParam<Param1>::New(p1);
-		Param2 heapParam2 = DelegateParam<Param2>::New(p2);
-		Param3 heapParam3 = DelegateParam<Param3>::New(p3);
-		Param4 heapParam4 = DelegateParam<Param4>::New(p4);
+		Param1 heapParam1 = NewDelegateParam<Param1>(p1, GetAllocator(), 0);
+		Param2 heapParam2 = NewDelegateParam<Param2>(p2, GetAllocator(), 0);
+		Param3 heapParam3 = NewDelegateParam<Param3>(p3, GetAllocator(), 0);
+		Param4 heapParam4 = NewDelegateParam<Param4>(p4, GetAllocator(), 0);
 
 		// Create a clone instance of this delegate 
-		auto delegate = std::shared_ptr<ClassType>(Clone());
+		auto delegate = MakeDelegateClone(*this, GetAllocator());
 
 		// Create a new message instance 
-		auto msg = std::make_shared<DelegateMsg4<Param1, Param2, Param3, Param4>>(delegate, heapParam1, heapParam2, heapParam3, heapParam4);
+		auto msg = MakeDelegateMsg<DelegateMsg4<Param1, Param2, Param3, Param4>>(GetAllocator(), m_thread, delegate, heapParam1, heapParam2, heapParam3, heapParam4);
 
 		// Dispatch message onto the callback destination thread. DelegateInvoke()
 		// will be called by the target thread. 
@@ -497,15 +580,18 @@ public:
 		BaseType::operator()(param1, param2, param3, param4);
 
 		// Delete heap data created inside operator()
-		DelegateParam<Param1>::Delete(param1);
-		DelegateParam<Param2>::Delete(param2);
-		DelegateParam<Param3>::Delete(param3);
-		DelegateParam<Param4>::Delete(param4);
+		DeleteDelegateParam<Param1>(param1, GetAllocator(), 0);
+		DeleteDelegateParam<Param2>(param2, GetAllocator(), 0);
+		DeleteDelegateParam<Param3>(param3, GetAllocator(), 0);
+		DeleteDelegateParam<Param4>(param4, GetAllocator(), 0);
 	}
 
 private:
 	/// Target thread to invoke the delegate function
 	DelegateThread& m_thread;
+
+	/// Allocator for messages, clones and argument copies, or nullptr for the thread default
+	IDelegateAllocator* m_allocator;
 };
 
 template <class TClass, class Param1, class Param2, class Param3, class Param4, class Param5> 
@@ -518,8 +604,8 @@ public:
     using BaseType = DelegateMember<void(TClass(Param1, Param2, Param3, Param4, Param5))>;
 
 	// Contructors take a class instance, member function, and callback thread
-	DelegateMemberAsync(ObjectPtr object, MemberFunc func, DelegateThread& thread) : BaseType(object, func), m_thread(thread) { Bind(object, func, thread); }
-	DelegateMemberAsync(ObjectPtr object, ConstMemberFunc func, DelegateThread& thread) : BaseType(object, func), m_thread(thread) { Bind(object, func, thread); }
+	DelegateMemberAsync(ObjectPtr object, MemberFunc func, DelegateThread& thread, IDelegateAllocator* allocator = nullptr) : BaseType(object, func), m_thread(thread), m_allocator(allocator) { Bind(object, func, thread); }
+	DelegateMemberAsync(ObjectPtr object, ConstMemberFunc func, DelegateThread& thread, IDelegateAllocator* allocator = nullptr) : BaseType(object, func), m_thread(thread), m_allocator(allocator) { Bind(object, func, thread); }
 	DelegateMemberAsync() = delete;
 
 	/// Bind a member function to a delegate. 
@@ -532,6 +618,9 @@ public:
 		m_thread = thread;
 		BaseType::Bind(object, func); }
 
+	/// Get the allocator for messages, clones and argument copies, or nullptr for the default.
+	IDelegateAllocator* GetAllocator() const { return m_allocator ? m_allocator : m_thread.GetAllocator(); }
+
 	virtual ClassType* Clone() const override {	return new ClassType(*this); }
 
 	virtual bool operator==(const DelegateBase& rhs) const override {
@@ -543,17 +632,17 @@ public:
 	/// Invoke delegate function asynchronously
 	virtual void operator()(Param1 p1, Param2 p2, Param3 p3, Param4 p4, Param5 p5) override {
 		// Create a new instance of the function argument data and copy
-		Param1 heapParam1 = DelegateParam<Param1>::New(p1);
-		Param2 heapParam2 = DelegateParam<Param2>::New(p2);
-		Param3 heapParam3 = DelegateParam<Param3>::New(p3);
-		Param4 heapParam4 = DelegateParam<Param4>::New(p4);
-		Param5 heapParam5 = DelegateParam<Param5>::New(p5);
+		Param1 heapParam1 = NewDelegateParam<Param1>(p1, GetAllocator(), 0);
+		Param2 heapParam2 = NewDelegateParam<Param2>(p2, GetAllocator(), 0);
+		Param3 heapParam3 = NewDelegateParam<Param3>(p3, GetAllocator(), 0);
+		Param4 heapParam4 = NewDelegateParam<Param4>(p4, GetAllocator(), 0);
+		Param5 heapParam5 = NewDelegateParam<Param5>(p5, GetAllocator(), 0);
 
 		// Create a clone instance of this delegate 
-		auto delegate = std::shared_ptr<ClassType>(Clone());
+		auto delegate = MakeDelegateClone(*this, GetAllocator());
 
 		// Create a new message instance 
-		auto msg = std::make_shared<DelegateMsg5<Param1, Param2, Param3, Param4, Param5>>(delegate, heapParam1, heapParam2, heapParam3, heapParam4, heapParam5);
+		auto msg = MakeDelegateMsg<DelegateMsg5<Param1, Param2, Param3, Param4, Param5>>(GetAllocator(), m_thread, delegate, heapParam1, heapParam2, heapParam3, heapParam4, heapParam5);
 
 		// Dispatch message onto the callback destination thread. DelegateInvoke()
 		// will be called by the target thread. 
@@ -585,16 +674,19 @@ public:
 		BaseType::operator()(param1, param2, param3, param4, param5);
 
 		// Delete heap data created inside operator()
-		DelegateParam<Param1>::Delete(param1);
-		DelegateParam<Param2>::Delete(param2);
-		DelegateParam<Param3>::Delete(param3);
-		DelegateParam<Param4>::Delete(param4);
-		DelegateParam<Param5>::Delete(param5);
+		DeleteDelegateParam<Param1>(param1, GetAllocator(), 0);
+		DeleteDelegateParam<Param2>(param2, GetAllocator(), 0);
+		DeleteDelegateParam<Param3>(param3, GetAllocator(), 0);
+		DeleteDelegateParam<Param4>(param4, GetAllocator(), 0);
+		DeleteDelegateParam<Param5>(param5, GetAllocator(), 0);
 	}
 
 private:
 	/// Target thread to invoke the delegate function
 	DelegateThread& m_thread;
+
+	/// Allocator for messages, clones and argument copies, or nullptr for the thread default
+	IDelegateAllocator* m_allocator;
 };
 
 /// @brief Asynchronous free delegate that invokes the target function on the specified thread of control.
@@ -605,7 +697,7 @@ public:
     using ClassType = DelegateFreeAsync<void(void)>;
     using BaseType = DelegateFree<void(void)>;
 
-	DelegateFreeAsync(FreeFunc func, DelegateThread& thread) : BaseType(func), m_thread(thread) { Bind(func, thread); }
+	DelegateFreeAsync(FreeFunc func, DelegateThread& thread, IDelegateAllocator* allocator = nullptr) : BaseType(func), m_thread(thread), m_allocator(allocator) { Bind(func, thread); }
 	DelegateFreeAsync() = delete;
 
 	/// Bind a free function to the delegate.
@@ -613,6 +705,9 @@ public:
 		m_thread = thread; 
 		BaseType::Bind(func);	}
 
+	/// Get the allocator for messages, clones and argument copies, or nullptr for the default.
+	IDelegateAllocator* GetAllocator() const { return m_allocator ? m_allocator : m_thread.GetAllocator(); }
+
 	virtual ClassType* Clone() const override {	return new ClassType(*this); }
 
 	virtual bool operator==(const DelegateBase& rhs) const {
@@ -624,10 +719,10 @@ public:
 	// Invoke delegate function asynchronously
 	virtual void operator()() override {
 		// Create a clone instance of this delegate 
-		auto delegate = std::shared_ptr<ClassType>(Clone());
+		auto delegate = MakeDelegateClone(*this, GetAllocator());
 
 		// Create a new message instance 
-		auto msg = std::make_shared<DelegateMsgBase>(delegate);
+		auto msg = MakeDelegateMsg<DelegateMsgBase>(GetAllocator(), m_thread, delegate);
 
 		// Dispatch message onto the callback destination thread. DelegateInvoke()
 		// will be called by the target thread. 
@@ -642,6 +737,9 @@ public:
 
 private:
 	DelegateThread& m_thread;
+
+	/// Allocator for messages, clones and argument copies, or nullptr for the thread default
+	IDelegateAllocator* m_allocator;
 };
 
 template <class Param1> 
@@ -651,7 +749,7 @@ public:
     using ClassType = DelegateFreeAsync<void(Param1)>;
     using BaseType = DelegateFree<void(Param1)>;
 
-	DelegateFreeAsync(FreeFunc func, DelegateThread& thread) : BaseType(func), m_thread(thread) { Bind(func, thread); }
+	DelegateFreeAsync(FreeFunc func, DelegateThread& thread, IDelegateAllocator* allocator = nullptr) : BaseType(func), m_thread(thread), m_allocator(allocator) { Bind(func, thread); }
 	DelegateFreeAsync() = delete;
 
 	/// Bind a free function to the delegate.
@@ -659,6 +757,9 @@ public:
 		m_thread = thread; 
 		BaseType::Bind(func);	}
 
+	/// Get the allocator for messages, clones and argument copies, or nullptr for the default.
+	IDelegateAllocator* GetAllocator() const { return m_allocator ? m_allocator : m_thread.GetAllocator(); }
+
 	virtual ClassType* Clone() const override {	return new ClassType(*this); }
 
 	virtual bool operator==(const DelegateBase& rhs) const {
@@ -670,13 +771,13 @@ public:
 	// Invoke delegate function asynchronously
 	virtual void operator()(Param1 p1) override {
 		// Create a new instance of the function argument data and copy
-		Param1 heapParam1 = DelegateParam<Param1>::New(p1);
+		Param1 heapParam1 = NewDelegateParam<Param1>(p1, GetAllocator(), 0);
 
 		// Create a clone instance of this delegate 
-		auto delegate = std::shared_ptr<ClassType>(Clone());
+		auto delegate = MakeDelegateClone(*this, GetAllocator());
 
 		// Create a new message instance 
-		auto msg = std::make_shared<DelegateMsg1<Param1>>(delegate, heapParam1);
+		auto msg = MakeDelegateMsg<DelegateMsg1<Param1>>(GetAllocator(), m_thread, delegate, heapParam1);
 
 		// Dispatch message onto the callback destination thread. DelegateInvoke()
 		// will be called by the target thread. 
@@ -700,11 +801,14 @@ public:
 		BaseType::operator()(param1);
 
 		// Delete heap data created inside operator()
-		DelegateParam<Param1>::Delete(param1);
+		DeleteDelegateParam<Param1>(param1, GetAllocator(), 0);
 	}
 
 private:
 	DelegateThread& m_thread;
+
+	/// Allocator for messages, clones and argument copies, or nullptr for the thread default
+	IDelegateAllocator* m_allocator;
 };
 
 template <class Param1, class Param2> 
@@ -714,7 +818,7 @@ public:
     using ClassType = DelegateFreeAsync<void(Param1, Param2)>;
     using BaseType = DelegateFree<void(Param1, Param2)>;
 
-	DelegateFreeAsync(FreeFunc func, DelegateThread& thread) : BaseType(func), m_thread(thread) { Bind(func, thread); }
+	DelegateFreeAsync(FreeFunc func, DelegateThread& thread, IDelegateAllocator* allocator = nullptr) : BaseType(func), m_thread(thread), m_allocator(allocator) { Bind(func, thread); }
 	DelegateFreeAsync() = delete;
 
 	/// Bind a free function to the delegate.
@@ -722,6 +826,9 @@ public:
 		m_thread = thread; 
 		BaseType::Bind(func);	}
 
+	/// Get the allocator for messages, clones and argument copies, or nullptr for the default.
+	IDelegateAllocator* GetAllocator() const { return m_allocator ? m_allocator : m_thread.GetAllocator(); }
+
 	virtual ClassType* Clone() const override {	return new ClassType(*this); }
 
 	virtual bool operator==(const DelegateBase& rhs) const {
@@ -733,14 +840,14 @@ public:
 	// Invoke delegate function asynchronously
 	virtual void operator()(Param1 p1, Param2 p2) override {
 		// Create a new instance of the function argument data and copy
-		Param1 heapParam1 = DelegateParam<Param1>::New(p1);
-		Param2 heapParam2 = DelegateParam<Param2>::New(p2);
+		Param1 heapParam1 = NewDelegateParam<Param1>(p1, GetAllocator(), 0);
+		Param2 heapParam2 = NewDelegateParam<Param2>(p2, GetAllocator(), 0);
 
 		// Create a clone instance of this delegate 
-		auto delegate = std::shared_ptr<ClassType>(Clone());
+		auto delegate = MakeDelegateClone(*this, GetAllocator());
 
 		// Create a new message instance 
-		auto msg = std::make_shared<DelegateMsg2<Param1, Param2>>(delegate, heapParam1, heapParam2);
+		auto msg = MakeDelegateMsg<DelegateMsg2<Param1, Param2>>(GetAllocator(), m_thread, delegate, heapParam1, heapParam2);
 
 		// Dispatch message onto the callback destination thread. DelegateInvoke()
 		// will be called by the target thread. 
@@ -766,12 +873,15 @@ public:
 		BaseType::operator()(param1, param2);
 
 		// Delete heap data created inside operator()
-		DelegateParam<Param1>::Delete(param1);
-		DelegateParam<Param2>::Delete(param2);
+		DeleteDelegateParam<Param1>(param1, GetAllocator(), 0);
+		DeleteDelegateParam<Param2>(param2, GetAllocator(), 0);
 	}
 
 private:
 	DelegateThread& m_thread;
+
+	/// Allocator for messages, clones and argument copies, or nullptr for the thread default
+	IDelegateAllocator* m_allocator;
 };
 
 template <class Param1, class Param2, class Param3> 
@@ -781,7 +891,7 @@ public:
     using ClassType = DelegateFreeAsync<void(Param1, Param2, Param3)>;
     using BaseType = DelegateFree<void(Param1, Param2, Param3)>;
 
-	DelegateFreeAsync(FreeFunc func, DelegateThread& thread) : BaseType(func), m_thread(thread) { Bind(func, thread); }
+	DelegateFreeAsync(FreeFunc func, DelegateThread& thread, IDelegateAllocator* allocator = nullptr) : BaseType(func), m_thread(thread), m_allocator(allocator) { Bind(func, thread); }
 	DelegateFreeAsync() = delete;
 
 	/// Bind a free function to the delegate.
@@ -789,6 +899,9 @@ public:
 		m_thread = thread; 
 		BaseType::Bind(func);	}
 
+	/// Get the allocator for messages, clones and argument copies, or nullptr for the default.
+	IDelegateAllocator* GetAllocator() const { return m_allocator ? m_allocator : m_thread.GetAllocator(); }
+
 	virtual ClassType* Clone() const override { return new ClassType(*this); }
 
 	virtual bool operator==(const DelegateBase& rhs) const {
@@ -800,15 +913,15 @@ public:
 	// Invoke delegate function asynchronously
 	virtual void operator()(Param1 p1, Param2 p2, Param3 p3) override {
 		// Create a new instance of the function argument data and copy
-		Param1 heapParam1 = DelegateParam<Param1>::New(p1);
-		Param2 heapParam2 = DelegateParam<Param2>::New(p2);
-		Param3 heapParam3 = DelegateParam<Param3>::New(p3);
+		Param1 heapParam1 = NewDelegateParam<Param1>(p1, GetAllocator(), 0);
+		Param2 heapParam2 = NewDelegateParam<Param2>(p2, GetAllocator(), 0);
+		Param3 heapParam3 = NewDelegateParam<Param3>(p3, GetAllocator(), 0);
 
 		// Create a clone instance of this delegate 
-		auto delegate = std::shared_ptr<ClassType>(Clone());
+		auto delegate = MakeDelegateClone(*this, GetAllocator());
 
 		// Create a new message instance 
-		auto msg = std::make_shared<DelegateMsg3<Param1, Param2, Param3>>(delegate, heapParam1, heapParam2, heapParam3);
+		auto msg = MakeDelegateMsg<DelegateMsg3<Param1, Param2, Param3>>(GetAllocator(), m_thread, delegate, heapParam1, heapParam2, heapParam3);
 
 		// Dispatch message onto the callback destination thread. DelegateInvoke()
 		// will be called by the target thread. 
@@ -836,13 +949,16 @@ public:
 		BaseType::operator()(param1, param2, param3);
 
 		// Delete heap data created inside operator()
-		DelegateParam<Param1>::Delete(param1);
-		DelegateParam<Param2>::Delete(param2);
-		DelegateParam<Param3>::Delete(param3);
+		DeleteDelegateParam<Param1>(param1, GetAllocator(), 0);
+		DeleteDelegateParam<Param2>(param2, GetAllocator(), 0);
+		DeleteDelegateParam<Param3>(param3, GetAllocator(), 0);
 	}
 
 private:
 	DelegateThread& m_thread;
+
+	/// Allocator for messages, clones and argument copies, or nullptr for the thread default
+	IDelegateAllocator* m_allocator;
 };
 
 template <class Param1, class Param2, class Param3, class Param4> 
@@ -852,7 +968,7 @@ public:
     using ClassType = DelegateFreeAsync<void(Param1, Param2, Param3, Param4)>;
     using BaseType = DelegateFree<void(Param1, Param2, Param3, Param4)>;
 
-	DelegateFreeAsync(FreeFunc func, DelegateThread& thread) : BaseType(func), m_thread(thread) { Bind(func, thread); }
+	DelegateFreeAsync(FreeFunc func, DelegateThread& thread, IDelegateAllocator* allocator = nullptr) : BaseType(func), m_thread(thread), m_allocator(allocator) { Bind(func, thread); }
 	DelegateFreeAsync() = delete;
 
 	/// Bind a free function to the delegate.
@@ -860,6 +976,9 @@ public:
 		m_thread = thread; 
 		BaseType::Bind(func);	}
 
+	/// Get the allocator for messages, clones and argument copies, or nullptr for the default.
+	IDelegateAllocator* GetAllocator() const { return m_allocator ? m_allocator : m_thread.GetAllocator(); }
+
 	virtual ClassType* Clone() const override { return new ClassType(*this); }
 
 	virtual bool operator==(const DelegateBase& rhs) const {
@@ -871,16 +990,16 @@ public:
 	// Invoke delegate function asynchronously
 	virtual void operator()(Param1 p1, Param2 p2, Param3 p3, Param4 p4) override {
 		// Create a new instance of the function argument data and copy
-		Param1 heapParam1 = DelegateParam<Param1>::New(p1);
-		Param2 heapParam2 = DelegateParam<Param2>::New(p2);
-		Param3 heapParam3 = DelegateParam<Param3>::New(p3);
-		Param4 heapParam4 = DelegateParam<Param4>::New(p4);
+		Param1 heapParam1 = NewDelegateParam<Param1>(p1, GetAllocator(), 0);
+		Param2 heapParam2 = NewDelegateParam<Param2>(p2, GetAllocator(), 0);
+		Param3 heapParam3 = NewDelegateParam<Param3>(p3, GetAllocator(), 0);
+		Param4 heapParam4 = NewDelegateParam<Param4>(p4, GetAllocator(), 0);
 
 		// Create a clone instance of this delegate 
-		auto delegate = std::shared_ptr<ClassType>(Clone());
+		auto delegate = MakeDelegateClone(*this, GetAllocator());
 
 		// Create a new message instance 
-		auto msg = std::make_shared<DelegateMsg4<Param1, Param2, Param3, Param4>>(delegate, heapParam1, heapParam2, heapParam3, heapParam4);
+		auto msg = MakeDelegateMsg<DelegateMsg4<Param1, Param2, Param3, Param4>>(GetAllocator(), m_thread, delegate, heapParam1, heapParam2, heapParam3, heapParam4);
 
 		// Dispatch message onto the callback destination thread. DelegateInvoke()
 		// will be called by the target thread. 
@@ -910,14 +1029,17 @@ public:
 		BaseType::operator()(param1, param2, param3, param4);
 
 		// Delete heap data created inside operator()
-		DelegateParam<Param1>::Delete(param1);
-		DelegateParam<Param2>::Delete(param2);
-		DelegateParam<Param3>::Delete(param3);
-		DelegateParam<Param4>::Delete(param4);
+		DeleteDelegateParam<Param1>(param1, GetAllocator(), 0);
+		DeleteDelegateParam<Param2>(param2, GetAllocator(), 0);
+		DeleteDelegateParam<Param3>(param3, GetAllocator(), 0);
+		DeleteDelegateParam<Param4>(param4, GetAllocator(), 0);
 	}
 
 private:
 	DelegateThread& m_thread;
+
+	/// Allocator for messages, clones and argument copies, or nullptr for the thread default
+	IDelegateAllocator* m_allocator;
 };
 
 template <class Param1, class Param2, class Param3, class Param4, class Param5> 
@@ -927,7 +1049,7 @@ public:
     using ClassType = DelegateFreeAsync<void(Param1, Param2, Param3, Param4, Param5)>;
     using BaseType = DelegateFree<void(Param1, Param2, Param3, Param4, Param5)>;
 
-	DelegateFreeAsync(FreeFunc func, DelegateThread& thread) : BaseType(func), m_thread(thread) { Bind(func, thread); }
+	DelegateFreeAsync(FreeFunc func, DelegateThread& thread, IDelegateAllocator* allocator = nullptr) : BaseType(func), m_thread(thread), m_allocator(allocator) { Bind(func, thread); }
 	DelegateFreeAsync() = delete;
 
 	/// Bind a free function to the delegate.
@@ -935,6 +1057,9 @@ public:
 		m_thread = thread; 
 		BaseType::Bind(func);	}
 
+	/// Get the allocator for messages, clones and argument copies, or nullptr for the default.
+	IDelegateAllocator* GetAllocator() const { return m_allocator ? m_allocator : m_thread.GetAllocator(); }
+
 	virtual ClassType* Clone() const override {	return new ClassType(*this); }
 
 	virtual bool operator==(const DelegateBase& rhs) const {
@@ -946,17 +1071,17 @@ public:
 	// Invoke delegate function asynchronously
 	virtual void operator()(Param1 p1, Param2 p2, Param3 p3, Param4 p4, Param5 p5) override {
 		// Create a new instance of the function argument data and copy
-		Param1 heapParam1 = DelegateParam<Param1>::New(p1);
-		Param2 heapParam2 = DelegateParam<Param2>::New(p2);
-		Param3 heapParam3 = DelegateParam<Param3>::New(p3);
-		Param4 heapParam4 = DelegateParam<Param4>::New(p4);
-		Param5 heapParam5 = DelegateParam<Param5>::New(p5);
+		Param1 heapParam1 = NewDelegateParam<Param1>(p1, GetAllocator(), 0);
+		Param2 heapParam2 = NewDelegateParam<Param2>(p2, GetAllocator(), 0);
+		Param3 heapParam3 = NewDelegateParam<Param3>(p3, GetAllocator(), 0);
+		Param4 heapParam4 = NewDelegateParam<Param4>(p4, GetAllocator(), 0);
+		Param5 heapParam5 = NewDelegateParam<Param5>(p5, GetAllocator(), 0);
 
 		// Create a clone instance of this delegate 
-		auto delegate = std::shared_ptr<ClassType>(Clone());
+		auto delegate = MakeDelegateClone(*this, GetAllocator());
 
 		// Create a new message instance 
-		auto msg = std::make_shared<DelegateMsg5<Param1, Param2, Param3, Param4, Param5>>(delegate, heapParam1, heapParam2, heapParam3, heapParam4, heapParam5);
+		auto msg = MakeDelegateMsg<DelegateMsg5<Param1, Param2, Param3, Param4, Param5>>(GetAllocator(), m_thread, delegate, heapParam1, heapParam2, heapParam3, heapParam4, heapParam5);
 
 		// Dispatch message onto the callback destination thread. DelegateInvoke()
 		// will be called by the target thread. 
@@ -988,15 +1113,18 @@ public:
 		BaseType::operator()(param1, param2, param3, param4, param5);
 
 		// Delete heap data created inside operator()
-		DelegateParam<Param1>::Delete(param1);
-		DelegateParam<Param2>::Delete(param2);
-		DelegateParam<Param3>::Delete(param3);
-		DelegateParam<Param4>::Delete(param4);
-		DelegateParam<Param5>::Delete(param5);
+		DeleteDelegateParam<Param1>(param1, GetAllocator(), 0);
+		DeleteDelegateParam<Param2>(param2, GetAllocator(), 0);
+		DeleteDelegateParam<Param3>(param3, GetAllocator(), 0);
+		DeleteDelegateParam<Param4>(param4, GetAllocator(), 0);
+		DeleteDelegateParam<Param5>(param5, GetAllocator(), 0);
 	}
 
 private:
 	DelegateThread& m_thread;
+
+	/// Allocator for messages, clones and argument copies, or nullptr for the thread default
+	IDelegateAllocator* m_allocator;
 };
 
 //N=0
@@ -1005,95 +1133,184 @@ DelegateMemberAsync<void(TClass(void))> MakeDelegate(TClass* object, void (TClas
 	return DelegateMemberAsync<void(TClass(void))>(object, func, thread);
 }
 
+template <class TClass>
+DelegateMemberAsync<void(TClass(void))> MakeDelegate(TClass* object, void (TClass::*func)(), DelegateThread& thread, IDelegateAllocator& allocator) {
+	return DelegateMemberAsync<void(TClass(void))>(object, func, thread, &allocator);
+}
+
 template <class TClass>
 DelegateMemberAsync<void(TClass(void))> MakeDelegate(TClass* object, void (TClass::*func)() const, DelegateThread& thread) {
 	return DelegateMemberAsync<void(TClass(void))>(object, func, thread);
 }
 
+template <class TClass>
+DelegateMemberAsync<void(TClass(void))> MakeDelegate(TClass* object, void (TClass::*func)() const, DelegateThread& thread, IDelegateAllocator& allocator) {
+	return DelegateMemberAsync<void(TClass(void))>(object, func, thread, &allocator);
+}
+
 inline DelegateFreeAsync<void(void)> MakeDelegate(void (*func)(), DelegateThread& thread) { 
 	return DelegateFreeAsync<void(void)>(func, thread);
 }
 
+inline DelegateFreeAsync<void(void)> MakeDelegate(void (*func)(), DelegateThread& thread, IDelegateAllocator& allocator) {
+	return DelegateFreeAsync<void(void)>(func, thread, &allocator);
+}
+
 //N=1
 template <class TClass, class Param1>
 DelegateMemberAsync<void(TClass(Param1))> MakeDelegate(TClass* object, void (TClass::*func)(Param1 p1), DelegateThread& thread) { 
 	return DelegateMemberAsync<void(TClass(Param1))>(object, func, thread);
 }
 
+template <class TClass, class Param1>
+DelegateMemberAsync<void(TClass(Param1))> MakeDelegate(TClass* object, void (TClass::*func)(Param1 p1), DelegateThread& thread, IDelegateAllocator& allocator) {
+	return DelegateMemberAsync<void(TClass(Param1))>(object, func, thread, &allocator);
+}
+
 template <class TClass, class Param1>
 DelegateMemberAsync<void(TClass(Param1))> MakeDelegate(TClass* object, void (TClass::*func)(Param1 p1) const, DelegateThread& thread) {
 	return DelegateMemberAsync<void(TClass(Param1))>(object, func, thread);
 }
 
+template <class TClass, class Param1>
+DelegateMemberAsync<void(TClass(Param1))> MakeDelegate(TClass* object, void (TClass::*func)(Param1 p1) const, DelegateThread& thread, IDelegateAllocator& allocator) {
+	return DelegateMemberAsync<void(TClass(Param1))>(object, func, thread, &allocator);
+}
+
 template <class Param1>
 DelegateFreeAsync<void(Param1)> MakeDelegate(void (*func)(Param1 p1), DelegateThread& thread) {
 	return DelegateFreeAsync<void(Param1)>(func, thread);
 }
 
+template <class Param1>
+DelegateFreeAsync<void(Param1)> MakeDelegate(void (*func)(Param1 p1), DelegateThread& thread, IDelegateAllocator& allocator) {
+	return DelegateFreeAsync<void(Param1)>(func, thread, &allocator);
+}
+
 //N=2
 template <class TClass, class Param1, class Param2>
 DelegateMemberAsync<void(TClass(Param1, Param2))> MakeDelegate(TClass* object, void (TClass::*func)(Param1 p1, Param2 p2), DelegateThread& thread) {
 	return DelegateMemberAsync<void(TClass(Param1, Param2))>(object, func, thread);
 }
 
+template <class TClass, class Param1, class Param2>
+DelegateMemberAsync<void(TClass(Param1, Param2))> MakeDelegate(TClass* object, void (TClass::*func)(Param1 p1, Param2 p2), DelegateThread& thread, IDelegateAllocator& allocator) {
+	return DelegateMemberAsync<void(TClass(Param1, Param2))>(object, func, thread, &allocator);
+}
+
 template <class TClass, class Param1, class Param2>
 DelegateMemberAsync<void(TClass(Param1, Param2))> MakeDelegate(TClass* object, void (TClass::*func)(Param1 p1, Param2 p2) const, DelegateThread& thread) {
 	return DelegateMemberAsync<void(TClass(Param1, Param2))>(object, func, thread);
 }
 
+template <class TClass, class Param1, class Param2>
+DelegateMemberAsync<void(TClass(Param1, Param2))> MakeDelegate(TClass* object, void (TClass::*func)(Param1 p1, Param2 p2) const, DelegateThread& thread, IDelegateAllocator& allocator) {
+	return DelegateMemberAsync<void(TClass(Param1, Param2))>(object, func, thread, &allocator);
+}
+
 template <class Param1, class Param2>
 DelegateFreeAsync<void(Param1, Param2)> MakeDelegate(void (*func)(Param1 p1, Param2 p2), DelegateThread& thread) {
 	return DelegateFreeAsync<void(Param1, Param2)>(func, thread);
 }
 
+template <class Param1, class Param2>
+DelegateFreeAsync<void(Param1, Param2)> MakeDelegate(void (*func)(Param1 p1, Param2 p2), DelegateThread& thread, IDelegateAllocator& allocator) {
+	return DelegateFreeAsync<void(Param1, Param2)>(func, thread, &allocator);
+}
+
 //N=3
 template <class TClass, class Param1, class Param2, class Param3>
 DelegateMemberAsync<void(TClass(Param1, Param2, Param3))> MakeDelegate(TClass* object, void (TClass::*func)(Param1 p1, Param2 p2, Param3 p3), DelegateThread& thread) {
 	return DelegateMemberAsync<void(TClass(Param1, Param2, Param3))>(object, func, thread);
 }
 
+template <class TClass, class Param1, class Param2, class Param3>
+DelegateMemberAsync<void(TClass(Param1, Param2, Param3))> MakeDelegate(TClass* object, void (TClass::*func)(Param1 p1, Param2 p2, Param3 p3), DelegateThread& thread, IDelegateAllocator& allocator) {
+	return DelegateMemberAsync<void(TClass(Param1, Param2, Param3))>(object, func, thread, &allocator);
+}
+
 template <class TClass, class Param1, class Param2, class Param3>
 DelegateMemberAsync<void(TClass(Param1, Param2, Param3))> MakeDelegate(TClass* object, void (TClass::*func)(Param1 p1, Param2 p2, Param3 p3) const, DelegateThread& thread) {
 	return DelegateMemberAsync<void(TClass(Param1, Param2, Param3))>(object, func, thread);
 }
 
+template <class TClass, class Param1, class Param2, class Param3>
+DelegateMemberAsync<void(TClass(Param1, Param2, Param3))> MakeDelegate(TClass* object, void (TClass::*func)(Param1 p1, Param2 p2, Param3 p3) const, DelegateThread& thread, IDelegateAllocator& allocator) {
+	return DelegateMemberAsync<void(TClass(Param1, Param2, Param3))>(object, func, thread, &allocator);
+}
+
 template <class Param1, class Param2, class Param3>
 DelegateFreeAsync<void(Param1, Param2, Param3)> MakeDelegate(void (*func)(Param1 p1, Param2 p2, Param3 p3), DelegateThread& thread) {
 	return DelegateFreeAsync<void(Param1, Param2, Param3)>(func, thread);
 }
 
+template <class Param1, class Param2, class Param3>
+DelegateFreeAsync<void(Param1, Param2, Param3)> MakeDelegate(void (*func)(Param1 p1, Param2 p2, Param3 p3), DelegateThread& thread, IDelegateAllocator& allocator) {
+	return DelegateFreeAsync<void(Param1, Param2, Param3)>(func, thread, &allocator);
+}
+
 //N=4
 template <class TClass, class Param1, class Param2, class Param3, class Param4>
 DelegateMemberAsync<void(TClass(Param1, Param2, Param3, Param4))> MakeDelegate(TClass* object, void (TClass::*func)(Param1 p1, Param2 p2, Param3 p3, Param4 p4), DelegateThread& thread) {
 	return DelegateMemberAsync<void(TClass(Param1, Param2, Param3, Param4))>(object, func, thread);
 }
 
+template <class TClass, class Param1, class Param2, class Param3, class Param4>
+DelegateMemberAsync<void(TClass(Param1, Param2, Param3, Param4))> MakeDelegate(TClass* object, void (TClass::*func)(Param1 p1, Param2 p2, Param3 p3, Param4 p4), DelegateThread& thread, IDelegateAllocator& allocator) {
+	return DelegateMemberAsync<void(TClass(Param1, Param2, Param3, Param4))>(object, func, thread, &allocator);
+}
+
 template <class TClass, class Param1, class Param2, class Param3, class Param4>
 DelegateMemberAsync<void(TClass(Param1, Param2, Param3, Param4))> MakeDelegate(TClass* object, void (TClass::*func)(Param1 p1, Param2 p2, Param3 p3, Param4 p4) const, DelegateThread& thread) {
 	return DelegateMemberAsync<void(TClass(Param1, Param2, Param3, Param4))>(object, func, thread);
 }
 
+template <class TClass, class Param1, class Param2, class Param3, class Param4>
+DelegateMemberAsync<void(TClass(Param1, Param2, Param3, Param4))> MakeDelegate(TClass* object, void (TClass::*func)(Param1 p1, Param2 p2, Param3 p3, Param4 p4) const, DelegateThread& thread, IDelegateAllocator& allocator) {
+	return DelegateMemberAsync<void(TClass(Param1, Param2, Param3, Param4))>(object, func, thread, &allocator);
+}
+
 template <class Param1, class Param2, class Param3, class Param4>
 DelegateFreeAsync<void(Param1, Param2, Param3, Param4)> MakeDelegate(void (*func)(Param1 p1, Param2 p2, Param3 p3, Param4 p4), DelegateThread& thread) {
 	return DelegateFreeAsync<void(Param1, Param2, Param3, Param4)>(func, thread);
 }
 
+template <class Param1, class Param2, class Param3, class Param4>
+DelegateFreeAsync<void(Param1, Param2, Param3, Param4)> MakeDelegate(void (*func)(Param1 p1, Param2 p2, Param3 p3, Param4 p4), DelegateThread& thread, IDelegateAllocator& allocator) {
+	return DelegateFreeAsync<void(Param1, Param2, Param3, Param4)>(func, thread, &allocator);
+}
+
 //N=5
 template <class TClass, class Param1, class Param2, class Param3, class Param4, class Param5>
 DelegateMemberAsync<void(TClass(Param1, Param2, Param3, Param4, Param5))> MakeDelegate(TClass* object, void (TClass::*func)(Param1 p1, Param2 p2, Param3 p3, Param4 p4, Param5 p5), DelegateThread& thread) {
 	return DelegateMemberAsync<void(TClass(Param1, Param2, Param3, Param4, Param5))>(object, func, thread);
 }
 
+template <class TClass, class Param1, class Param2, class Param3, class Param4, class Param5>
+DelegateMemberAsync<void(TClass(Param1, Param2, Param3, Param4, Param5))> MakeDelegate(TClass* object, void (TClass::*func)(Param1 p1, Param2 p2, Param3 p3, Param4 p4, Param5 p5), DelegateThread& thread, IDelegateAllocator& allocator) {
+	return DelegateMemberAsync<void(TClass(Param1, Param2, Param3, Param4, Param5))>(object, func, thread, &allocator);
+}
+
 template <class TClass, class Param1, class Param2, class Param3, class Param4, class Param5>
 DelegateMemberAsync<void(TClass(Param1, Param2, Param3, Param4, Param5))> MakeDelegate(TClass* object, void (TClass::*func)(Param1 p1, Param2 p2, Param3 p3, Param4 p4, Param5 p5) const, DelegateThread& thread) {
 	return DelegateMemberAsync<void(TClass(Param1, Param2, Param3, Param4, Param5))>(object, func, thread);
 }
 
+template <class TClass, class Param1, class Param2, class Param3, class Param4, class Param5>
+DelegateMemberAsync<void(TClass(Param1, Param2, Param3, Param4, Param5))> MakeDelegate(TClass* object, void (TClass::*func)(Param1 p1, Param2 p2, Param3 p3, Param4 p4, Param5 p5) const, DelegateThread& thread, IDelegateAllocator& allocator) {
+	return DelegateMemberAsync<void(TClass(Param1, Param2, Param3, Param4, Param5))>(object, func, thread, &allocator);
+}
+
 template <class Param1, class Param2, class Param3, class Param4, class Param5>
 DelegateFreeAsync<void(Param1, Param2, Param3, Param4, Param5)> MakeDelegate(void (*func)(Param1 p1, Param2 p2, Param3 p3, Param4 p4, Param5 p5), DelegateThread& thread) {
 	return DelegateFreeAsync<void(Param1, Param2, Param3, Param4, Param5)>(func, thread);
 }
 
+template <class Param1, class Param2, class Param3, class Param4, class Param5>
+DelegateFreeAsync<void(Param1, Param2, Param3, Param4, Param5)> MakeDelegate(void (*func)(Param1 p1, Param2 p2, Param3 p3, Param4 p4, Param5 p5), DelegateThread& thread, IDelegateAllocator& allocator) {
+	return DelegateFreeAsync<void(Param1, Param2, Param3, Param4, Param5)>(func, thread, &allocator);
+}
+
 }
 
 #endif
@@ -149,7 +149,7 @@ public:
 			delegate->m_sema.Reset();
 
 			// Create a new message instance 
-			auto msg = std::make_shared<DelegateMsgBase>(delegate);
+			auto msg = MakeDelegateMsg<DelegateMsgBase>(m_thread, delegate);
 
 			// Dispatch message onto the callback destination thread. DelegateInvoke()
 			// will be called by the target thread. 
@@ -273,7 +273,7 @@ public:
 			delegate->m_sema.Reset();
 
 			// Create a new message instance 
-			auto msg = std::make_shared<DelegateMsg1<Param1>>(delegate, p1);
+			auto msg = MakeDelegateMsg<DelegateMsg1<Param1>>(m_thread, delegate, p1);
 
 			// Dispatch message onto the callback destination thread. DelegateInvoke()
 			// will be called by the target thread. 
@@ -404,7 +404,7 @@ public:
 			delegate->m_sema.Reset();
 
 			// Create a new message instance 
-			auto msg = std::make_shared<DelegateMsg2<Param1, Param2>>(delegate, p1, p2);
+			auto msg = MakeDelegateMsg<DelegateMsg2<Param1, Param2>>(m_thread, delegate, p1, p2);
 
 			// Dispatch message onto the callback destination thread. DelegateInvoke()
 			// will be called by the target thread. 
@@ -536,7 +536,7 @@ public:
 			delegate->m_sema.Reset();
 
 			// Create a new message instance 
-			auto msg = std::make_shared<DelegateMsg3<Param1, Param2, Param3>>(delegate, p1, p2, p3);
+			auto msg = MakeDelegateMsg<DelegateMsg3<Param1, Param2, Param3>>(m_thread, delegate, p1, p2, p3);
 
 			// Dispatch message onto the callback destination thread. DelegateInvoke()
 			// will be called by the target thread. 
@@ -669,7 +669,7 @@ public:
 			delegate->m_sema.Reset();
 
 			// Create a new message instance 
-			auto msg = std::make_shared<DelegateMsg4<Param1, Param2, Param3, Param4>>(delegate, p1, p2, p3, p4);
+			auto msg = MakeDelegateMsg<DelegateMsg4<Param1, Param2, Param3, Param4>>(m_thread, delegate, p1, p2, p3, p4);
 
 			// Dispatch message onto the callback destination thread. DelegateInvoke()
 			// will be called by the target thread. 
@@ -803,7 +803,7 @@ public:
 			delegate->m_sema.Reset();
 
 			// Create a new message instance 
-			auto msg = std::make_shared<DelegateMsg5<Param1, Param2, Param3, Param4, Param5>>(delegate, p1, p2, p3, p4, p5);
+			auto msg = MakeDelegateMsg<DelegateMsg5<Param1, Param2, Param3, Param4, Param5>>(m_thread, delegate, p1, p2, p3, p4, p5);
 
 			// Dispatch message onto the callback destination thread. DelegateInvoke()
 			// will be called by the target thread. 
@@ -936,7 +936,7 @@ public:
 			delegate->m_sema.Reset();
 
 			// Create a new message instance 
-			auto msg = std::make_shared<DelegateMsgBase>(delegate);
+			auto msg = MakeDelegateMsg<DelegateMsgBase>(m_thread, delegate);
 
 			// Dispatch message onto the callback destination thread. DelegateInvoke()
 			// will be called by the target thread. 
@@ -1048,7 +1048,7 @@ public:
 			delegate->m_sema.Reset();
 
 			// Create a new message instance 
-			auto msg = std::make_shared<DelegateMsg1<Param1>>(delegate, p1);
+			auto msg = MakeDelegateMsg<DelegateMsg1<Param1>>(m_thread, delegate, p1);
 
 			// Dispatch message onto the callback destination thread. DelegateInvoke()
 			// will be called by the target thread. 
@@ -1168,7 +1168,7 @@ public:
 			delegate->m_sema.Reset();
 
 			// Create a new message instance 
-			auto msg = std::make_shared<DelegateMsg2<Param1, Param2>>(delegate, p1, p2);
+			auto msg = MakeDelegateMsg<DelegateMsg2<Param1, Param2>>(m_thread, delegate, p1, p2);
 
 			// Dispatch message onto the callback destination thread. DelegateInvoke()
 			// will be called by the target thread. 
@@ -1288,7 +1288,7 @@ public:
 			delegate->m_sema.Reset();
 
 			// Create a new message instance 
-			auto msg = std::make_shared<DelegateMsg3<Param1, Param2, Param3>>(delegate, p1, p2, p3);
+			auto msg = MakeDelegateMsg<DelegateMsg3<Param1, Param2, Param3>>(m_thread, delegate, p1, p2, p3);
 
 			// Dispatch message onto the callback destination thread. DelegateInvoke()
 			// will be called by the target thread. 
@@ -1409,7 +1409,7 @@ public:
 			delegate->m_sema.Reset();
 
 			// Create a new message instance 
-			auto msg = std::make_shared<DelegateMsg4<Param1, Param2, Param3, Param4>>(delegate, p1, p2, p3, p4);
+			auto msg = MakeDelegateMsg<DelegateMsg4<Param1, Param2, Param3, Param4>>(m_thread, delegate, p1, p2, p3, p4);
 
 			// Dispatch message onto the callback destination thread. DelegateInvoke()
 			// will be called by the target thread. 
@@ -1531,7 +1531,7 @@ public:
 			delegate->m_sema.Reset();
 
 			// Create a new message instance 
-			auto msg = std::make_shared<DelegateMsg5<Param1, Param2, Param3, Param4, Param5>>(delegate, p1, p2, p3, p4, p5);
+			auto msg = MakeDelegateMsg<DelegateMsg5<Param1, Param2, Param3, Param4, Param5>>(m_thread, delegate, p1, p2, p3, p4, p5);
 
 			// Dispatch message onto the callback destination thread. DelegateInvoke()
 			// will be called by the target thread. 
@@ -0,0 +1,582 @@
+#ifdef DELEGATE_BENCHMARKS
+
+// DelegateBenchmarks.cpp
+// Micro benchmarks for the delegate library. Enable with the CMake option
+// ENABLE_BENCHMARKS and run DelegateApp. Results are written to std::cout.
+
+#include "DelegateLib.h"
+#include "Allocator.h"
+#include "xallocator.h"
+#include "MessageArena.h"
+#include "Timer.h"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <algorithm>
+#include <sstream>
+#include <thread>
+#include <vector>
+#if USE_STD_THREADS
+	#include "WorkerThreadStd.h"
+#endif
+#if defined(__linux__)
+	#include "ShmTransport.h"
+	#include "DelegateRecorder.h"
+	#include "DelegateReplayer.h"
+	#include <signal.h>
+	#include <sys/wait.h>
+	#include <unistd.h>
+#endif
+
+using namespace DelegateLib;
+using namespace std::chrono;
+
+static long long NowNs()
+{
+	return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+#if defined(__linux__)
+static const INT SHM_BENCH_MESSAGES = 100000;
+static const INT SHM_BENCH_STREAM = 1000000;
+static const DelegateIdType SHM_BENCH_PING_ID = 1000;
+static const DelegateIdType SHM_BENCH_PONG_ID = 1002;
+static const DelegateIdType SHM_BENCH_STREAM_ID = 1003;
+static const long long SHM_BENCH_DEADLINE_NS = 30000000000LL;
+static DelegateRemoteSend<void(INT)>* shmPong = NULL;
+static INT shmPongs = 0;
+static INT shmStreamed = 0;
+
+static void ShmBenchPing(INT seq)
+{
+	(*shmPong)(seq);
+}
+
+static void ShmBenchStream(INT seq)
+{
+	// Acknowledge the end of the stream with a pong following the pings
+	if (++shmStreamed == SHM_BENCH_STREAM)
+		(*shmPong)(SHM_BENCH_MESSAGES);
+}
+
+static void ShmBenchPong(INT seq)
+{
+	shmPongs = seq + 1;
+}
+
+/// Child side of ShmTransportBenchmark(). Echoes each ping back to the parent,
+/// then acknowledges the streamed messages once all have arrived.
+/// @return The process exit code; nonzero if a ring could not be opened.
+static int ShmBenchEcho(const CHAR* pingName, const CHAR* pongName)
+{
+	ShmTransport pingTransport;
+	ShmTransport pongTransport;
+	if (!pingTransport.Open(pingName, 1 << 16, ShmTransport::RECEIVE) ||
+		!pongTransport.Open(pongName, 1 << 16, ShmTransport::SEND))
+		return 1;
+
+	DelegateRemoteSend<void(INT)> pong(pongTransport, SHM_BENCH_PONG_ID);
+	shmPong = &pong;
+	DelegateFreeRemoteRecv<void(INT)> recv(&ShmBenchPing, SHM_BENCH_PING_ID);
+	DelegateFreeRemoteRecv<void(INT)> recvStream(&ShmBenchStream, SHM_BENCH_STREAM_ID);
+
+	INT received = 0;
+	long long deadline = NowNs() + SHM_BENCH_DEADLINE_NS;
+	while (received < SHM_BENCH_MESSAGES + SHM_BENCH_STREAM && NowNs() < deadline)
+		received += pingTransport.Receive(100);
+	pingTransport.Close();
+	pongTransport.Close();
+	return (received == SHM_BENCH_MESSAGES + SHM_BENCH_STREAM) ? 0 : 2;
+}
+
+/// Wait for a child process until the deadline, killing it if it overruns.
+/// @return TRUE if the child exited normally with status 0.
+static BOOL WaitChild(pid_t pid, long long deadline)
+{
+	int status = 0;
+	pid_t done;
+	while ((done = waitpid(pid, &status, WNOHANG)) == 0 && NowNs() < deadline)
+		std::this_thread::sleep_for(milliseconds(10));
+	if (done == 0)
+	{
+		kill(pid, SIGKILL);
+		waitpid(pid, &status, 0);
+		return FALSE;
+	}
+	return (done == pid && WIFEXITED(status) && WEXITSTATUS(status) == 0) ? TRUE : FALSE;
+}
+
+/// Two process shared memory transport latency and throughput. For latency the
+/// parent sends one ping at a time to the child over one ring and waits for its
+/// pong on a second ring, so each message crosses an empty ring and the round
+/// trip measures transport latency rather than time queued behind a full ring.
+/// For throughput the parent then streams messages as fast as the ring accepts
+/// them until the child acknowledges the last. Must run before any other thread
+/// is started, as the child process is forked.
+static void ShmTransportBenchmark()
+{
+	const CHAR* pingName = "/DelegateBenchPing";
+	const CHAR* pongName = "/DelegateBenchPong";
+	ShmTransport::Unlink(pingName);
+	ShmTransport::Unlink(pongName);
+
+	std::cout.flush();
+	pid_t pid = fork();
+	if (pid < 0)
+		return;
+	if (pid == 0)
+		_exit(ShmBenchEcho(pingName, pongName));
+
+	long long deadline = NowNs() + SHM_BENCH_DEADLINE_NS;
+	std::vector<long long> roundTrips;
+	double streamSeconds = 0;
+	ShmTransport pingTransport;
+	ShmTransport pongTransport;
+	if (pingTransport.Open(pingName, 1 << 16, ShmTransport::SEND) &&
+		pongTransport.Open(pongName, 1 << 16, ShmTransport::RECEIVE))
+	{
+		DelegateRemoteSend<void(INT)> ping(pingTransport, SHM_BENCH_PING_ID);
+		DelegateFreeRemoteRecv<void(INT)> recv(&ShmBenchPong, SHM_BENCH_PONG_ID);
+		roundTrips.reserve(SHM_BENCH_MESSAGES);
+		shmPongs = 0;
+		for (INT i = 0; i < SHM_BENCH_MESSAGES && NowNs() < deadline; i++)
+		{
+			long long start = NowNs();
+			ping(i);
+			while (shmPongs <= i && NowNs() < deadline)
+				pongTransport.Receive(100);
+			if (shmPongs <= i)
+				break;
+			roundTrips.push_back(NowNs() - start);
+		}
+
+		if (roundTrips.size() == (size_t)SHM_BENCH_MESSAGES)
+		{
+			DelegateRemoteSend<void(INT)> stream(pingTransport, SHM_BENCH_STREAM_ID);
+			long long start = NowNs();
+			for (INT i = 0; i < SHM_BENCH_STREAM && NowNs() < deadline; i++)
+				stream(i);
+			while (shmPongs <= SHM_BENCH_MESSAGES && NowNs() < deadline)
+				pongTransport.Receive(100);
+			if (shmPongs > SHM_BENCH_MESSAGES)
+				streamSeconds = (NowNs() - start) / 1e9;
+		}
+	}
+	BOOL childOk = WaitChild(pid, deadline + 1000000000LL);
+	pingTransport.Close();
+	pongTransport.Close();
+	ShmTransport::Unlink(pingName);
+
+	if (!childOk || roundTrips.size() != (size_t)SHM_BENCH_MESSAGES || streamSeconds == 0)
+	{
+		std::cout << "ShmTransport: benchmark failed, " << roundTrips.size() << " of "
+			<< SHM_BENCH_MESSAGES << " round trips" << std::endl;
+		return;
+	}
+
+	// One way latency is half the round trip
+	std::sort(roundTrips.begin(), roundTrips.end());
+	std::cout << "ShmTransport: " << SHM_BENCH_MESSAGES << " ping-pong msgs, one way latency p50 "
+		<< roundTrips[roundTrips.size() / 2] / 2 << " ns, p99 "
+		<< roundTrips[roundTrips.size() * 99 / 100] / 2 << " ns" << std::endl;
+	std::cout << "ShmTransport: " << SHM_BENCH_STREAM << " streamed msgs, "
+		<< (long long)(SHM_BENCH_STREAM / streamSeconds) << " msgs/s" << std::endl;
+}
+
+static const INT LOG_BENCH_MESSAGES = 200000;
+static const DelegateIdType LOG_BENCH_ID = 1001;
+static INT logReplayed = 0;
+
+static void LogBenchRecv(INT a, INT b)
+{
+	logReplayed++;
+}
+
+/// Record LOG_BENCH_MESSAGES invocations to a rotating memory mapped log, then
+/// replay them as fast as possible into a registered receiver.
+static void RecordReplayBenchmark()
+{
+	const CHAR* path = "/tmp/DelegateBench.log";
+	DelegateRecorder recorder;
+	if (!recorder.Open(path, 1 << 22))
+		return;
+
+	DelegateRemoteSend<void(INT, INT)> send(recorder, LOG_BENCH_ID);
+	long long start = NowNs();
+	for (INT i = 0; i < LOG_BENCH_MESSAGES; i++)
+		send(i, LOG_BENCH_MESSAGES - i);
+	double recordSeconds = (NowNs() - start) / 1e9;
+	recorder.Close();
+
+	DelegateFreeRemoteRecv<void(INT, INT)> recv(&LogBenchRecv, LOG_BENCH_ID);
+	DelegateReplayer replayer;
+	if (!replayer.Open(path))
+		return;
+	start = NowNs();
+	uint64_t replayed = replayer.Replay(DelegateReplayer::FAST);
+	double replaySeconds = (NowNs() - start) / 1e9;
+
+	std::cout << "DelegateRecorder: " << LOG_BENCH_MESSAGES << " msgs, "
+		<< (long long)(LOG_BENCH_MESSAGES / recordSeconds) << " msgs/s recorded, "
+		<< (long long)(replayed / replaySeconds) << " msgs/s replayed, "
+		<< replayer.GetSegmentCount() << " segments" << std::endl;
+}
+#endif
+
+static const INT ALLOC_BENCH_BLOCKS = 1000000;
+static const INT ALLOC_BENCH_QUEUE = 1024;
+
+/// Allocate on a producer thread and free on a consumer thread, the pattern of
+/// asynchronous delegate messages. A lock-free single producer/single consumer
+/// queue passes the blocks so that allocator cost dominates.
+/// @return Average nanoseconds per allocate/free pair.
+static double ProducerConsumerAlloc(void* (*alloc)(size_t), void (*dealloc)(void*))
+{
+	typedef DelegateMsg2<INT, INT> MsgType;
+	static void* queue[ALLOC_BENCH_QUEUE];
+	std::atomic<INT> head(0), tail(0);
+
+	long long start = NowNs();
+	std::thread consumer([&]() {
+		for (INT i = 0; i < ALLOC_BENCH_BLOCKS; i++)
+		{
+			INT t = tail.load(std::memory_order_relaxed);
+			while (head.load(std::memory_order_acquire) == t)
+				std::this_thread::yield();
+			dealloc(queue[t % ALLOC_BENCH_QUEUE]);
+			tail.store(t + 1, std::memory_order_release);
+		}
+	});
+
+	for (INT i = 0; i < ALLOC_BENCH_BLOCKS; i++)
+	{
+		void* block = alloc(sizeof(MsgType));
+		*static_cast<INT*>(block) = i;
+		while (i - tail.load(std::memory_order_acquire) >= ALLOC_BENCH_QUEUE)
+			std::this_thread::yield();
+		queue[i % ALLOC_BENCH_QUEUE] = block;
+		head.store(i + 1, std::memory_order_release);
+	}
+	consumer.join();
+	return (double)(NowNs() - start) / ALLOC_BENCH_BLOCKS;
+}
+
+/// Compare xmalloc/xfree with malloc/free for cross thread message traffic.
+static void AllocatorProducerConsumerBenchmark()
+{
+	double xalloc = ProducerConsumerAlloc(&xmalloc, &xfree);
+	double heap = ProducerConsumerAlloc(&malloc, &free);
+	std::cout << "Producer/consumer alloc: xmalloc/xfree " << xalloc << " ns, malloc/free "
+		<< heap << " ns per message" << std::endl;
+}
+
+static const INT ALLOC_BENCH_LOOPS = 10000000;
+
+/// Allocate and free one block per iteration on a single thread.
+/// @return Average nanoseconds per allocate/free pair.
+template <class TAllocator>
+static double SingleThreadAlloc(TAllocator& allocator)
+{
+	long long start = NowNs();
+	for (INT i = 0; i < ALLOC_BENCH_LOOPS; i++)
+	{
+		void* block = allocator.Allocate(allocator.GetBlockSize());
+		*static_cast<volatile INT*>(block) = i;
+		allocator.Deallocate(block);
+	}
+	return (double)(NowNs() - start) / ALLOC_BENCH_LOOPS;
+}
+
+static Allocator threadSafeBench(sizeof(DelegateMsg2<INT, INT>), 0, NULL, "ThreadSafeBench", 0, Allocator::THREAD_SAFE);
+static void* ThreadSafeBenchAlloc(size_t size) { return threadSafeBench.Allocate(size); }
+static void ThreadSafeBenchFree(void* block) { threadSafeBench.Deallocate(block); }
+
+/// Compare the single thread Allocator with a thread safe Allocator on the single 
+/// thread path, which should cost the same.
+static void ThreadSafeAllocatorBenchmark()
+{
+	Allocator allocator(sizeof(DelegateMsg2<INT, INT>));
+	Allocator threadSafe(sizeof(DelegateMsg2<INT, INT>), 0, NULL, NULL, 0, Allocator::THREAD_SAFE);
+	double single = SingleThreadAlloc(allocator);
+	double safe = SingleThreadAlloc(threadSafe);
+	double crossThread = ProducerConsumerAlloc(&ThreadSafeBenchAlloc, &ThreadSafeBenchFree);
+	std::cout << "Single thread alloc: Allocator " << single << " ns, thread safe Allocator "
+		<< safe << " ns; thread safe Allocator producer/consumer " << crossThread
+		<< " ns per message" << std::endl;
+}
+
+/// Single thread xmalloc/xfree latency compared with malloc/free across request sizes.
+static void XallocatorSizeBenchmark()
+{
+	const size_t sizes[] = { 8, 24, 56, 120, 300, 600, 1000, 4000, 16000 };
+	const INT loops = 1000000;
+	std::ostringstream result;
+	result << "xmalloc/xfree vs malloc/free ns:";
+	for (size_t size : sizes)
+	{
+		long long start = NowNs();
+		for (INT i = 0; i < loops; i++)
+		{
+			void* block = xmalloc(size);
+			*static_cast<volatile CHAR*>(block) = (CHAR)i;
+			xfree(block);
+		}
+		double xalloc = (double)(NowNs() - start) / loops;
+
+		start = NowNs();
+		for (INT i = 0; i < loops; i++)
+		{
+			void* block = malloc(size);
+			*static_cast<volatile CHAR*>(block) = (CHAR)i;
+			free(block);
+		}
+		double heap = (double)(NowNs() - start) / loops;
+		result << " " << size << "B " << xalloc << "/" << heap;
+	}
+	std::cout << result.str() << std::endl;
+}
+
+/// Latency of the first allocations from a new allocator, cold and after Reserve() 
+/// created and pre-faulted the blocks.
+static void AllocatorReserveBenchmark()
+{
+	const UINT blocks = 20000;
+	const size_t size = 1024;
+	std::vector<void*> held(blocks);
+	double average[2];
+	long long worst[2];
+	for (INT warm = 0; warm < 2; warm++)
+	{
+		Allocator allocator(size);
+		if (warm)
+			allocator.Reserve(blocks);
+
+		long long total = 0;
+		worst[warm] = 0;
+		for (UINT i = 0; i < blocks; i++)
+		{
+			long long start = NowNs();
+			held[i] = allocator.Allocate(size);
+			*static_cast<volatile CHAR*>(held[i]) = 1;
+			long long latency = NowNs() - start;
+			total += latency;
+			if (latency > worst[warm])
+				worst[warm] = latency;
+		}
+		average[warm] = (double)total / blocks;
+		for (void* block : held)
+			allocator.Deallocate(block);
+	}
+	std::cout << "First allocations: cold avg " << average[0] << " ns max " << worst[0]
+		<< " ns, after Reserve() avg " << average[1] << " ns max " << worst[1] << " ns" << std::endl;
+}
+
+static const INT HUGE_BENCH_MESSAGES = 2000000;
+static const UINT HUGE_BENCH_DEPTH = 200000;
+static const size_t HUGE_BENCH_SIZE = 256;
+
+/// A queued message linked to the next, as in an intrusive message queue.
+struct PoolMsg
+{
+	PoolMsg* pNext;
+	INT data;
+};
+
+/// Dispatch messages through a deep FIFO queue of pool blocks in random address order, 
+/// as a WorkerThread does once the pool has been churned by many threads. Each dispatch 
+/// pops the oldest message, frees it and queues a new one; the pop depends on the 
+/// previous message, so TLB and cache misses are not overlapped.
+/// @return Messages per second.
+static double PoolDispatch(Allocator& pool)
+{
+	// Shuffle the free-list so that consecutive messages are far apart
+	pool.Reserve(HUGE_BENCH_DEPTH);
+	std::vector<void*> blocks(HUGE_BENCH_DEPTH);
+	for (UINT i = 0; i < HUGE_BENCH_DEPTH; i++)
+		blocks[i] = pool.Allocate(HUGE_BENCH_SIZE);
+	for (UINT i = HUGE_BENCH_DEPTH - 1; i > 0; i--)
+		std::swap(blocks[i], blocks[rand() % (i + 1)]);
+	for (UINT i = 0; i < HUGE_BENCH_DEPTH; i++)
+		pool.Deallocate(blocks[i]);
+
+	PoolMsg* pHead = NULL;
+	PoolMsg* pTail = NULL;
+	for (UINT i = 0; i < HUGE_BENCH_DEPTH; i++)
+	{
+		PoolMsg* pMsg = static_cast<PoolMsg*>(pool.Allocate(HUGE_BENCH_SIZE));
+		pMsg->pNext = NULL;
+		pMsg->data = (INT)i;
+		if (pTail)
+			pTail->pNext = pMsg;
+		else
+			pHead = pMsg;
+		pTail = pMsg;
+	}
+
+	INT sum = 0;
+	long long start = NowNs();
+	for (INT i = 0; i < HUGE_BENCH_MESSAGES; i++)
+	{
+		PoolMsg* pMsg = pHead;
+		pHead = pMsg->pNext;
+		sum += pMsg->data;
+		pool.Deallocate(pMsg);
+
+		pMsg = static_cast<PoolMsg*>(pool.Allocate(HUGE_BENCH_SIZE));
+		pMsg->pNext = NULL;
+		pMsg->data = i + sum;
+		pTail->pNext = pMsg;
+		pTail = pMsg;
+	}
+	double seconds = (NowNs() - start) / 1e9;
+
+	while (pHead)
+	{
+		PoolMsg* pNext = pHead->pNext;
+		pool.Deallocate(pHead);
+		pHead = pNext;
+	}
+	return HUGE_BENCH_MESSAGES / seconds;
+}
+
+/// Compare pool dispatch throughput with ordinary and huge page pool memory.
+static void HugePageBenchmark()
+{
+	Allocator pagePool(HUGE_BENCH_SIZE, HUGE_BENCH_DEPTH, NULL, "PagePool");
+	Allocator hugePool(HUGE_BENCH_SIZE, HUGE_BENCH_DEPTH, NULL, "HugePool", 0, Allocator::HUGE_PAGES);
+	double pages = PoolDispatch(pagePool);
+	double huge = PoolDispatch(hugePool);
+	std::cout << "Pool dispatch: 4K pages " << (long long)pages << " msgs/s, huge pages "
+		<< (long long)huge << " msgs/s" << (hugePool.GetHugePages() ? "" : " (huge pages unavailable)")
+		<< std::endl;
+}
+
+#if USE_STD_THREADS
+static const INT ARENA_BENCH_MESSAGES = 1000000;
+static std::atomic<INT> arenaBenchCount(0);
+
+static void ArenaBenchRecv(INT a, INT b)
+{
+	arenaBenchCount++;
+}
+
+/// Dispatch ARENA_BENCH_MESSAGES async delegate messages to a WorkerThread.
+/// @param[in] allocator - the delegate allocator, or nullptr for the default.
+/// @return Messages per second, from the first send until the last is processed.
+static double AsyncDispatch(WorkerThread& thread, IDelegateAllocator* allocator = nullptr)
+{
+	thread.CreateThread();
+	DelegateFreeAsync<void(INT, INT)> delegate(&ArenaBenchRecv, thread, allocator);
+	arenaBenchCount = 0;
+	long long start = NowNs();
+	for (INT i = 0; i < ARENA_BENCH_MESSAGES; i++)
+		delegate(i, i);
+	while (arenaBenchCount < ARENA_BENCH_MESSAGES)
+		std::this_thread::yield();
+	double seconds = (NowNs() - start) / 1e9;
+	thread.ExitThread();
+	return ARENA_BENCH_MESSAGES / seconds;
+}
+
+/// Compare async delegate throughput with heap and per-thread arena messages.
+static void MessageArenaBenchmark()
+{
+	WorkerThread heapThread("HeapBenchThread");
+	WorkerThread arenaThread("ArenaBenchThread");
+	arenaThread.EnableMessageArena(64 * 1024, 64);
+	double heap = AsyncDispatch(heapThread);
+	double arena = AsyncDispatch(arenaThread);
+	std::cout << "Async dispatch: heap messages " << (long long)heap << " msgs/s, arena messages "
+		<< (long long)arena << " msgs/s (" << arenaThread.GetMessageArena()->GetFailedAllocations()
+		<< " heap fallbacks)" << std::endl;
+}
+
+/// Compare async delegate throughput with default allocation, a DelegatePoolAllocator
+/// of power of two pools and one with pools sized by DelegatePoolSizes.
+static void DelegateAllocatorBenchmark()
+{
+	typedef DelegatePoolSizes<void(INT, INT)> BenchPools;
+	WorkerThread heapThread("HeapBenchThread");
+	WorkerThread poolThread("PoolBenchThread");
+	WorkerThread exactThread("ExactBenchThread");
+	DelegatePoolAllocator pool("BenchPool");
+	DelegatePoolAllocator exactPool(BenchPools::BlockSizes, BenchPools::Count, 0, "ExactBenchPool");
+	double heap = AsyncDispatch(heapThread);
+	double pooled = AsyncDispatch(poolThread, &pool);
+	double exact = AsyncDispatch(exactThread, &exactPool);
+	std::cout << "Async dispatch: default allocation " << (long long)heap << " msgs/s, DelegatePoolAllocator "
+		<< (long long)pooled << " msgs/s " << pool.GetWastedBytes() / ARENA_BENCH_MESSAGES 
+		<< " bytes/msg wasted, DelegatePoolSizes pools " << (long long)exact << " msgs/s "
+		<< exactPool.GetWastedBytes() / ARENA_BENCH_MESSAGES << " bytes/msg wasted" << std::endl;
+}
+#endif
+
+static const INT TIMER_BENCH_TIMERS = 1000000;
+static const INT TIMER_BENCH_MS = 1000;
+static std::atomic<INT> timerBenchExpired(0);
+
+static void TimerBenchExpired() { timerBenchExpired++; }
+
+/// Measure Timer start, stop and expiry processing cost with a million active timers.
+static void TimerWheelBenchmark()
+{
+	std::vector<Timer> timers(TIMER_BENCH_TIMERS);
+	for (Timer& timer : timers)
+		timer.Expired = MakeDelegate(&TimerBenchExpired);
+
+	// Timeouts spread from 1 ms to 10 s
+	unsigned long seed = 1;
+	long long start = NowNs();
+	for (Timer& timer : timers)
+	{
+		seed = seed * 1103515245 + 12345;
+		timer.Start((seed >> 8) % 10000 + 1);
+	}
+	long long started = NowNs() - start;
+
+	// Service the timers every millisecond
+	long long processing = 0;
+	INT calls = 0;
+	start = NowNs();
+	while (NowNs() - start < TIMER_BENCH_MS * 1000000LL)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		long long before = NowNs();
+		Timer::ProcessTimers();
+		processing += NowNs() - before;
+		calls++;
+	}
+
+	start = NowNs();
+	for (Timer& timer : timers)
+		timer.Stop();
+	long long stopped = NowNs() - start;
+
+	std::cout << "Timer wheel " << TIMER_BENCH_TIMERS << " timers: start " << started / TIMER_BENCH_TIMERS 
+		<< " ns, stop " << stopped / TIMER_BENCH_TIMERS << " ns, ProcessTimers " << processing / calls / 1000 
+		<< " us avg, " << timerBenchExpired.load() * 1000LL / TIMER_BENCH_MS << " expirations/s" << std::endl;
+}
+
+void DelegateBenchmarks()
+{
+#if defined(__linux__)
+	// Forks, so runs before the other benchmarks start threads
+	ShmTransportBenchmark();
+#endif
+	AllocatorProducerConsumerBenchmark();
+	ThreadSafeAllocatorBenchmark();
+	XallocatorSizeBenchmark();
+	AllocatorReserveBenchmark();
+	HugePageBenchmark();
+	TimerWheelBenchmark();
+#if USE_STD_THREADS
+	MessageArenaBenchmark();
+	DelegateAllocatorBenchmark();
+#endif
+#if defined(__linux__)
+	RecordReplayBenchmark();
+#endif
+}
+
+#endif // DELEGATE_BENCHMARKS
@@ -0,0 +1,161 @@
+#ifndef _DELEGATE_BUFFER_H
+#define _DELEGATE_BUFFER_H
+
+// DelegateBuffer.h
+// @see https://github.com/endurodave/AsyncMulticastDelegateCpp11
+
+#include <iostream>
+#include <streambuf>
+#include <vector>
+#include <stddef.h>
+
+namespace DelegateLib {
+
+/// @brief A std::streambuf over contiguous memory. Output is appended to an internal
+/// buffer that keeps its capacity across Reset() calls, so a reused buffer stops
+/// allocating once it has grown to the largest message. Input reads either the
+/// internal buffer or an external read-only span without copying the bytes.
+class DelegateStreamBuf : public std::streambuf
+{
+public:
+    /// Constructor for a writable buffer.
+    DelegateStreamBuf() { Reset(); }
+
+    /// Constructor for a read-only view of external bytes.
+    /// @param[in] data - the external bytes. Must outlive the stream buffer.
+    /// @param[in] size - the number of bytes.
+    DelegateStreamBuf(const char* data, size_t size) { View(data, size); }
+
+    /// Discard the contents and make the buffer writable. Capacity is retained.
+    void Reset() {
+        m_external = false;
+        if (m_storage.empty())
+            m_storage.resize(INITIAL_SIZE);
+        char* base = &m_storage[0];
+        setp(base, base + m_storage.size());
+        setg(base, base, base);
+    }
+
+    /// Read an external span of bytes without copying.
+    /// @param[in] data - the external bytes. Must outlive the view.
+    /// @param[in] size - the number of bytes.
+    void View(const char* data, size_t size) {
+        m_external = true;
+        char* p = const_cast<char*>(data);
+        setp(nullptr, nullptr);
+        setg(p, p, p + size);
+    }
+
+    /// Get a pointer to the first byte.
+    const char* Data() const { return m_external ? eback() : pbase(); }
+
+    /// Get the number of bytes written (or viewed).
+    size_t Size() const { return m_external ? egptr() - eback() : pptr() - pbase(); }
+
+protected:
+    virtual int_type overflow(int_type ch) override {
+        if (m_external)
+            return traits_type::eof();
+
+        // Grow the storage and rebase the put and get areas
+        size_t size = pptr() - pbase();
+        size_t getPos = gptr() - eback();
+        m_storage.resize(m_storage.size() * 2);
+        char* base = &m_storage[0];
+        setp(base, base + m_storage.size());
+        pbump(static_cast<int>(size));
+        setg(base, base + getPos, base + size);
+
+        if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+            *pptr() = traits_type::to_char_type(ch);
+            pbump(1);
+        }
+        return traits_type::not_eof(ch);
+    }
+
+    virtual int_type underflow() override {
+        SyncGetArea();
+        return gptr() < egptr() ? traits_type::to_int_type(*gptr()) : traits_type::eof();
+    }
+
+    virtual pos_type seekoff(off_type off, std::ios_base::seekdir dir,
+        std::ios_base::openmode which = std::ios_base::in | std::ios_base::out) override {
+        const pos_type error = pos_type(off_type(-1));
+        off_type size = static_cast<off_type>(Size());
+
+        if (which & std::ios_base::in) {
+            SyncGetArea();
+            off_type pos = off + (dir == std::ios_base::beg ? 0 :
+                dir == std::ios_base::cur ? gptr() - eback() : size);
+            if (pos < 0 || pos > size)
+                return error;
+            setg(eback(), eback() + pos, egptr());
+            return pos_type(pos);
+        }
+        if ((which & std::ios_base::out) && !m_external) {
+            off_type pos = off + (dir == std::ios_base::beg ? 0 : size);
+            if (pos < 0 || pos > size)
+                return error;
+            setp(pbase(), epptr());
+            pbump(static_cast<int>(pos));
+            return pos_type(pos);
+        }
+        return error;
+    }
+
+    virtual pos_type seekpos(pos_type pos,
+        std::ios_base::openmode which = std::ios_base::in | std::ios_base::out) override {
+        return seekoff(off_type(pos), std::ios_base::beg, which);
+    }
+
+private:
+    /// Extend the readable region to include everything written so far.
+    void SyncGetArea() {
+        if (!m_external && pptr() > egptr())
+            setg(eback(), gptr(), pptr());
+    }
+
+    static const size_t INITIAL_SIZE = 256;
+
+    std::vector<char> m_storage;
+    bool m_external = false;
+};
+
+/// @brief A std::iostream over a DelegateStreamBuf. Remote delegates serialize
+/// arguments into a DelegateBufferStream and the transport sends Data()/Size()
+/// directly, without first extracting the bytes into another buffer.
+class DelegateBufferStream : public std::iostream
+{
+public:
+    /// Constructor for a writable, reusable buffer.
+    DelegateBufferStream() : std::iostream(nullptr) { rdbuf(&m_buf); }
+
+    /// Constructor for a read-only view of received bytes.
+    /// @param[in] data - the received bytes. Must outlive the stream.
+    /// @param[in] size - the number of bytes.
+    DelegateBufferStream(const char* data, size_t size) :
+        std::iostream(nullptr), m_buf(data, size) { rdbuf(&m_buf); }
+
+    /// Discard the contents and clear the stream state. Capacity is retained.
+    void Reset() { m_buf.Reset(); clear(); }
+
+    /// Read an external span of bytes without copying.
+    void View(const char* data, size_t size) { m_buf.View(data, size); clear(); }
+
+    /// Get a pointer to the serialized bytes.
+    const char* Data() const { return m_buf.Data(); }
+
+    /// Get the number of serialized bytes.
+    size_t Size() const { return m_buf.Size(); }
+
+private:
+    // Prevent copying objects
+    DelegateBufferStream(const DelegateBufferStream&) = delete;
+    DelegateBufferStream& operator=(const DelegateBufferStream&) = delete;
+
+    DelegateStreamBuf m_buf;
+};
+
+}
+
+#endif
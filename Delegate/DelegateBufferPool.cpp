@@ -0,0 +1,94 @@
+#include "DelegateBufferPool.h"
+#include <atomic>
+#include <stdint.h>
+
+namespace DelegateLib 
+{
+    // Free list of pooled buffers as a Treiber stack of indices. The head packs a 
+    // modification tag in the upper 32 bits with index + 1 in the lower 32 bits 
+    // (0 is empty); the tag changes on every push so a stale pop cannot succeed 
+    // after the same index is popped and pushed back (ABA). 
+    struct BufferPool
+    {
+        BufferPool() : head(1)
+        {
+            for (uint32_t i = 0; i < DELEGATE_SEND_BUFFER_POOL_SIZE; i++)
+                next[i].store(i + 1 < DELEGATE_SEND_BUFFER_POOL_SIZE ? i + 2 : 0, std::memory_order_relaxed);
+        }
+
+        DelegateBufferStream buffers[DELEGATE_SEND_BUFFER_POOL_SIZE];
+        std::atomic<uint32_t> next[DELEGATE_SEND_BUFFER_POOL_SIZE];
+        std::atomic<uint64_t> head;
+    };
+
+    static BufferPool& GetPool()
+    {
+        static BufferPool pool;
+        return pool;
+    }
+
+    //------------------------------------------------------------------------------
+    // Acquire
+    //------------------------------------------------------------------------------
+    DelegateBufferStream* DelegateBufferPool::Acquire()
+    {
+        BufferPool& pool = GetPool();
+        uint64_t head = pool.head.load(std::memory_order_acquire);
+        for (;;)
+        {
+            uint32_t top = (uint32_t)head;
+            if (top == 0)
+            {
+                // Pool exhausted. Increase DELEGATE_SEND_BUFFER_POOL_SIZE if frequent.
+                return new DelegateBufferStream();
+            }
+
+            uint64_t newHead = (head & 0xFFFFFFFF00000000ull) | pool.next[top - 1].load(std::memory_order_relaxed);
+            if (pool.head.compare_exchange_weak(head, newHead, std::memory_order_acquire, std::memory_order_acquire))
+            {
+                DelegateBufferStream* buffer = &pool.buffers[top - 1];
+                buffer->Reset();
+                return buffer;
+            }
+        }
+    }
+
+    //------------------------------------------------------------------------------
+    // Release
+    //------------------------------------------------------------------------------
+    void DelegateBufferPool::Release(DelegateBufferStream* buffer)
+    {
+        BufferPool& pool = GetPool();
+        if (buffer < &pool.buffers[0] || buffer >= &pool.buffers[DELEGATE_SEND_BUFFER_POOL_SIZE])
+        {
+            delete buffer;
+            return;
+        }
+
+        uint32_t index = (uint32_t)(buffer - &pool.buffers[0]);
+        uint64_t head = pool.head.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            pool.next[index].store((uint32_t)head, std::memory_order_relaxed);
+            uint64_t newHead = ((head >> 32) + 1) << 32 | (index + 1);
+            if (pool.head.compare_exchange_weak(head, newHead, std::memory_order_release, std::memory_order_relaxed))
+                return;
+        }
+    }
+
+    //------------------------------------------------------------------------------
+    // GetFreeCount
+    //------------------------------------------------------------------------------
+    int DelegateBufferPool::GetFreeCount()
+    {
+        BufferPool& pool = GetPool();
+        int count = 0;
+        uint32_t top = (uint32_t)pool.head.load(std::memory_order_acquire);
+        while (top != 0 && count < DELEGATE_SEND_BUFFER_POOL_SIZE)
+        {
+            count++;
+            top = pool.next[top - 1].load(std::memory_order_relaxed);
+        }
+        return count;
+    }
+}
@@ -0,0 +1,33 @@
+#ifndef _DELEGATE_BUFFER_POOL_H
+#define _DELEGATE_BUFFER_POOL_H
+
+// DelegateBufferPool.h
+// @see https://github.com/endurodave/AsyncMulticastDelegateCpp11
+
+#include "DelegateOpt.h"
+#include "DelegateBuffer.h"
+
+namespace DelegateLib {
+
+/// @brief A process wide lock-free pool of serialization buffers used by
+/// DelegateRemoteSend. Each send acquires its own buffer, so concurrent sends
+/// never share one. A buffer keeps its capacity when released, so once the pool
+/// has warmed up sends do not allocate. If every pooled buffer is in use,
+/// Acquire() falls back to a heap buffer that Release() deletes.
+class DelegateBufferPool
+{
+public:
+    /// Get an empty buffer. Never blocks.
+    /// @return A buffer that must be returned with Release().
+    static DelegateBufferStream* Acquire();
+
+    /// Return a buffer obtained from Acquire().
+    static void Release(DelegateBufferStream* buffer);
+
+    /// Get the number of buffers on the free list. Approximate while sends are in progress.
+    static int GetFreeCount();
+};
+
+}
+
+#endif
@@ -10,6 +10,12 @@
 #include "DelegateAsyncWait.h"
 #include "DelegateRemoteSend.h"
 #include "DelegateRemoteRecv.h"
+#include "DelegateRemoteRecvAsync.h"
+#include "DelegateRemoteBatch.h"
+#include "DelegateRemoteRequest.h"
+#include "DelegateRemoteMulticast.h"
+#include "DelegateSerialize.h"
 #include "DelegateSpAsync.h"
+#include "DelegatePoolSizes.h"
 
 #endif
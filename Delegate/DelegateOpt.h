@@ -39,4 +39,29 @@
 // @see https://github.com/endurodave/xallocator
 //#define USE_XALLOCATOR 
 
+// Initial size of the DelegateRemoteInvoker id table. The table is rebuilt before 
+// registered and removed ids fill three quarters of it, doubling in size while the 
+// registered ids would fill more than half. Must be a power of two of at least 2.
+#ifndef DELEGATE_REMOTE_TABLE_SIZE
+	#define DELEGATE_REMOTE_TABLE_SIZE 256
+#endif
+
+// Number of serialization buffers DelegateRemoteSend keeps in DelegateBufferPool. 
+// Size to the number of threads sending remote delegates at the same time.
+#ifndef DELEGATE_SEND_BUFFER_POOL_SIZE
+	#define DELEGATE_SEND_BUFFER_POOL_SIZE 16
+#endif
+
+// Default largest frame in bytes a stream transport accepts from its peer. A longer 
+// frame length is treated as a corrupt stream and the connection is dropped.
+#ifndef DELEGATE_REMOTE_MAX_FRAME_SIZE
+	#define DELEGATE_REMOTE_MAX_FRAME_SIZE (1024 * 1024)
+#endif
+
+// Default limit in bytes on messages a stream transport queues for a peer that is 
+// not reading. A message sent while the queue is past the limit is dropped.
+#ifndef DELEGATE_REMOTE_MAX_SEND_QUEUE_SIZE
+	#define DELEGATE_REMOTE_MAX_SEND_QUEUE_SIZE (4 * 1024 * 1024)
+#endif
+
 #endif
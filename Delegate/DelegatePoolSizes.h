@@ -0,0 +1,189 @@
+#ifndef _DELEGATE_POOL_SIZES_H
+#define _DELEGATE_POOL_SIZES_H
+
+// DelegatePoolSizes.h
+// @see https://github.com/endurodave/AsyncMulticastDelegateCpp11
+
+#include "DelegateAsync.h"
+#include "DelegateAllocator.h"
+#include <memory>
+#include <type_traits>
+
+namespace DelegateLib {
+
+/// @brief Size of the one allocation std::allocate_shared makes for a T through
+/// DelegateAllocatorAdapter: the shared_ptr reference counts, the allocator and
+/// the object. Follows the libstdc++, libc++ and MSVC control block layouts. The
+/// unit tests check it against the standard library they are built with; on any
+/// other library the size is an estimate and DelegatePoolAllocator rounds a
+/// mismatched request up to a larger pool or the heap.
+template <class T>
+struct DelegateSharedSize
+{
+#if defined(_LIBCPP_VERSION)
+	typedef long CountType;
+#else
+	typedef int CountType;
+#endif
+	struct Block
+	{
+		void* vtable;
+		CountType uses;
+		CountType weaks;
+		DelegateAllocatorAdapter<T> allocator;
+		typename std::aligned_storage<sizeof(T), alignof(T)>::type object;
+	};
+	static constexpr size_t value = sizeof(Block);
+};
+
+/// @brief Sizes of the argument copies DelegateParam makes for a parameter type.
+/// Pass by value parameters are not copied.
+template <class Param>
+struct DelegateParamSizes { static constexpr size_t first = 0, second = 0; };
+
+template <class Param>
+struct DelegateParamSizes<Param*> { static constexpr size_t first = sizeof(Param), second = 0; };
+
+template <class Param>
+struct DelegateParamSizes<Param**> { static constexpr size_t first = sizeof(Param*), second = sizeof(Param); };
+
+template <class Param>
+struct DelegateParamSizes<Param&> { static constexpr size_t first = sizeof(Param), second = 0; };
+
+/// @brief The message type an asynchronous delegate sends for its parameters.
+template <class... Params> struct DelegateMsgType;
+template <> struct DelegateMsgType<> { typedef DelegateMsgBase Type; };
+template <class P1> struct DelegateMsgType<P1> { typedef DelegateMsg1<P1> Type; };
+template <class P1, class P2> struct DelegateMsgType<P1, P2> { typedef DelegateMsg2<P1, P2> Type; };
+template <class P1, class P2, class P3> struct DelegateMsgType<P1, P2, P3> { typedef DelegateMsg3<P1, P2, P3> Type; };
+template <class P1, class P2, class P3, class P4> struct DelegateMsgType<P1, P2, P3, P4> { typedef DelegateMsg4<P1, P2, P3, P4> Type; };
+template <class P1, class P2, class P3, class P4, class P5> struct DelegateMsgType<P1, P2, P3, P4, P5> { typedef DelegateMsg5<P1, P2, P3, P4, P5> Type; };
+
+/// A list of allocation sizes. Zero entries are ignored.
+template <size_t... Sizes> struct DelegateSizeList { };
+
+/// @brief The allocation sizes of one asynchronous delegate invocation made with an
+/// IDelegateAllocator: the message, the delegate clone and the argument copies.
+/// The signature is written as for DelegateFreeAsync, e.g. void(int, const Data&), or
+/// as for DelegateMemberAsync, e.g. void(MyClass(int, const Data&)).
+template <class Signature>
+struct DelegateAsyncSizes;
+
+template <class... Params>
+struct DelegateAsyncSizes<void(Params...)>
+{
+	typedef DelegateFreeAsync<void(Params...)> ClassType;
+	typedef DelegateSizeList<
+		DelegateSharedSize<typename DelegateMsgType<Params...>::Type>::value,
+		DelegateSharedSize<ClassType>::value,
+		DelegateParamSizes<Params>::first...,
+		DelegateParamSizes<Params>::second...> Sizes;
+};
+
+template <class TClass, class... Params>
+struct DelegateAsyncSizes<void(TClass(Params...))>
+{
+	typedef DelegateMemberAsync<void(TClass(Params...))> ClassType;
+	typedef DelegateSizeList<
+		DelegateSharedSize<typename DelegateMsgType<Params...>::Type>::value,
+		DelegateSharedSize<ClassType>::value,
+		DelegateParamSizes<Params>::first...,
+		DelegateParamSizes<Params>::second...> Sizes;
+};
+
+/// Concatenate DelegateSizeList types.
+template <class... Lists> struct DelegateSizeListJoin;
+
+template <size_t... Sizes>
+struct DelegateSizeListJoin<DelegateSizeList<Sizes...>> { typedef DelegateSizeList<Sizes...> Type; };
+
+template <size_t... Sizes1, size_t... Sizes2, class... Lists>
+struct DelegateSizeListJoin<DelegateSizeList<Sizes1...>, DelegateSizeList<Sizes2...>, Lists...> {
+	typedef typename DelegateSizeListJoin<DelegateSizeList<Sizes1..., Sizes2...>, Lists...>::Type Type; };
+
+/// Get the smallest size greater than above, or 0 if there is none.
+constexpr size_t DelegateNextSize(size_t, size_t best) { return best; }
+
+template <class... Sizes>
+constexpr size_t DelegateNextSize(size_t above, size_t best, size_t size, Sizes... sizes) {
+	return DelegateNextSize(above, size > above && (best == 0 || size < best) ? size : best, sizes...); }
+
+/// Get the number of distinct non-zero sizes greater than above.
+template <class... Sizes>
+constexpr size_t DelegateCountSizes(size_t above, Sizes... sizes) {
+	return DelegateNextSize(above, 0, sizes...) == 0 ? 0 :
+		1 + DelegateCountSizes(DelegateNextSize(above, 0, sizes...), sizes...); }
+
+/// Get the distinct non-zero size at index in increasing order.
+template <class... Sizes>
+constexpr size_t DelegateNthSize(size_t index, size_t above, Sizes... sizes) {
+	return index == 0 ? DelegateNextSize(above, 0, sizes...) :
+		DelegateNthSize(index - 1, DelegateNextSize(above, 0, sizes...), sizes...); }
+
+template <size_t... Indices> struct DelegateIndexList { };
+
+template <size_t N, size_t... Indices>
+struct DelegateMakeIndexList { typedef typename DelegateMakeIndexList<N - 1, N - 1, Indices...>::Type Type; };
+
+template <size_t... Indices>
+struct DelegateMakeIndexList<0, Indices...> { typedef DelegateIndexList<Indices...> Type; };
+
+template <class IndexList, class SizeList>
+struct DelegatePoolTable;
+
+template <size_t... Indices, size_t... Sizes>
+struct DelegatePoolTable<DelegateIndexList<Indices...>, DelegateSizeList<Sizes...>>
+{
+	static constexpr size_t BlockSizes[sizeof...(Indices)] = { DelegateNthSize(Indices, 0, Sizes...)... };
+};
+
+template <size_t... Indices, size_t... Sizes>
+constexpr size_t DelegatePoolTable<DelegateIndexList<Indices...>, DelegateSizeList<Sizes...>>::BlockSizes[sizeof...(Indices)];
+
+template <class SizeList>
+struct DelegatePoolConfig;
+
+template <size_t... Sizes>
+struct DelegatePoolConfig<DelegateSizeList<Sizes...>> :
+	DelegatePoolTable<typename DelegateMakeIndexList<DelegateCountSizes(0, Sizes...)>::Type, DelegateSizeList<Sizes...>>
+{
+	/// The number of pools.
+	static constexpr UINT Count = (UINT)DelegateCountSizes(0, Sizes...);
+
+	/// The largest block size.
+	static constexpr size_t MaxBlockSize = DelegateNthSize(Count - 1, 0, Sizes...);
+
+	/// Check whether a request size has a pool of exactly that block size.
+	static constexpr bool HasBlockSize(size_t size) { return Contains(size, Sizes...); }
+
+private:
+	static constexpr bool Contains(size_t) { return false; }
+
+	template <class... Rest>
+	static constexpr bool Contains(size_t size, size_t first, Rest... rest) {
+		return (size != 0 && size == first) || Contains(size, rest...); }
+};
+
+/// @brief Compile-time pool configuration for a list of asynchronous delegate
+/// signatures. Collects the size of every allocation an invocation makes through
+/// an IDelegateAllocator (the allocate_shared blocks of the message and delegate
+/// clone, and the DelegateParam argument copies) and provides them as constexpr,
+/// distinct and in increasing order, so that each allocation fits a pool block
+/// exactly. For example:
+///
+/// typedef DelegatePoolSizes<void(int, const Data&), void(MyClass(Data*))> AppPools;
+/// DelegatePoolAllocator pool(AppPools::BlockSizes, AppPools::Count, 64, "AppPools");
+/// auto delegate = MakeDelegate(&myClass, &MyClass::Func, thread, pool);
+///
+/// A free function signature whose only parameter is a function pointer reads as
+/// a member signature and is not supported.
+template <class... Signatures>
+struct DelegatePoolSizes :
+	DelegatePoolConfig<typename DelegateSizeListJoin<typename DelegateAsyncSizes<Signatures>::Sizes...>::Type>
+{
+	static_assert(sizeof...(Signatures) > 0, "At least one delegate signature required");
+};
+
+}
+
+#endif
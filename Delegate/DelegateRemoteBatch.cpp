@@ -0,0 +1,189 @@
+#include "DelegateRemoteBatch.h"
+#include <cstdint>
+#include <cstring>
+
+using namespace std::chrono;
+
+namespace DelegateLib
+{
+    //------------------------------------------------------------------------------
+    // DelegateRemoteBatch
+    //------------------------------------------------------------------------------
+    DelegateRemoteBatch::DelegateRemoteBatch(IDelegateBufferTransport& transport, size_t maxBytes, int maxLatency) :
+        m_transport(transport), m_maxBytes(maxBytes), m_maxLatency(maxLatency), m_exit(false)
+    {
+        LockGuard::Create(&m_lock);
+        m_wake.Create();
+    }
+
+    //------------------------------------------------------------------------------
+    // ~DelegateRemoteBatch
+    //------------------------------------------------------------------------------
+    DelegateRemoteBatch::~DelegateRemoteBatch()
+    {
+        if (m_thread)
+        {
+            {
+                LockGuard lockGuard(&m_lock);
+                m_exit = true;
+            }
+            m_wake.Signal();
+            m_thread->join();
+            m_thread = nullptr;
+        }
+
+        Flush();
+        LockGuard::Destroy(&m_lock);
+    }
+
+    //------------------------------------------------------------------------------
+    // DispatchDelegate
+    //------------------------------------------------------------------------------
+    void DelegateRemoteBatch::DispatchDelegate(const char* data, size_t size)
+    {
+        LockGuard lockGuard(&m_lock);
+
+        // A new frame arms the flush thread with its deadline
+        bool first = (m_frame.Size() == 0);
+        if (first)
+            m_firstTime = steady_clock::now();
+
+        // Append the length prefixed sub-message
+        uint32_t length = static_cast<uint32_t>(size);
+        m_frame.write(reinterpret_cast<const char*>(&length), sizeof(length));
+        m_frame.write(data, size);
+
+        if (m_frame.Size() >= m_maxBytes || DeadlineExpired())
+            FlushLocked();
+        else if (first && m_maxLatency > 0)
+        {
+            StartFlushThread();
+            m_wake.Signal();
+        }
+    }
+
+    //------------------------------------------------------------------------------
+    // Flush
+    //------------------------------------------------------------------------------
+    void DelegateRemoteBatch::Flush()
+    {
+        LockGuard lockGuard(&m_lock);
+        FlushLocked();
+    }
+
+    //------------------------------------------------------------------------------
+    // Poll
+    //------------------------------------------------------------------------------
+    void DelegateRemoteBatch::Poll()
+    {
+        LockGuard lockGuard(&m_lock);
+        if (DeadlineExpired())
+            FlushLocked();
+    }
+
+    //------------------------------------------------------------------------------
+    // SetWindow
+    //------------------------------------------------------------------------------
+    void DelegateRemoteBatch::SetWindow(size_t maxBytes, int maxLatency)
+    {
+        LockGuard lockGuard(&m_lock);
+        m_maxBytes = maxBytes;
+        m_maxLatency = maxLatency;
+
+        // Rearm a pending frame with the new deadline
+        if (m_frame.Size() != 0 && m_maxLatency > 0)
+        {
+            StartFlushThread();
+            m_wake.Signal();
+        }
+    }
+
+    //------------------------------------------------------------------------------
+    // FlushLocked
+    //------------------------------------------------------------------------------
+    void DelegateRemoteBatch::FlushLocked()
+    {
+        if (m_frame.Size() == 0)
+            return;
+        m_transport.DispatchDelegate(m_frame.Data(), m_frame.Size());
+        m_frame.Reset();
+    }
+
+    //------------------------------------------------------------------------------
+    // DeadlineExpired
+    //------------------------------------------------------------------------------
+    bool DelegateRemoteBatch::DeadlineExpired() const
+    {
+        if (m_maxLatency <= 0 || m_frame.Size() == 0)
+            return false;
+        return steady_clock::now() - m_firstTime >= milliseconds(m_maxLatency);
+    }
+
+    //------------------------------------------------------------------------------
+    // TimeToDeadline
+    //------------------------------------------------------------------------------
+    int DelegateRemoteBatch::TimeToDeadline() const
+    {
+        if (m_maxLatency <= 0 || m_frame.Size() == 0)
+            return -1;
+        long long remaining = duration_cast<microseconds>(
+            m_firstTime + milliseconds(m_maxLatency) - steady_clock::now()).count();
+        return (remaining > 0) ? static_cast<int>((remaining + 999) / 1000) : 0;
+    }
+
+    //------------------------------------------------------------------------------
+    // StartFlushThread
+    //------------------------------------------------------------------------------
+    void DelegateRemoteBatch::StartFlushThread()
+    {
+        if (!m_thread)
+            m_thread = std::unique_ptr<std::thread>(new std::thread(&DelegateRemoteBatch::FlushThread, this));
+    }
+
+    //------------------------------------------------------------------------------
+    // FlushThread
+    //------------------------------------------------------------------------------
+    void DelegateRemoteBatch::FlushThread()
+    {
+        for (;;)
+        {
+            int timeout;
+            {
+                LockGuard lockGuard(&m_lock);
+                if (m_exit)
+                    return;
+                if (DeadlineExpired())
+                    FlushLocked();
+                timeout = TimeToDeadline();
+            }
+
+            // A signal sent since the deadline was read is kept, so a new frame or 
+            // window is never missed
+            m_wake.Wait(timeout);
+        }
+    }
+
+    //------------------------------------------------------------------------------
+    // Invoke
+    //------------------------------------------------------------------------------
+    int DelegateRemoteBatch::Invoke(const char* data, size_t size)
+    {
+        int count = 0;
+        size_t offset = 0;
+        while (offset < size)
+        {
+            uint32_t length;
+            if (size - offset < sizeof(length))
+                return -1;
+            memcpy(&length, data + offset, sizeof(length));
+            offset += sizeof(length);
+
+            if (size - offset < length)
+                return -1;
+            if (DelegateRemoteInvoker::Invoke(data + offset, length))
+                count++;
+            offset += length;
+        }
+        return count;
+    }
+}
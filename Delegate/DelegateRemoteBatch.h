@@ -0,0 +1,97 @@
+#ifndef _DELEGATE_REMOTE_BATCH_H
+#define _DELEGATE_REMOTE_BATCH_H
+
+// DelegateRemoteBatch.h
+// @see https://github.com/endurodave/AsyncMulticastDelegateCpp11
+
+#include "DelegateTransport.h"
+#include "DelegateRemoteInvoker.h"
+#include "LockGuard.h"
+#include "Semaphore.h"
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <stddef.h>
+
+namespace DelegateLib {
+
+/// @brief A buffer transport that accumulates remote delegate invocations, possibly 
+/// for different delegate ids, into one frame and dispatches the frame to another 
+/// transport as a single send. The frame is flushed when it reaches the size limit, 
+/// once the oldest pending message reaches the latency limit, or explicitly with 
+/// Flush(). A latency limit starts a flush thread that sends the frame when its 
+/// deadline passes, even if no further sends arrive, so the transport must accept 
+/// DispatchDelegate() calls from that thread. The receiver passes each received 
+/// frame to DelegateRemoteBatch::Invoke(). 
+/// 
+/// Frame format: zero or more sub-messages, each a 32-bit host byte order length 
+/// followed by that many bytes of one serialized remote delegate invocation. 
+class DelegateRemoteBatch : public IDelegateBufferTransport
+{
+public:
+    /// Constructor
+    /// @param[in] transport - the transport that sends completed frames.
+    /// @param[in] maxBytes - flush once the frame holds at least this many bytes.
+    /// @param[in] maxLatency - flush once the oldest pending message is this many 
+    ///     milliseconds old. 0 flushes only on size or explicitly. 
+    DelegateRemoteBatch(IDelegateBufferTransport& transport, size_t maxBytes, int maxLatency);
+
+    /// Destructor. Stops the flush thread and flushes any pending messages. 
+    ~DelegateRemoteBatch();
+
+    /// Append a serialized invocation to the current frame. 
+    virtual void DispatchDelegate(const char* data, size_t size) override;
+
+    /// Send the current frame now, if not empty. 
+    void Flush();
+
+    /// Send the current frame if the latency limit has expired. The flush thread 
+    /// already does this; Poll() lets the caller flush on its own thread sooner. 
+    void Poll();
+
+    /// Change the batching window. 
+    void SetWindow(size_t maxBytes, int maxLatency);
+
+    /// Invoke each remote delegate contained within a received frame. 
+    /// @param[in] data - the received frame. 
+    /// @param[in] size - the number of frame bytes. 
+    /// @return The number of sub-messages invoked, or -1 if the frame is malformed. 
+    static int Invoke(const char* data, size_t size);
+
+private:
+    // Prevent copying objects
+    DelegateRemoteBatch(const DelegateRemoteBatch&) = delete;
+    DelegateRemoteBatch& operator=(const DelegateRemoteBatch&) = delete;
+
+    /// Send the frame. Caller must hold m_lock.
+    void FlushLocked();
+
+    /// True if the latency limit has expired. Caller must hold m_lock.
+    bool DeadlineExpired() const;
+
+    /// Milliseconds until the latency limit expires, rounded up. Caller must hold m_lock.
+    /// @return The wait time, or -1 if no frame is pending or there is no latency limit.
+    int TimeToDeadline() const;
+
+    /// Start the flush thread if a latency limit is set. Caller must hold m_lock.
+    void StartFlushThread();
+
+    /// Flush thread loop. Sleeps until the pending frame's deadline, or until 
+    /// woken by a new frame or window, and sends the frame once its deadline passes.
+    void FlushThread();
+
+    IDelegateBufferTransport& m_transport;
+    DelegateBufferStream m_frame;
+    size_t m_maxBytes;
+    int m_maxLatency;
+    std::chrono::steady_clock::time_point m_firstTime;
+    LOCK m_lock;
+
+    std::unique_ptr<std::thread> m_thread;
+    Semaphore m_wake;
+    bool m_exit;
+};
+
+}
+
+#endif
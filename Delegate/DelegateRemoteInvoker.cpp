@@ -1,23 +1,153 @@
 #include "DelegateRemoteInvoker.h"
+#include "DelegateBuffer.h"
 #include "Fault.h"
+#include <thread>
+
+static_assert(DELEGATE_REMOTE_TABLE_SIZE >= 2 && (DELEGATE_REMOTE_TABLE_SIZE & (DELEGATE_REMOTE_TABLE_SIZE - 1)) == 0, 
+    "DELEGATE_REMOTE_TABLE_SIZE must be a power of two of at least 2");
 
 namespace DelegateLib 
 {
-    DelegateRemoteInvoker::DelegateRemoteInvoker(DelegateIdType id) : m_id(id)
+    /// An Invoke() call in progress on this thread. 
+    struct InvokeFrame
+    {
+        DelegateRemoteInvoker* invoker;
+        bool destroyed;
+        InvokeFrame* prev;
+    };
+
+    static thread_local InvokeFrame* invokeFrames = nullptr;
+
+    static inline unsigned int Hash(DelegateIdType id, unsigned int shift)
+    {
+        // Fibonacci hashing spreads sequential ids across the table. The high bits 
+        // of the product are the well mixed ones.
+        return ((unsigned int)id * 2654435769u) >> shift;
+    }
+
+    DelegateRemoteInvoker::Slot* DelegateRemoteInvoker::Find(Table* table, DelegateIdType id)
+    {
+        unsigned int index = Hash(id, table->shift);
+        for (unsigned int probe = 0; probe < table->size; probe++)
+        {
+            Slot& slot = table->slots[index];
+            int state = slot.state.load(std::memory_order_acquire);
+            if (state == SLOT_EMPTY)
+                return nullptr;
+            if (state == SLOT_USED && slot.id.load(std::memory_order_relaxed) == id)
+                return &slot;
+            index = (index + 1) & (table->size - 1);
+        }
+        return nullptr;
+    }
+
+    void DelegateRemoteInvoker::Rebuild(unsigned int size)
+    {
+        Table* oldTable = GetTable().load();
+        Table* table = new Table(size);
+        if (oldTable)
+        {
+            // Copy the registered ids; the tombstones are dropped
+            for (unsigned int i = 0; i < oldTable->size; i++)
+            {
+                Slot& oldSlot = oldTable->slots[i];
+                if (oldSlot.state.load(std::memory_order_relaxed) != SLOT_USED)
+                    continue;
+                DelegateIdType id = oldSlot.id.load(std::memory_order_relaxed);
+                unsigned int index = Hash(id, table->shift);
+                while (table->slots[index].state.load(std::memory_order_relaxed) != SLOT_EMPTY)
+                    index = (index + 1) & (size - 1);
+                table->slots[index].id.store(id, std::memory_order_relaxed);
+                table->slots[index].invoker.store(oldSlot.invoker.load(), std::memory_order_relaxed);
+                table->slots[index].state.store(SLOT_USED, std::memory_order_relaxed);
+                table->used++;
+            }
+        }
+
+        // Publish the new table, then wait for readers still probing the old one. 
+        // A reader counts itself before checking the table is still current, so it 
+        // either sees the new table or is seen here.
+        GetTable().store(table);
+        if (oldTable)
+        {
+            while (oldTable->readers.load() != 0)
+                std::this_thread::yield();
+            delete oldTable;
+        }
+    }
+
+    DelegateRemoteInvoker::DelegateRemoteInvoker(DelegateIdType id) : m_id(id), m_readers(0)
     {
         LockGuard lockGuard(GetLock());
 
+        // Rebuild before used and deleted slots fill three quarters of the table, 
+        // doubling it once the registered ids fill half of it
+        Table* table = GetTable().load();
+        if (table == nullptr)
+            Rebuild(DELEGATE_REMOTE_TABLE_SIZE);
+        else if ((table->used + table->deleted + 1) * 4 > table->size * 3)
+        {
+            unsigned int size = table->size;
+            while ((table->used + 1) * 2 > size)
+                size *= 2;
+            Rebuild(size);
+        }
+        table = GetTable().load();
+
         // Don't allow duplicate entries
-        std::map<DelegateIdType, DelegateRemoteInvoker*>::iterator it = GetMap().find(m_id);
-        ASSERT_TRUE(it == GetMap().end());
+        ASSERT_TRUE(Find(table, m_id) == nullptr);
+
+        // Claim the first empty or deleted slot on the probe sequence. The rebuild 
+        // above guarantees there is one.
+        unsigned int index = Hash(m_id, table->shift);
+        while (table->slots[index].state.load(std::memory_order_relaxed) == SLOT_USED)
+            index = (index + 1) & (table->size - 1);
+        Slot* slot = &table->slots[index];
+        if (slot->state.load(std::memory_order_relaxed) == SLOT_DELETED)
+            table->deleted--;
+        table->used++;
 
-        GetMap()[m_id] = this;
+        slot->id.store(m_id, std::memory_order_relaxed);
+        slot->invoker.store(this);
+        slot->state.store(SLOT_USED, std::memory_order_release);
     }
 
-    DelegateRemoteInvoker::~DelegateRemoteInvoker()
+    void DelegateRemoteInvoker::Unregister()
     {
-        LockGuard lockGuard(GetLock());
-        GetMap().erase(m_id);
+        {
+            LockGuard lockGuard(GetLock());
+            Table* table = GetTable().load();
+            Slot* slot = table ? Find(table, m_id) : nullptr;
+
+            // Only the registered instance unregisters, once; a copy (e.g. Clone()) 
+            // never registered
+            DelegateRemoteInvoker* expected = this;
+            if (slot == nullptr || !slot->invoker.compare_exchange_strong(expected, nullptr))
+                return;
+            slot->state.store(SLOT_DELETED, std::memory_order_release);
+            table->used--;
+            table->deleted++;
+
+            // Wait for any Invoke() that may still take a reference to this instance. 
+            // Readers only hold the slot for a few instructions. Waiting under the 
+            // lock keeps a rebuild from deleting the slot meanwhile.
+            while (slot->readers.load() != 0)
+                std::this_thread::yield();
+        }
+
+        // Wait for Invoke() calls executing this instance, other than those on 
+        // this thread's stack when destroyed from within DelegateInvoke()
+        int own = 0;
+        for (InvokeFrame* frame = invokeFrames; frame != nullptr; frame = frame->prev)
+        {
+            if (frame->invoker == this)
+            {
+                frame->destroyed = true;
+                own++;
+            }
+        }
+        while (m_readers.load() != own)
+            std::this_thread::yield();
     }
     
     bool DelegateRemoteInvoker::Invoke(std::istream& s)
@@ -27,22 +157,55 @@ namespace DelegateLib
         s >> id;
         s.seekg(0);
 
-        // Find invoker instance matching the id
-        std::map<DelegateIdType, DelegateRemoteInvoker*>::iterator it;
+        // Pin the current table while looking up the id. Count the reader before 
+        // checking the table is still current so a rebuild cannot delete it.
+        Table* table;
+        for (;;)
         {
-            LockGuard lockGuard(GetLock());
-            it = GetMap().find(id);
+            table = GetTable().load();
+            if (table == nullptr)
+                return false;
+            table->readers.fetch_add(1);
+            if (GetTable().load() == table)
+                break;
+            table->readers.fetch_sub(1);
         }
-        if (it != GetMap().end())
+
+        // Find invoker instance matching the id
+        DelegateRemoteInvoker* invoker = nullptr;
+        Slot* slot = Find(table, id);
+        if (slot != nullptr)
         {
-            // Invoke the delegate instance
-            (*it).second->DelegateInvoke(s);
-            return true;
+            // Announce the reader before loading the invoker so the destructor 
+            // either sees the reader or this thread sees the removal. The slot 
+            // may have been reused for another id since Find().
+            slot->readers.fetch_add(1);
+            invoker = slot->invoker.load();
+            if (invoker && invoker->m_id == id)
+                invoker->m_readers.fetch_add(1);
+            else
+                invoker = nullptr;
+            slot->readers.fetch_sub(1);
         }
-        else
-        {
-            // No delegate found
+        table->readers.fetch_sub(1);
+
+        // False if no delegate found
+        if (invoker == nullptr)
             return false;
-        }
+
+        // Invoke the delegate instance. The instance may destroy itself.
+        InvokeFrame frame = { invoker, false, invokeFrames };
+        invokeFrames = &frame;
+        invoker->DelegateInvoke(s);
+        invokeFrames = frame.prev;
+        if (!frame.destroyed)
+            invoker->m_readers.fetch_sub(1);
+        return true;
+    }
+
+    bool DelegateRemoteInvoker::Invoke(const char* data, size_t size)
+    {
+        DelegateBufferStream s(data, size);
+        return Invoke(s);
     }
-}
\ No newline at end of file
+}
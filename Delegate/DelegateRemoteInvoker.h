@@ -3,13 +3,20 @@
 
 #include "LockGuard.h"
 #include <istream>
-#include <map>
+#include <atomic>
+#include <stddef.h>
 
 namespace DelegateLib {
 
 typedef int DelegateIdType;
 
 /// @brief An abstract base class used to invoke a delegate on a remote system. 
+/// Instances register by id in an open addressed table. Registration is locked; 
+/// Invoke() looks up the id without taking a lock. Registration rebuilds the 
+/// table before used and removed slots fill three quarters of it, dropping the 
+/// tombstones left by removed ids and doubling its size while the registered ids 
+/// would fill more than half, so a lookup always finds an empty slot within a 
+/// few probes. 
 class DelegateRemoteInvoker
 {
 public:
@@ -17,25 +24,95 @@ public:
     /// @param[in] id - an id shared by both remote systems.
     DelegateRemoteInvoker(DelegateIdType id);
 
-    /// Destructor
-    ~DelegateRemoteInvoker();
+    /// Copy constructor. The copy is not registered. 
+    DelegateRemoteInvoker(const DelegateRemoteInvoker& rhs) : m_id(rhs.m_id), m_readers(0) { }
+
+    /// Destructor. Calls Unregister() if a derived class has not already done so.
+    virtual ~DelegateRemoteInvoker() { Unregister(); }
 
     /// Invoke a remote delegate
     /// @param[in] s - the incoming remote message stream. 
     static bool Invoke(std::istream& s);
 
+    /// Invoke a remote delegate from a contiguous block of received bytes. The 
+    /// bytes are read in place; no copy is made. 
+    /// @param[in] data - the incoming remote message bytes. 
+    /// @param[in] size - the number of bytes. 
+    static bool Invoke(const char* data, size_t size);
+
 protected:
+    /// Stop receiving remote invocations. Blocks until any Invoke() executing this 
+    /// instance on another thread returns. May be called from within this instance's 
+    /// DelegateInvoke(). Every derived class destructor must call Unregister() first, 
+    /// otherwise a concurrent Invoke() can call DelegateInvoke() on a partially 
+    /// destroyed object. 
+    void Unregister();
+
     /// Called to invoke the callback by the remote system. 
     /// @param[in] s - the incoming remote message stream. 
     virtual void DelegateInvoke(std::istream& s) = 0;
 
 private:
+    DelegateRemoteInvoker& operator=(const DelegateRemoteInvoker&) = delete;
+
     DelegateIdType m_id;
 
-    static std::map<DelegateIdType, DelegateRemoteInvoker*>& GetMap()
+    /// Number of Invoke() calls executing this instance. 
+    std::atomic<int> m_readers;
+
+    enum SlotState { SLOT_EMPTY, SLOT_USED, SLOT_DELETED };
+
+    /// A registry table entry. A removed entry leaves a SLOT_DELETED tombstone 
+    /// so lock-free readers keep probing past it until the table is rebuilt.
+    struct Slot
+    {
+        std::atomic<int> state;
+        std::atomic<DelegateIdType> id;
+        std::atomic<DelegateRemoteInvoker*> invoker;
+
+        /// Number of Invoke() calls between finding the slot and taking a 
+        /// reference to its invoker.
+        std::atomic<int> readers;
+    };
+
+    /// The registry table. Replaced, never modified in size, when rebuilt. 
+    struct Table
+    {
+        explicit Table(unsigned int size) : size(size), shift(Shift(size)), used(0), deleted(0), readers(0), slots(new Slot[size]()) { }
+        ~Table() { delete[] slots; }
+
+        /// Right shift keeping the log2(size) high bits of a 32 bit hash
+        static unsigned int Shift(unsigned int size)
+        {
+            unsigned int shift = 32;
+            while (size > 1) { size >>= 1; shift--; }
+            return shift;
+        }
+
+        const unsigned int size;
+        const unsigned int shift;
+        unsigned int used;
+        unsigned int deleted;
+
+        /// Number of Invoke() calls looking up an id in this table. A replaced 
+        /// table is deleted once no reader is left.
+        std::atomic<int> readers;
+        Slot* const slots;
+    };
+
+    /// Find the slot holding id. 
+    /// @return The slot or nullptr if the id is not registered. 
+    static Slot* Find(Table* table, DelegateIdType id);
+
+    /// Replace the table with one of size slots holding only the registered ids. 
+    /// Called with the lock held. 
+    static void Rebuild(unsigned int size);
+
+    static std::atomic<Table*>& GetTable()
     {
-        static std::map<DelegateIdType, DelegateRemoteInvoker*> map;
-        return map;
+        // Created by the first registration; the last table is never deleted
+        static std::atomic<Table*> table(nullptr);
+        return table;
     }
 
     static LOCK* GetLock()
@@ -48,4 +125,4 @@ private:
 
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,151 @@
+#ifndef _DELEGATE_REMOTE_MULTICAST_H
+#define _DELEGATE_REMOTE_MULTICAST_H
+
+// DelegateRemoteMulticast.h
+// @see https://github.com/endurodave/AsyncMulticastDelegateCpp11
+
+#include "Delegate.h"
+#include "DelegateTransport.h"
+#include "DelegateBufferPool.h"
+#include "DelegateSerialize.h"
+#include "DelegateRemoteInvoker.h"
+#include "LockGuard.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace DelegateLib {
+
+// Declare DelegateRemoteMulticast as a class template.
+template <typename Signature>
+class DelegateRemoteMulticast;
+
+/// @brief Send a delegate to invoke a function on many remote systems. The
+/// arguments are serialized once into a reference counted pooled buffer and the
+/// same buffer is dispatched to every registered transport.
+///
+/// The transport list is copy-on-write. Publishers take a snapshot of the list
+/// without waiting on the lock used by AddTransport()/RemoveTransport(), so
+/// endpoints can be added and removed at runtime while invocations continue.
+/// Each list update waits for the invocations still using the previous list, so
+/// a transport may be destroyed once RemoveTransport() returns. Clones share the
+/// transport list with the original.
+template <class... Args>
+class DelegateRemoteMulticast<void(Args...)> : public Delegate<void(Args...)> {
+public:
+    using ClassType = DelegateRemoteMulticast<void(Args...)>;
+
+    /// Constructor
+    /// @param[in] id - an id shared by the sender and every remote receiver.
+    DelegateRemoteMulticast(DelegateIdType id) : m_state(std::make_shared<State>()), m_id(id) { }
+
+    virtual ClassType* Clone() const override { return new ClassType(*this); }
+
+    /// Register a buffer transport endpoint.
+    void AddTransport(IDelegateBufferTransport& transport) { Add(Endpoint(&transport, nullptr)); }
+
+    /// Register a stream transport endpoint.
+    void AddTransport(IDelegateTransport& transport) { Add(Endpoint(nullptr, &transport)); }
+
+    /// Unregister a buffer transport endpoint. Waits for invocations in progress 
+    /// on other threads, so the transport is no longer in use once this returns. 
+    /// Must not be called from within an invocation of this delegate.
+    void RemoveTransport(IDelegateBufferTransport& transport) { Remove(Endpoint(&transport, nullptr)); }
+
+    /// Unregister a stream transport endpoint.
+    void RemoveTransport(IDelegateTransport& transport) { Remove(Endpoint(nullptr, &transport)); }
+
+    /// Get the number of registered transports.
+    size_t GetTransportCount() const { return GetEndpoints()->size(); }
+
+    /// Serialize the arguments once and send them to every registered transport.
+    virtual void operator()(Args... args) override {
+        auto endpoints = GetEndpoints();
+        if (endpoints->empty())
+            return;
+
+        std::shared_ptr<DelegateBufferStream> buffer(DelegateBufferPool::Acquire(), &DelegateBufferPool::Release);
+        *buffer << m_id << std::ends;
+        int expand[] = { 0, (RemoteWrite(*buffer, args), 0)... };
+        (void)expand;
+
+        for (const Endpoint& endpoint : *endpoints) {
+            if (endpoint.bufferTransport)
+                endpoint.bufferTransport->DispatchShared(buffer);
+            else {
+                // Buffer transports may still hold the shared buffer, so each stream 
+                // transport reads its own read-only view of the bytes
+                DelegateBufferStream view(buffer->Data(), buffer->Size());
+                endpoint.transport->DispatchDelegate(view);
+            }
+        }
+    }
+
+    virtual bool operator==(const DelegateBase& rhs) const override {
+        auto derivedRhs = dynamic_cast<const ClassType*>(&rhs);
+        return derivedRhs &&
+            m_id == derivedRhs->m_id &&
+            m_state == derivedRhs->m_state;
+    }
+
+private:
+    struct Endpoint {
+        Endpoint(IDelegateBufferTransport* b, IDelegateTransport* t) : bufferTransport(b), transport(t) { }
+        bool operator==(const Endpoint& rhs) const {
+            return bufferTransport == rhs.bufferTransport && transport == rhs.transport; }
+
+        IDelegateBufferTransport* bufferTransport;
+        IDelegateTransport* transport;
+    };
+
+    typedef std::vector<Endpoint> EndpointList;
+
+    /// Transport list shared by clones
+    struct State {
+        State() : endpoints(std::make_shared<EndpointList>()) { LockGuard::Create(&writeLock); }
+        ~State() { LockGuard::Destroy(&writeLock); }
+        std::shared_ptr<const EndpointList> endpoints;     // Read with std::atomic_load
+        LOCK writeLock;                                    // Serializes list updates
+    };
+
+    std::shared_ptr<const EndpointList> GetEndpoints() const { return std::atomic_load(&m_state->endpoints); }
+
+    void Add(const Endpoint& endpoint) {
+        LockGuard lockGuard(&m_state->writeLock);
+        auto endpoints = std::make_shared<EndpointList>(*m_state->endpoints);
+        endpoints->push_back(endpoint);
+        Publish(endpoints);
+    }
+
+    void Remove(const Endpoint& endpoint) {
+        LockGuard lockGuard(&m_state->writeLock);
+        auto endpoints = std::make_shared<EndpointList>(*m_state->endpoints);
+        auto it = std::find(endpoints->begin(), endpoints->end(), endpoint);
+        if (it == endpoints->end())
+            return;
+        endpoints->erase(it);
+        Publish(endpoints);
+    }
+
+    /// Replace the transport list, then wait until no invocation holds the old list.
+    /// Every update waits, so no invocation holds any older list either. Caller 
+    /// must hold writeLock.
+    void Publish(const std::shared_ptr<EndpointList>& endpoints) {
+        std::shared_ptr<const EndpointList> old = 
+            std::atomic_exchange(&m_state->endpoints, std::shared_ptr<const EndpointList>(endpoints));
+        while (old.use_count() > 1)
+            std::this_thread::yield();
+
+        // Order the finished invocations before the caller destroys a transport
+        std::atomic_thread_fence(std::memory_order_acquire);
+    }
+
+    std::shared_ptr<State> m_state;
+    DelegateIdType m_id = 0;               // Remote delegate identifier
+};
+
+}
+
+#endif
@@ -8,6 +8,9 @@
 #include "Delegate.h"
 #include "DelegateTransport.h"
 #include "DelegateRemoteInvoker.h"
+#include "DelegateSerialize.h"
+#include <tuple>
+#include <type_traits>
 
 namespace DelegateLib {
 
@@ -49,6 +52,63 @@ private:
     Param m_param;
 };
 
+/// @brief Type a received argument is decoded as. Const is removed from the referenced 
+/// or pointed to type so the argument can be decoded in place. 
+template <class Param>
+struct RemoteDecodeType { typedef typename std::remove_const<Param>::type type; };
+
+template <class Param>
+struct RemoteDecodeType<const Param&> { typedef Param& type; };
+
+template <class Param>
+struct RemoteDecodeType<const Param*> { typedef Param* type; };
+
+/// @brief Compile time index sequence used to expand RemoteArgs (std::index_sequence is C++14).
+template <size_t... Is>
+struct RemoteIndexSeq { };
+
+template <size_t N, size_t... Is>
+struct RemoteMakeIndexSeq : RemoteMakeIndexSeq<N - 1, N - 1, Is...> { };
+
+template <size_t... Is>
+struct RemoteMakeIndexSeq<0, Is...> { typedef RemoteIndexSeq<Is...> type; };
+
+/// @brief Storage for the arguments of a received remote invocation. Each argument is 
+/// decoded in place using the same stream format as DelegateMemberRemoteRecv. 
+template <class... Args>
+class RemoteArgs
+{
+public:
+    /// Decode every argument from the stream, in order. 
+    void Decode(std::istream& stream) { 
+        Decode(stream, typename RemoteMakeIndexSeq<sizeof...(Args)>::type()); }
+
+    /// Call a delegate with the decoded arguments. 
+    template <class RetType>
+    RetType Invoke(Delegate<RetType(Args...)>& delegate) { 
+        return Invoke(delegate, typename RemoteMakeIndexSeq<sizeof...(Args)>::type()); }
+
+private:
+    template <size_t... Is>
+    void Decode(std::istream& stream, RemoteIndexSeq<Is...>) {
+        // Braced initializer list guarantees left to right evaluation
+        int expand[] = { 0, (DecodeParam(stream, std::get<Is>(m_params)), 0)... };
+        (void)expand;
+    }
+
+    template <class RetType, size_t... Is>
+    RetType Invoke(Delegate<RetType(Args...)>& delegate, RemoteIndexSeq<Is...>) { 
+        return delegate(std::get<Is>(m_params).Get()...); }
+
+    template <class Param>
+    static void DecodeParam(std::istream& stream, RemoteParam<Param>& param) {
+        auto&& p = param.Get();
+        RemoteRead(stream, p);
+    }
+
+    std::tuple<RemoteParam<typename RemoteDecodeType<Args>::type>...> m_params;
+};
+
 // Declare DelegateMemberRemoteRecv as a class template. It will be specialized for all number of arguments.
 template <typename Signature>
 class DelegateMemberRemoteRecv;
@@ -83,18 +143,21 @@ public:
         BaseType::Bind(object, func);
     }
 
+    /// Destructor. Stops remote invocations before the derived object is destroyed.
+    ~DelegateMemberRemoteRecv() { Unregister(); }
+
     virtual ClassType* Clone() const override { return new ClassType(*this); }
 
     /// Called by the remote system to invoke the delegate function
     virtual void DelegateInvoke(std::istream& stream) override {
-        RemoteParam<Param1> param1;
+        RemoteParam<typename RemoteDecodeType<Param1>::type> param1;
 
-        Param1 p1 = param1.Get();
+        auto&& p1 = param1.Get();
 
-        stream >> m_id;
-        stream.seekg(stream.tellg() + std::streampos(1));
-        stream >> p1;
+        DelegateIdType id;
+        stream >> id;
         stream.seekg(stream.tellg() + std::streampos(1));
+        RemoteRead(stream, p1);
 
         BaseType::operator()(p1);
     }
@@ -143,22 +206,24 @@ public:
         BaseType::Bind(object, func);
     }
 
+    /// Destructor. Stops remote invocations before the derived object is destroyed.
+    ~DelegateMemberRemoteRecv() { Unregister(); }
+
     virtual ClassType* Clone() const override { return new ClassType(*this); }
 
     /// Called by the remote system to invoke the delegate function
     virtual void DelegateInvoke(std::istream& stream) override {
-        RemoteParam<Param1> param1;
-        RemoteParam<Param2> param2;
+        RemoteParam<typename RemoteDecodeType<Param1>::type> param1;
+        RemoteParam<typename RemoteDecodeType<Param2>::type> param2;
 
-        Param1 p1 = param1.Get();
-        Param2 p2 = param2.Get();
+        auto&& p1 = param1.Get();
+        auto&& p2 = param2.Get();
 
-        stream >> m_id;
-        stream.seekg(stream.tellg() + std::streampos(1));
-        stream >> p1;
-        stream.seekg(stream.tellg() + std::streampos(1));
-        stream >> p2;
+        DelegateIdType id;
+        stream >> id;
         stream.seekg(stream.tellg() + std::streampos(1));
+        RemoteRead(stream, p1);
+        RemoteRead(stream, p2);
 
         BaseType::operator()(p1, p2);
     }
@@ -207,27 +272,28 @@ public:
         BaseType::Bind(object, func);
     }
 
+    /// Destructor. Stops remote invocations before the derived object is destroyed.
+    ~DelegateMemberRemoteRecv() { Unregister(); }
+
     virtual ClassType* Clone() const override { return new ClassType(*this);
     }
 
     /// Called by the remote system to invoke the delegate function
     virtual void DelegateInvoke(std::istream& stream) override {
-        RemoteParam<Param1> param1;
-        RemoteParam<Param2> param2;
-        RemoteParam<Param3> param3;
+        RemoteParam<typename RemoteDecodeType<Param1>::type> param1;
+        RemoteParam<typename RemoteDecodeType<Param2>::type> param2;
+        RemoteParam<typename RemoteDecodeType<Param3>::type> param3;
 
-        Param1 p1 = param1.Get();
-        Param2 p2 = param2.Get();
-        Param3 p3 = param3.Get();
+        auto&& p1 = param1.Get();
+        auto&& p2 = param2.Get();
+        auto&& p3 = param3.Get();
 
-        stream >> m_id;
-        stream.seekg(stream.tellg() + std::streampos(1));
-        stream >> p1;
-        stream.seekg(stream.tellg() + std::streampos(1));
-        stream >> p2;
-        stream.seekg(stream.tellg() + std::streampos(1));
-        stream >> p3;
+        DelegateIdType id;
+        stream >> id;
         stream.seekg(stream.tellg() + std::streampos(1));
+        RemoteRead(stream, p1);
+        RemoteRead(stream, p2);
+        RemoteRead(stream, p3);
 
         BaseType::operator()(p1, p2, p3);
     }
@@ -276,30 +342,30 @@ public:
         BaseType::Bind(object, func);
     }
 
+    /// Destructor. Stops remote invocations before the derived object is destroyed.
+    ~DelegateMemberRemoteRecv() { Unregister(); }
+
     virtual ClassType* Clone() const override { return new ClassType(*this); }
 
     /// Called by the remote system to invoke the delegate function
     virtual void DelegateInvoke(std::istream& stream) override {
-        RemoteParam<Param1> param1;
-        RemoteParam<Param2> param2;
-        RemoteParam<Param3> param3;
-        RemoteParam<Param4> param4;
+        RemoteParam<typename RemoteDecodeType<Param1>::type> param1;
+        RemoteParam<typename RemoteDecodeType<Param2>::type> param2;
+        RemoteParam<typename RemoteDecodeType<Param3>::type> param3;
+        RemoteParam<typename RemoteDecodeType<Param4>::type> param4;
 
-        Param1 p1 = param1.Get();
-        Param2 p2 = param2.Get();
-        Param3 p3 = param3.Get();
-        Param4 p4 = param4.Get();
+        auto&& p1 = param1.Get();
+        auto&& p2 = param2.Get();
+        auto&& p3 = param3.Get();
+        auto&& p4 = param4.Get();
 
-        stream >> m_id;
-        stream.seekg(stream.tellg() + std::streampos(1));
-        stream >> p1;
-        stream.seekg(stream.tellg() + std::streampos(1));
-        stream >> p2;
-        stream.seekg(stream.tellg() + std::streampos(1));
-        stream >> p3;
-        stream.seekg(stream.tellg() + std::streampos(1));
-        stream >> p4;
+        DelegateIdType id;
+        stream >> id;
         stream.seekg(stream.tellg() + std::streampos(1));
+        RemoteRead(stream, p1);
+        RemoteRead(stream, p2);
+        RemoteRead(stream, p3);
+        RemoteRead(stream, p4);
 
         BaseType::operator()(p1, p2, p3, p4);
     }
@@ -348,35 +414,34 @@ public:
         BaseType::Bind(object, func);
     }
 
+    /// Destructor. Stops remote invocations before the derived object is destroyed.
+    ~DelegateMemberRemoteRecv() { Unregister(); }
+
     virtual ClassType* Clone() const override { return new ClassType(*this);
     }
 
     /// Called by the remote system to invoke the delegate function
     virtual void DelegateInvoke(std::istream& stream) override {
-        RemoteParam<Param1> param1;
-        RemoteParam<Param2> param2;
-        RemoteParam<Param3> param3;
-        RemoteParam<Param4> param4;
-        RemoteParam<Param5> param5;
-
-        Param1 p1 = param1.Get();
-        Param2 p2 = param2.Get();
-        Param3 p3 = param3.Get();
-        Param4 p4 = param4.Get();
-        Param4 p5 = param5.Get();
-
-        stream >> m_id;
-        stream.seekg(stream.tellg() + std::streampos(1));
-        stream >> p1;
-        stream.seekg(stream.tellg() + std::streampos(1));
-        stream >> p2;
-        stream.seekg(stream.tellg() + std::streampos(1));
-        stream >> p3;
-        stream.seekg(stream.tellg() + std::streampos(1));
-        stream >> p4;
-        stream.seekg(stream.tellg() + std::streampos(1));
-        stream >> p5;
-        stream.seekg(stream.tellg() + std::streampos(1));
+        RemoteParam<typename RemoteDecodeType<Param1>::type> param1;
+        RemoteParam<typename RemoteDecodeType<Param2>::type> param2;
+        RemoteParam<typename RemoteDecodeType<Param3>::type> param3;
+        RemoteParam<typename RemoteDecodeType<Param4>::type> param4;
+        RemoteParam<typename RemoteDecodeType<Param5>::type> param5;
+
+        auto&& p1 = param1.Get();
+        auto&& p2 = param2.Get();
+        auto&& p3 = param3.Get();
+        auto&& p4 = param4.Get();
+        auto&& p5 = param5.Get();
+
+        DelegateIdType id;
+        stream >> id;
+        stream.seekg(stream.tellg() + std::streampos(1));
+        RemoteRead(stream, p1);
+        RemoteRead(stream, p2);
+        RemoteRead(stream, p3);
+        RemoteRead(stream, p4);
+        RemoteRead(stream, p5);
 
         BaseType::operator()(p1, p2, p3, p4, p5);
     }
@@ -414,18 +479,21 @@ public:
         BaseType::Bind(func);
     }
 
+    /// Destructor. Stops remote invocations before the derived object is destroyed.
+    ~DelegateFreeRemoteRecv() { Unregister(); }
+
     virtual ClassType* Clone() const override { return new ClassType(*this); }
 
     /// Called by the remote system to invoke the delegate function
     virtual void DelegateInvoke(std::istream& stream) override {
-        RemoteParam<Param1> param1;
+        RemoteParam<typename RemoteDecodeType<Param1>::type> param1;
 
-        Param1 p1 = param1.Get();
+        auto&& p1 = param1.Get();
 
-        stream >> m_id;
-        stream.seekg(stream.tellg() + std::streampos(1));
-        stream >> p1;
+        DelegateIdType id;
+        stream >> id;
         stream.seekg(stream.tellg() + std::streampos(1));
+        RemoteRead(stream, p1);
 
         BaseType::operator()(p1);
     }
@@ -459,22 +527,24 @@ public:
         BaseType::Bind(func);
     }
 
+    /// Destructor. Stops remote invocations before the derived object is destroyed.
+    ~DelegateFreeRemoteRecv() { Unregister(); }
+
     virtual ClassType* Clone() const override { return new ClassType(*this); }
 
     /// Called by the remote system to invoke the delegate function
     virtual void DelegateInvoke(std::istream& stream) override {
-        RemoteParam<Param1> param1;
-        RemoteParam<Param2> param2;
+        RemoteParam<typename RemoteDecodeType<Param1>::type> param1;
+        RemoteParam<typename RemoteDecodeType<Param2>::type> param2;
 
-        Param1 p1 = param1.Get();
-        Param2 p2 = param2.Get();
+        auto&& p1 = param1.Get();
+        auto&& p2 = param2.Get();
 
-        stream >> m_id;
-        stream.seekg(stream.tellg() + std::streampos(1));
-        stream >> p1;
-        stream.seekg(stream.tellg() + std::streampos(1));
-        stream >> p2;
+        DelegateIdType id;
+        stream >> id;
         stream.seekg(stream.tellg() + std::streampos(1));
+        RemoteRead(stream, p1);
+        RemoteRead(stream, p2);
 
         BaseType::operator()(p1, p2);
     }
@@ -508,26 +578,27 @@ public:
         BaseType::Bind(func);
     }
 
+    /// Destructor. Stops remote invocations before the derived object is destroyed.
+    ~DelegateFreeRemoteRecv() { Unregister(); }
+
     virtual ClassType* Clone() const override { return new ClassType(*this); }
 
     /// Called by the remote system to invoke the delegate function
     virtual void DelegateInvoke(std::istream& stream) override {
-        RemoteParam<Param1> param1;
-        RemoteParam<Param2> param2;
-        RemoteParam<Param3> param3;
+        RemoteParam<typename RemoteDecodeType<Param1>::type> param1;
+        RemoteParam<typename RemoteDecodeType<Param2>::type> param2;
+        RemoteParam<typename RemoteDecodeType<Param3>::type> param3;
 
-        Param1 p1 = param1.Get();
-        Param2 p2 = param2.Get();
-        Param3 p3 = param3.Get();
+        auto&& p1 = param1.Get();
+        auto&& p2 = param2.Get();
+        auto&& p3 = param3.Get();
 
-        stream >> m_id;
-        stream.seekg(stream.tellg() + std::streampos(1));
-        stream >> p1;
-        stream.seekg(stream.tellg() + std::streampos(1));
-        stream >> p2;
-        stream.seekg(stream.tellg() + std::streampos(1));
-        stream >> p3;
+        DelegateIdType id;
+        stream >> id;
         stream.seekg(stream.tellg() + std::streampos(1));
+        RemoteRead(stream, p1);
+        RemoteRead(stream, p2);
+        RemoteRead(stream, p3);
 
         BaseType::operator()(p1, p2, p3);
     }
@@ -561,30 +632,30 @@ public:
         BaseType::Bind(func);
     }
 
+    /// Destructor. Stops remote invocations before the derived object is destroyed.
+    ~DelegateFreeRemoteRecv() { Unregister(); }
+
     virtual ClassType* Clone() const override { return new ClassType(*this); }
 
     /// Called by the remote system to invoke the delegate function
     virtual void DelegateInvoke(std::istream& stream) override {
-        RemoteParam<Param1> param1;
-        RemoteParam<Param2> param2;
-        RemoteParam<Param3> param3;
-        RemoteParam<Param4> param4;
+        RemoteParam<typename RemoteDecodeType<Param1>::type> param1;
+        RemoteParam<typename RemoteDecodeType<Param2>::type> param2;
+        RemoteParam<typename RemoteDecodeType<Param3>::type> param3;
+        RemoteParam<typename RemoteDecodeType<Param4>::type> param4;
 
-        Param1 p1 = param1.Get();
-        Param2 p2 = param2.Get();
-        Param3 p3 = param3.Get();
-        Param4 p4 = param4.Get();
+        auto&& p1 = param1.Get();
+        auto&& p2 = param2.Get();
+        auto&& p3 = param3.Get();
+        auto&& p4 = param4.Get();
 
-        stream >> m_id;
-        stream.seekg(stream.tellg() + std::streampos(1));
-        stream >> p1;
-        stream.seekg(stream.tellg() + std::streampos(1));
-        stream >> p2;
-        stream.seekg(stream.tellg() + std::streampos(1));
-        stream >> p3;
-        stream.seekg(stream.tellg() + std::streampos(1));
-        stream >> p4;
+        DelegateIdType id;
+        stream >> id;
         stream.seekg(stream.tellg() + std::streampos(1));
+        RemoteRead(stream, p1);
+        RemoteRead(stream, p2);
+        RemoteRead(stream, p3);
+        RemoteRead(stream, p4);
 
         BaseType::operator()(p1, p2, p3, p4);
     }
@@ -618,34 +689,33 @@ public:
         BaseType::Bind(func);
     }
 
+    /// Destructor. Stops remote invocations before the derived object is destroyed.
+    ~DelegateFreeRemoteRecv() { Unregister(); }
+
     virtual ClassType* Clone() const override { return new ClassType(*this); }
 
     /// Called by the remote system to invoke the delegate function
     virtual void DelegateInvoke(std::istream& stream) override {
-        RemoteParam<Param1> param1;
-        RemoteParam<Param2> param2;
-        RemoteParam<Param3> param3;
-        RemoteParam<Param4> param4;
-        RemoteParam<Param5> param5;
-
-        Param1 p1 = param1.Get();
-        Param2 p2 = param2.Get();
-        Param3 p3 = param3.Get();
-        Param4 p4 = param4.Get();
-        Param5 p5 = param5.Get();
-
-        stream >> m_id;
-        stream.seekg(stream.tellg() + std::streampos(1));
-        stream >> p1;
-        stream.seekg(stream.tellg() + std::streampos(1));
-        stream >> p2;
-        stream.seekg(stream.tellg() + std::streampos(1));
-        stream >> p3;
-        stream.seekg(stream.tellg() + std::streampos(1));
-        stream >> p4;
-        stream.seekg(stream.tellg() + std::streampos(1));
-        stream >> p5;
-        stream.seekg(stream.tellg() + std::streampos(1));
+        RemoteParam<typename RemoteDecodeType<Param1>::type> param1;
+        RemoteParam<typename RemoteDecodeType<Param2>::type> param2;
+        RemoteParam<typename RemoteDecodeType<Param3>::type> param3;
+        RemoteParam<typename RemoteDecodeType<Param4>::type> param4;
+        RemoteParam<typename RemoteDecodeType<Param5>::type> param5;
+
+        auto&& p1 = param1.Get();
+        auto&& p2 = param2.Get();
+        auto&& p3 = param3.Get();
+        auto&& p4 = param4.Get();
+        auto&& p5 = param5.Get();
+
+        DelegateIdType id;
+        stream >> id;
+        stream.seekg(stream.tellg() + std::streampos(1));
+        RemoteRead(stream, p1);
+        RemoteRead(stream, p2);
+        RemoteRead(stream, p3);
+        RemoteRead(stream, p4);
+        RemoteRead(stream, p5);
 
         BaseType::operator()(p1, p2, p3, p4, p5);
     }
@@ -0,0 +1,106 @@
+#ifndef _DELEGATE_REMOTE_RECV_ASYNC_H
+#define _DELEGATE_REMOTE_RECV_ASYNC_H
+
+// DelegateRemoteRecvAsync.h
+// @see https://github.com/endurodave/AsyncMulticastDelegateCpp11
+//
+// A remote receiver that decodes the arguments on the thread calling
+// DelegateRemoteInvoker::Invoke() (typically a transport I/O thread) and invokes
+// the target function on a DelegateThread. The arguments are decoded directly
+// into the async message, so they are not copied again on dispatch.
+
+#include "DelegateRemoteRecv.h"
+#include "DelegateAsync.h"
+#include <memory>
+
+namespace DelegateLib {
+
+/// @brief An async message holding the decoded arguments of one remote invocation.
+template <class... Args>
+class DelegateRemoteMsg : public DelegateMsgBase
+{
+public:
+    DelegateRemoteMsg(std::shared_ptr<IDelegateInvoker> invoker) : DelegateMsgBase(invoker) { }
+
+    /// Get the decoded arguments.
+    RemoteArgs<Args...>& GetArgs() { return m_args; }
+
+private:
+    RemoteArgs<Args...> m_args;
+};
+
+// Declare DelegateRemoteRecvAsync as a class template.
+template <typename Signature>
+class DelegateRemoteRecvAsync;
+
+/// @brief Receive a delegate from a remote system and invoke the target function on
+/// the specified thread of control.
+template <class... Args>
+class DelegateRemoteRecvAsync<void(Args...)> : public DelegateRemoteInvoker
+{
+public:
+    using TargetType = Delegate<void(Args...)>;
+
+    /// Constructor
+    /// @param[in] target - the delegate to invoke on thread. A clone is stored.
+    /// @param[in] thread - the thread the target is invoked on.
+    /// @param[in] id - an id shared by both remote systems.
+    DelegateRemoteRecvAsync(const TargetType& target, DelegateThread& thread, DelegateIdType id) :
+        DelegateRemoteInvoker(id),
+        m_dispatcher(std::make_shared<Dispatcher>(target.Clone())),
+        m_thread(thread) { }
+
+    /// Constructor taking a free function.
+    DelegateRemoteRecvAsync(void(*func)(Args...), DelegateThread& thread, DelegateIdType id) :
+        DelegateRemoteRecvAsync(DelegateFree<void(Args...)>(func), thread, id) { }
+
+    /// Constructor taking a class instance and member function.
+    template <class TClass>
+    DelegateRemoteRecvAsync(TClass* object, void (TClass::*func)(Args...), DelegateThread& thread, DelegateIdType id) :
+        DelegateRemoteRecvAsync(DelegateMember<void(TClass(Args...))>(object, func), thread, id) { }
+
+    /// Destructor. Stops remote invocations before the members are destroyed.
+    ~DelegateRemoteRecvAsync() { Unregister(); }
+
+protected:
+    /// Called by the remote system. Decode the arguments into a new message and
+    /// dispatch it onto the target thread.
+    virtual void DelegateInvoke(std::istream& stream) override {
+        DelegateIdType id;
+        stream >> id;
+        stream.seekg(stream.tellg() + std::streampos(1));
+
+        auto msg = MakeDelegateMsg<DelegateRemoteMsg<Args...>>(m_thread, m_dispatcher);
+        msg->GetArgs().Decode(stream);
+        m_thread.DispatchDelegate(msg);
+    }
+
+private:
+    // Prevent copying objects. The instance is registered to receive remote invocations.
+    DelegateRemoteRecvAsync(const DelegateRemoteRecvAsync&) = delete;
+    DelegateRemoteRecvAsync& operator=(const DelegateRemoteRecvAsync&) = delete;
+
+    /// Invokes the target on the destination thread. Shared with every message in
+    /// flight so the receiver may be destroyed before its queued messages run.
+    class Dispatcher : public IDelegateInvoker
+    {
+    public:
+        Dispatcher(TargetType* target) : m_target(target) { }
+
+        /// Called by the target thread to invoke the delegate function
+        virtual void DelegateInvoke(std::shared_ptr<DelegateMsgBase> msg) override {
+            auto remoteMsg = std::static_pointer_cast<DelegateRemoteMsg<Args...>>(msg);
+            remoteMsg->GetArgs().Invoke(*m_target);
+        }
+
+    private:
+        std::unique_ptr<TargetType> m_target;
+    };
+
+    std::shared_ptr<Dispatcher> m_dispatcher;
+    DelegateThread& m_thread;       // Target thread to invoke the delegate function
+};
+
+}
+
+#endif
@@ -0,0 +1,324 @@
+#ifndef _DELEGATE_REMOTE_REQUEST_H
+#define _DELEGATE_REMOTE_REQUEST_H
+
+// DelegateRemoteRequest.h
+// @see https://github.com/endurodave/AsyncMulticastDelegateCpp11
+//
+// Request/response remote delegates. DelegateRemoteRequest sends a request tagged
+// with a correlation id and matches the response by that id, so any number of
+// requests may be in flight over one transport. DelegateRemoteResponder receives
+// the request on the remote system, invokes the bound delegate and sends the
+// return value back.
+//
+// Request wire format:  requestId, correlationId, arguments...
+// Response wire format: responseId, correlationId, return value
+
+#include "DelegateRemoteSend.h"
+#include "DelegateRemoteRecv.h"
+#include "DelegateAsyncWait.h"
+#include "Semaphore.h"
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace DelegateLib {
+
+typedef unsigned int DelegateCorrelationIdType;
+
+template <class Signature>
+class DelegateRemoteRequest; // Not defined
+
+/// @brief Invoke a function with a return value on a remote system. The caller either
+/// blocks until the response or timeout, or passes a completion delegate that is
+/// called when the response arrives or the request expires. The completion delegate
+/// may itself be an asynchronous delegate to route the response onto another thread.
+/// Each request has its own timeout, by default the one given to the constructor.
+/// A completion delegate request that times out is failed by an expiry thread,
+/// started by the first such request that has a timeout.
+template <class RetType, class... Args>
+class DelegateRemoteRequest<RetType(Args...)> : public DelegateRemoteSender, public DelegateRemoteInvoker
+{
+    static_assert(!std::is_void<RetType>::value, "Use DelegateRemoteSend for a remote function without a return value");
+
+public:
+    /// Completion delegate. Called with true and the return value on success, or
+    /// false and a default constructed value on timeout.
+    using CompletionType = Delegate<void(bool, RetType)>;
+
+    /// Constructor
+    /// @param[in] transport - the transport that sends requests.
+    /// @param[in] requestId - the remote DelegateRemoteResponder id.
+    /// @param[in] responseId - the id responses are addressed to; unique within this system.
+    /// @param[in] timeout - default request timeout in milliseconds or WAIT_INFINITE.
+    DelegateRemoteRequest(IDelegateBufferTransport& transport, DelegateIdType requestId, DelegateIdType responseId, int timeout = WAIT_INFINITE) :
+        DelegateRemoteSender(transport, requestId), DelegateRemoteInvoker(responseId), m_timeout(timeout) { }
+
+    /// Destructor. Stops responses arriving and the expiry thread before the members
+    /// are destroyed. Requests still pending are not completed.
+    ~DelegateRemoteRequest() {
+        Unregister();
+        if (m_thread) {
+            {
+                std::lock_guard<std::mutex> lock(m_lock);
+                m_exit = true;
+            }
+            m_wake.Signal();
+            m_thread->join();
+            m_thread = nullptr;
+        }
+    }
+
+    /// Send a request and wait for the response. Use IsSuccess() to determine
+    /// whether the response arrived before the timeout.
+    RetType operator()(Args... args) {
+        RetType retVal = RetType();
+        m_success = Invoke(retVal, args...);
+        return retVal;
+    }
+
+    /// Send a request and wait for the response, up to the default timeout. Safe to
+    /// call from several threads at once.
+    /// @param[out] retVal - the remote function return value.
+    /// @return true if the response arrived before the timeout.
+    bool Invoke(RetType& retVal, Args... args) {
+        return Invoke(m_timeout, retVal, args...);
+    }
+
+    /// Send a request and wait for the response. Safe to call from several threads at once.
+    /// @param[in] timeout - this request's timeout in milliseconds or WAIT_INFINITE.
+    /// @param[out] retVal - the remote function return value.
+    /// @return true if the response arrived before the timeout.
+    bool Invoke(int timeout, RetType& retVal, Args... args) {
+        auto pending = std::make_shared<Pending>();
+        DelegateCorrelationIdType correlationId = Send(pending, args...);
+
+        bool signaled = pending->sema.Wait(timeout);
+
+        std::lock_guard<std::mutex> lock(m_lock);
+        if (!signaled && !pending->done) {
+            m_pending.erase(correlationId);
+            return false;
+        }
+        retVal = pending->retVal;
+        return true;
+    }
+
+    /// Send a request without waiting, using the default timeout. The completion
+    /// delegate is invoked on the thread that receives the response, or on the
+    /// expiry thread on timeout.
+    /// @param[in] completion - the delegate to invoke. A clone is stored.
+    void Invoke(const CompletionType& completion, Args... args) {
+        Invoke(m_timeout, completion, args...);
+    }
+
+    /// Send a request without waiting. The completion delegate is invoked on the
+    /// thread that receives the response, or on the expiry thread on timeout.
+    /// @param[in] timeout - this request's timeout in milliseconds or WAIT_INFINITE.
+    /// @param[in] completion - the delegate to invoke. A clone is stored.
+    void Invoke(int timeout, const CompletionType& completion, Args... args) {
+        auto pending = std::make_shared<Pending>();
+        pending->completion.reset(completion.Clone());
+        pending->expires = (timeout >= 0);
+        if (pending->expires)
+            pending->deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
+        Send(pending, args...);
+
+        // Wake the expiry thread to wait for the new deadline
+        if (pending->expires) {
+            {
+                std::lock_guard<std::mutex> lock(m_lock);
+                if (!m_thread)
+                    m_thread = std::unique_ptr<std::thread>(new std::thread(&DelegateRemoteRequest::ExpireThread, this));
+            }
+            m_wake.Signal();
+        }
+    }
+
+    /// Returns true if the last operator() call received a response.
+    bool IsSuccess() const { return m_success; }
+
+    /// Get the number of requests awaiting a response.
+    size_t GetPendingCount() {
+        std::lock_guard<std::mutex> lock(m_lock);
+        return m_pending.size();
+    }
+
+protected:
+    /// Called when a response arrives from the remote system.
+    virtual void DelegateInvoke(std::istream& stream) override {
+        DelegateIdType id;
+        DelegateCorrelationIdType correlationId;
+        stream >> id;
+        stream.seekg(stream.tellg() + std::streampos(1));
+        stream >> correlationId;
+        stream.seekg(stream.tellg() + std::streampos(1));
+
+        RetType retVal = RetType();
+        RemoteRead(stream, retVal);
+
+        std::shared_ptr<Pending> pending;
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            auto it = m_pending.find(correlationId);
+
+            // Late response to a request that already timed out
+            if (it == m_pending.end())
+                return;
+
+            pending = it->second;
+            m_pending.erase(it);
+            if (!pending->completion) {
+                pending->retVal = retVal;
+                pending->done = true;
+            }
+        }
+
+        if (pending->completion)
+            (*pending->completion)(true, retVal);
+        else
+            pending->sema.Signal();
+    }
+
+private:
+    // Prevent copying objects. The instance is registered to receive responses.
+    DelegateRemoteRequest(const DelegateRemoteRequest&) = delete;
+    DelegateRemoteRequest& operator=(const DelegateRemoteRequest&) = delete;
+
+    /// An outstanding request
+    struct Pending {
+        Semaphore sema;
+        bool done = false;
+        RetType retVal = RetType();
+        std::unique_ptr<CompletionType> completion;
+        bool expires = false;
+        std::chrono::steady_clock::time_point deadline;
+    };
+
+    /// Fail completion delegate requests as their timeouts expire.
+    void ExpireThread() {
+        for (;;) {
+            int timeout = -1;
+            std::vector<std::shared_ptr<Pending>> expired;
+            {
+                std::lock_guard<std::mutex> lock(m_lock);
+                if (m_exit)
+                    return;
+
+                auto now = std::chrono::steady_clock::now();
+                for (auto it = m_pending.begin(); it != m_pending.end(); ) {
+                    if (!it->second->completion || !it->second->expires) {
+                        ++it;
+                    }
+                    else if (it->second->deadline <= now) {
+                        expired.push_back(it->second);
+                        it = m_pending.erase(it);
+                    }
+                    else {
+                        // Wait until the earliest remaining deadline, rounded up to a whole mS
+                        long long remaining = std::chrono::duration_cast<std::chrono::microseconds>(
+                            it->second->deadline - now).count();
+                        int ms = static_cast<int>((remaining + 999) / 1000);
+                        if (timeout < 0 || ms < timeout)
+                            timeout = ms;
+                        ++it;
+                    }
+                }
+            }
+
+            for (auto& pending : expired)
+                (*pending->completion)(false, RetType());
+
+            // A signal sent since the deadlines were read is kept, so a new request
+            // is never missed
+            if (expired.empty())
+                m_wake.Wait(timeout);
+        }
+    }
+
+    /// Register a pending request then send it. The response may arrive before
+    /// this function returns.
+    DelegateCorrelationIdType Send(const std::shared_ptr<Pending>& pending, Args... args) {
+        DelegateCorrelationIdType correlationId;
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            correlationId = m_nextCorrelationId++;
+            m_pending[correlationId] = pending;
+        }
+
+        std::ostream& s = BeginSend();
+        s << correlationId << std::ends;
+        int expand[] = { 0, (RemoteWrite(s, args), 0)... };
+        (void)expand;
+        EndSend(s);
+        return correlationId;
+    }
+
+    int m_timeout;                                  // Default time in mS to wait for a response
+    std::atomic<bool> m_success{ false };           // Set true if operator() received a response
+    DelegateCorrelationIdType m_nextCorrelationId = 0;
+    std::map<DelegateCorrelationIdType, std::shared_ptr<Pending>> m_pending;
+    std::mutex m_lock;
+    std::unique_ptr<std::thread> m_thread;          // Fails expired completion delegate requests
+    Semaphore m_wake;                               // Signaled when a request with a timeout is sent
+    bool m_exit = false;
+};
+
+template <class Signature>
+class DelegateRemoteResponder; // Not defined
+
+/// @brief Receive a DelegateRemoteRequest on the remote system, invoke the target
+/// delegate and send its return value back to the requester. The target may be
+/// any delegate type, including a blocking asynchronous delegate to execute the
+/// function on another thread.
+template <class RetType, class... Args>
+class DelegateRemoteResponder<RetType(Args...)> : public DelegateRemoteSender, public DelegateRemoteInvoker
+{
+public:
+    /// Constructor
+    /// @param[in] transport - the transport that sends responses.
+    /// @param[in] requestId - the id requests are addressed to.
+    /// @param[in] responseId - the requester's response id.
+    /// @param[in] target - the delegate to invoke. A clone is stored.
+    DelegateRemoteResponder(IDelegateBufferTransport& transport, DelegateIdType requestId, DelegateIdType responseId,
+        const Delegate<RetType(Args...)>& target) :
+        DelegateRemoteSender(transport, responseId), DelegateRemoteInvoker(requestId), m_target(target.Clone()) { }
+
+    /// Destructor. Stops requests arriving before the members are destroyed.
+    ~DelegateRemoteResponder() { Unregister(); }
+
+protected:
+    /// Called when a request arrives from the remote system.
+    virtual void DelegateInvoke(std::istream& stream) override {
+        DelegateIdType id;
+        DelegateCorrelationIdType correlationId;
+        stream >> id;
+        stream.seekg(stream.tellg() + std::streampos(1));
+        stream >> correlationId;
+        stream.seekg(stream.tellg() + std::streampos(1));
+
+        RemoteArgs<Args...> args;
+        args.Decode(stream);
+        RetType retVal = args.Invoke(*m_target);
+
+        std::ostream& s = BeginSend();
+        s << correlationId << std::ends;
+        RemoteWrite(s, retVal);
+        EndSend(s);
+    }
+
+private:
+    // Prevent copying objects. The instance is registered to receive requests.
+    DelegateRemoteResponder(const DelegateRemoteResponder&) = delete;
+    DelegateRemoteResponder& operator=(const DelegateRemoteResponder&) = delete;
+
+    std::unique_ptr<Delegate<RetType(Args...)>> m_target;
+};
+
+}
+
+#endif
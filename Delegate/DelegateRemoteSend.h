@@ -7,172 +7,219 @@
 
 #include "Delegate.h"
 #include "DelegateTransport.h"
+#include "DelegateBufferPool.h"
+#include "DelegateSerialize.h"
 #include "DelegateRemoteInvoker.h"
 
 namespace DelegateLib {
 
+/// @brief Non-template base for DelegateRemoteSend. Owns the transport binding and 
+/// selects the stream each outgoing message is serialized into: the caller's 
+/// std::iostream if one was given, otherwise a buffer acquired from 
+/// DelegateBufferPool for the duration of the send. Pooled buffers make 
+/// concurrent sends from different threads safe and allocation free. 
+class DelegateRemoteSender {
+public:
+    DelegateRemoteSender(IDelegateTransport& transport, std::iostream& stream, DelegateIdType id) :
+        m_transport(&transport), m_stream(&stream), m_id(id) { }
+    DelegateRemoteSender(IDelegateTransport& transport, DelegateIdType id) :
+        m_transport(&transport), m_id(id) { }
+    DelegateRemoteSender(IDelegateBufferTransport& transport, DelegateIdType id) :
+        m_bufferTransport(&transport), m_id(id) { }
+
+protected:
+    /// Get the stream to serialize an outgoing message into and write the message header. 
+    /// @return The stream to serialize the function arguments into. Must be passed to EndSend(). 
+    std::ostream& BeginSend() {
+        std::ostream* s = m_stream;
+        if (!s)
+            s = DelegateBufferPool::Acquire();
+        *s << m_id << std::ends;
+        return *s;
+    }
+
+    /// Dispatch a message previously started with BeginSend() and recycle its buffer. 
+    /// @param[in] s - the stream returned by BeginSend(). 
+    void EndSend(std::ostream& s) {
+        if (m_stream) {
+            m_transport->DispatchDelegate(*m_stream);
+            return;
+        }
+
+        DelegateBufferStream& buffer = static_cast<DelegateBufferStream&>(s);
+        if (m_bufferTransport)
+            m_bufferTransport->DispatchDelegate(buffer.Data(), buffer.Size());
+        else
+            m_transport->DispatchDelegate(buffer);
+        DelegateBufferPool::Release(&buffer);
+    }
+
+    bool IsEqual(const DelegateRemoteSender& rhs) const {
+        return m_id == rhs.m_id &&
+            m_transport == rhs.m_transport &&
+            m_bufferTransport == rhs.m_bufferTransport;
+    }
+
+private:
+    IDelegateTransport* m_transport = nullptr;              // Object sends stream to remote
+    std::iostream* m_stream = nullptr;                      // Storage for remote message
+    IDelegateBufferTransport* m_bufferTransport = nullptr;  // Object sends buffer to remote
+    DelegateIdType m_id = 0;                                // Remote delegate identifier
+};
+
 // Declare DelegateRemoteSend as a class template. It will be specialized for all number of arguments.
 template <typename Signature>
 class DelegateRemoteSend;
 
 /// @brief Send a delegate to invoke a function on a remote system. 
 template <class Param1>
-class DelegateRemoteSend<void(Param1)> : public Delegate<void(Param1)> {
+class DelegateRemoteSend<void(Param1)> : public Delegate<void(Param1)>, public DelegateRemoteSender {
 public:
     using ClassType = DelegateRemoteSend<void(Param1)>;
 
-    DelegateRemoteSend(IDelegateTransport& transport, std::iostream& stream, DelegateIdType id) : 
-        m_transport(transport), m_stream(stream), m_id(id) { }
+    DelegateRemoteSend(IDelegateTransport& transport, std::iostream& stream, DelegateIdType id) :
+        DelegateRemoteSender(transport, stream, id) { }
+    DelegateRemoteSend(IDelegateTransport& transport, DelegateIdType id) :
+        DelegateRemoteSender(transport, id) { }
+    DelegateRemoteSend(IDelegateBufferTransport& transport, DelegateIdType id) :
+        DelegateRemoteSender(transport, id) { }
 
-	virtual ClassType* Clone() const override { return new ClassType(*this); }
+    virtual ClassType* Clone() const override { return new ClassType(*this); }
 
-	/// Invoke the bound delegate function. 
-	virtual void operator()(Param1 p1) override {
-        m_stream << m_id << std::ends;
-        m_stream << p1 << std::ends;
-        m_transport.DispatchDelegate(m_stream);
+    /// Invoke the bound delegate function. 
+    virtual void operator()(Param1 p1) override {
+        std::ostream& s = BeginSend();
+        RemoteWrite(s, p1);
+        EndSend(s);
     }
 
-	virtual bool operator==(const DelegateBase& rhs) const override {
-		auto derivedRhs = dynamic_cast<const ClassType*>(&rhs);
-		return derivedRhs &&
-			m_id == derivedRhs->m_id &&
-            &m_transport == &derivedRhs->m_transport; }
-
-private:
-	IDelegateTransport& m_transport;    // Object sends data to remote
-    std::iostream& m_stream;            // Storage for remote message 
-    DelegateIdType m_id = 0;                // Remote delegate identifier
+    virtual bool operator==(const DelegateBase& rhs) const override {
+        auto derivedRhs = dynamic_cast<const ClassType*>(&rhs);
+        return derivedRhs &&
+            IsEqual(*derivedRhs);
+    }
 };
 
 template <class Param1, class Param2>
-class DelegateRemoteSend<void(Param1, Param2)> : public Delegate<void(Param1, Param2)> {
+class DelegateRemoteSend<void(Param1, Param2)> : public Delegate<void(Param1, Param2)>, public DelegateRemoteSender {
 public:
     using ClassType = DelegateRemoteSend<void(Param1, Param2)>;
 
     DelegateRemoteSend(IDelegateTransport& transport, std::iostream& stream, DelegateIdType id) :
-        m_transport(transport), m_stream(stream), m_id(id) { }
+        DelegateRemoteSender(transport, stream, id) { }
+    DelegateRemoteSend(IDelegateTransport& transport, DelegateIdType id) :
+        DelegateRemoteSender(transport, id) { }
+    DelegateRemoteSend(IDelegateBufferTransport& transport, DelegateIdType id) :
+        DelegateRemoteSender(transport, id) { }
 
     virtual ClassType* Clone() const override { return new ClassType(*this); }
 
     /// Invoke the bound delegate function. 
     virtual void operator()(Param1 p1, Param2 p2) override {
-        m_stream << m_id << std::ends;
-        m_stream << p1 << std::ends;
-        m_stream << p2 << std::ends;
-        m_transport.DispatchDelegate(m_stream);
+        std::ostream& s = BeginSend();
+        RemoteWrite(s, p1);
+        RemoteWrite(s, p2);
+        EndSend(s);
     }
 
     virtual bool operator==(const DelegateBase& rhs) const override {
         auto derivedRhs = dynamic_cast<const ClassType*>(&rhs);
         return derivedRhs &&
-            m_id == derivedRhs->m_id &&
-            &m_transport == &derivedRhs->m_transport;
+            IsEqual(*derivedRhs);
     }
-
-private:
-    IDelegateTransport & m_transport;   // Object sends data to remote
-    std::iostream& m_stream;            // Storage for remote message 
-    DelegateIdType m_id = 0;                // Remote delegate identifier
 };
 
 template <class Param1, class Param2, class Param3>
-class DelegateRemoteSend<void(Param1, Param2, Param3)> : public Delegate<void(Param1, Param2, Param3)> {
+class DelegateRemoteSend<void(Param1, Param2, Param3)> : public Delegate<void(Param1, Param2, Param3)>, public DelegateRemoteSender {
 public:
     using ClassType = DelegateRemoteSend<void(Param1, Param2, Param3)>;
 
     DelegateRemoteSend(IDelegateTransport& transport, std::iostream& stream, DelegateIdType id) :
-        m_transport(transport), m_stream(stream), m_id(id) { }
+        DelegateRemoteSender(transport, stream, id) { }
+    DelegateRemoteSend(IDelegateTransport& transport, DelegateIdType id) :
+        DelegateRemoteSender(transport, id) { }
+    DelegateRemoteSend(IDelegateBufferTransport& transport, DelegateIdType id) :
+        DelegateRemoteSender(transport, id) { }
 
     virtual ClassType* Clone() const override { return new ClassType(*this); }
 
     /// Invoke the bound delegate function. 
     virtual void operator()(Param1 p1, Param2 p2, Param3 p3) override {
-        m_stream << m_id << std::ends;
-        m_stream << p1 << std::ends;
-        m_stream << p2 << std::ends;
-        m_stream << p3 << std::ends;
-        m_transport.DispatchDelegate(m_stream);
+        std::ostream& s = BeginSend();
+        RemoteWrite(s, p1);
+        RemoteWrite(s, p2);
+        RemoteWrite(s, p3);
+        EndSend(s);
     }
 
     virtual bool operator==(const DelegateBase& rhs) const override {
         auto derivedRhs = dynamic_cast<const ClassType*>(&rhs);
         return derivedRhs &&
-            m_id == derivedRhs->m_id &&
-            &m_transport == &derivedRhs->m_transport;
+            IsEqual(*derivedRhs);
     }
-
-private:
-    IDelegateTransport & m_transport;   // Object sends data to remote
-    std::iostream& m_stream;            // Storage for remote message 
-    DelegateIdType m_id = 0;                // Remote delegate identifier
 };
 
 template <class Param1, class Param2, class Param3, class Param4>
-class DelegateRemoteSend<void(Param1, Param2, Param3, Param4)> : public Delegate<void(Param1, Param2, Param3, Param4)> {
+class DelegateRemoteSend<void(Param1, Param2, Param3, Param4)> : public Delegate<void(Param1, Param2, Param3, Param4)>, public DelegateRemoteSender {
 public:
     using ClassType = DelegateRemoteSend<void(Param1, Param2, Param3, Param4)>;
 
     DelegateRemoteSend(IDelegateTransport& transport, std::iostream& stream, DelegateIdType id) :
-        m_transport(transport), m_stream(stream), m_id(id) { }
+        DelegateRemoteSender(transport, stream, id) { }
+    DelegateRemoteSend(IDelegateTransport& transport, DelegateIdType id) :
+        DelegateRemoteSender(transport, id) { }
+    DelegateRemoteSend(IDelegateBufferTransport& transport, DelegateIdType id) :
+        DelegateRemoteSender(transport, id) { }
 
     virtual ClassType* Clone() const override { return new ClassType(*this); }
 
     /// Invoke the bound delegate function. 
     virtual void operator()(Param1 p1, Param2 p2, Param3 p3, Param4 p4) override {
-        m_stream << m_id << std::ends;
-        m_stream << p1 << std::ends;
-        m_stream << p2 << std::ends;
-        m_stream << p3 << std::ends;
-        m_stream << p4 << std::ends;
-        m_transport.DispatchDelegate(m_stream);
+        std::ostream& s = BeginSend();
+        RemoteWrite(s, p1);
+        RemoteWrite(s, p2);
+        RemoteWrite(s, p3);
+        RemoteWrite(s, p4);
+        EndSend(s);
     }
 
     virtual bool operator==(const DelegateBase& rhs) const override {
         auto derivedRhs = dynamic_cast<const ClassType*>(&rhs);
         return derivedRhs &&
-            m_id == derivedRhs->m_id &&
-            &m_transport == &derivedRhs->m_transport;
+            IsEqual(*derivedRhs);
     }
-
-private:
-    IDelegateTransport & m_transport;   // Object sends data to remote
-    std::iostream& m_stream;            // Storage for remote message 
-    DelegateIdType m_id = 0;                // Remote delegate identifier
 };
 
 template <class Param1, class Param2, class Param3, class Param4, class Param5>
-class DelegateRemoteSend<void(Param1, Param2, Param3, Param4, Param5)> : public Delegate<void(Param1, Param2, Param3, Param4, Param5)> {
+class DelegateRemoteSend<void(Param1, Param2, Param3, Param4, Param5)> : public Delegate<void(Param1, Param2, Param3, Param4, Param5)>, public DelegateRemoteSender {
 public:
     using ClassType = DelegateRemoteSend<void(Param1, Param2, Param3, Param4, Param5)>;
 
     DelegateRemoteSend(IDelegateTransport& transport, std::iostream& stream, DelegateIdType id) :
-        m_transport(transport), m_stream(stream), m_id(id) { }
+        DelegateRemoteSender(transport, stream, id) { }
+    DelegateRemoteSend(IDelegateTransport& transport, DelegateIdType id) :
+        DelegateRemoteSender(transport, id) { }
+    DelegateRemoteSend(IDelegateBufferTransport& transport, DelegateIdType id) :
+        DelegateRemoteSender(transport, id) { }
 
     virtual ClassType* Clone() const override { return new ClassType(*this); }
 
     /// Invoke the bound delegate function. 
     virtual void operator()(Param1 p1, Param2 p2, Param3 p3, Param4 p4, Param5 p5) override {
-        m_stream << m_id << std::ends;
-        m_stream << p1 << std::ends;
-        m_stream << p2 << std::ends;
-        m_stream << p3 << std::ends;
-        m_stream << p4 << std::ends;
-        m_stream << p5 << std::ends;
-        m_transport.DispatchDelegate(m_stream);
+        std::ostream& s = BeginSend();
+        RemoteWrite(s, p1);
+        RemoteWrite(s, p2);
+        RemoteWrite(s, p3);
+        RemoteWrite(s, p4);
+        RemoteWrite(s, p5);
+        EndSend(s);
     }
 
     virtual bool operator==(const DelegateBase& rhs) const override {
-        auto* derivedRhs = dynamic_cast<const ClassType*>(&rhs);
+        auto derivedRhs = dynamic_cast<const ClassType*>(&rhs);
         return derivedRhs &&
-            m_id == derivedRhs->m_id &&
-            &m_transport == &derivedRhs->m_transport;
+            IsEqual(*derivedRhs);
     }
-
-private:
-    IDelegateTransport & m_transport;   // Object sends data to remote
-    std::iostream& m_stream;            // Storage for remote message 
-    DelegateIdType m_id = 0;                // Remote delegate identifier
 };
 
 //N=1
@@ -181,30 +228,80 @@ DelegateRemoteSend<void(Param1)> MakeDelegate(IDelegateTransport& transport, std
     return DelegateRemoteSend<void(Param1)>(transport, stream, id);
 }
 
+template <class Param1>
+DelegateRemoteSend<void(Param1)> MakeDelegate(IDelegateBufferTransport& transport, DelegateIdType id) {
+    return DelegateRemoteSend<void(Param1)>(transport, id);
+}
+
+template <class Param1>
+DelegateRemoteSend<void(Param1)> MakeDelegate(IDelegateTransport& transport, DelegateIdType id) {
+    return DelegateRemoteSend<void(Param1)>(transport, id);
+}
+
 //N=2
 template <class Param1, class Param2>
 DelegateRemoteSend<void(Param1, Param2)> MakeDelegate(IDelegateTransport& transport, std::iostream& stream, DelegateIdType id) {
     return DelegateRemoteSend<void(Param1, Param2)>(transport, stream, id);
 }
 
+template <class Param1, class Param2>
+DelegateRemoteSend<void(Param1, Param2)> MakeDelegate(IDelegateBufferTransport& transport, DelegateIdType id) {
+    return DelegateRemoteSend<void(Param1, Param2)>(transport, id);
+}
+
+template <class Param1, class Param2>
+DelegateRemoteSend<void(Param1, Param2)> MakeDelegate(IDelegateTransport& transport, DelegateIdType id) {
+    return DelegateRemoteSend<void(Param1, Param2)>(transport, id);
+}
+
 //N=3
 template <class Param1, class Param2, class Param3>
 DelegateRemoteSend<void(Param1, Param2, Param3)> MakeDelegate(IDelegateTransport& transport, std::iostream& stream, DelegateIdType id) {
     return DelegateRemoteSend<void(Param1, Param2, Param3)>(transport, stream, id);
 }
 
+template <class Param1, class Param2, class Param3>
+DelegateRemoteSend<void(Param1, Param2, Param3)> MakeDelegate(IDelegateBufferTransport& transport, DelegateIdType id) {
+    return DelegateRemoteSend<void(Param1, Param2, Param3)>(transport, id);
+}
+
+template <class Param1, class Param2, class Param3>
+DelegateRemoteSend<void(Param1, Param2, Param3)> MakeDelegate(IDelegateTransport& transport, DelegateIdType id) {
+    return DelegateRemoteSend<void(Param1, Param2, Param3)>(transport, id);
+}
+
 //N=4
 template <class Param1, class Param2, class Param3, class Param4>
 DelegateRemoteSend<void(Param1, Param2, Param3, Param4)> MakeDelegate(IDelegateTransport& transport, std::iostream& stream, DelegateIdType id) {
     return DelegateRemoteSend<void(Param1, Param2, Param3, Param4)>(transport, stream, id);
 }
 
+template <class Param1, class Param2, class Param3, class Param4>
+DelegateRemoteSend<void(Param1, Param2, Param3, Param4)> MakeDelegate(IDelegateBufferTransport& transport, DelegateIdType id) {
+    return DelegateRemoteSend<void(Param1, Param2, Param3, Param4)>(transport, id);
+}
+
+template <class Param1, class Param2, class Param3, class Param4>
+DelegateRemoteSend<void(Param1, Param2, Param3, Param4)> MakeDelegate(IDelegateTransport& transport, DelegateIdType id) {
+    return DelegateRemoteSend<void(Param1, Param2, Param3, Param4)>(transport, id);
+}
+
 //N=5
 template <class Param1, class Param2, class Param3, class Param4, class Param5>
 DelegateRemoteSend<void(Param1, Param2, Param3, Param4, Param5)> MakeDelegate(IDelegateTransport& transport, std::iostream& stream, DelegateIdType id) {
     return DelegateRemoteSend<void(Param1, Param2, Param3, Param4, Param5)>(transport, stream, id);
 }
 
+template <class Param1, class Param2, class Param3, class Param4, class Param5>
+DelegateRemoteSend<void(Param1, Param2, Param3, Param4, Param5)> MakeDelegate(IDelegateBufferTransport& transport, DelegateIdType id) {
+    return DelegateRemoteSend<void(Param1, Param2, Param3, Param4, Param5)>(transport, id);
+}
+
+template <class Param1, class Param2, class Param3, class Param4, class Param5>
+DelegateRemoteSend<void(Param1, Param2, Param3, Param4, Param5)> MakeDelegate(IDelegateTransport& transport, DelegateIdType id) {
+    return DelegateRemoteSend<void(Param1, Param2, Param3, Param4, Param5)>(transport, id);
+}
+
 }
 
 #endif
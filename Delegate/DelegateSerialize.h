@@ -0,0 +1,288 @@
+#ifndef _DELEGATE_SERIALIZE_H
+#define _DELEGATE_SERIALIZE_H
+
+// DelegateSerialize.h
+// @see https://github.com/endurodave/AsyncMulticastDelegateCpp11
+//
+// Compile time generated binary serialization of remote delegate arguments. List
+// the fields of a struct or class with DELEGATE_FIELDS and the remote delegates
+// encode it in binary instead of calling a user written operator<< / operator>>:
+//
+//     class RemoteData
+//     {
+//     public:
+//         int x = 0;
+//         std::string name;
+//         std::vector<Point> points;
+//         DELEGATE_FIELDS(x, name, points)
+//     };
+//
+// Fields may be arithmetic or enum types, nested DELEGATE_FIELDS types, std::string,
+// std::vector, std::array or any other trivially copyable type except a raw pointer,
+// which fails to compile. A std::vector or std::array of trivially copyable elements
+// is copied in one block. Values use the
+// host byte order and layout, so both systems must share the same architecture.
+// A sequence length read from the wire is checked against the bytes remaining in
+// the stream (or DELEGATE_REMOTE_MAX_FRAME_SIZE if unknown); a corrupt length sets
+// failbit rather than allocating.
+
+#include "DelegateOpt.h"
+#include <array>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/// Declare the fields serialized for a remote delegate argument type. Place inside
+/// the class definition; private fields may be listed.
+#define DELEGATE_FIELDS(...) \
+    friend struct DelegateLib::DelegateAccess; \
+    typedef void DelegateFieldsTag; \
+    template <class DelegateArchive> \
+    void DelegateFields(DelegateArchive& delegateArchive) { delegateArchive(__VA_ARGS__); }
+
+namespace DelegateLib {
+
+/// @brief Grants the serializer access to a class's DELEGATE_FIELDS members.
+struct DelegateAccess
+{
+    template <class T>
+    static std::true_type HasFields(typename T::DelegateFieldsTag*);
+
+    template <class T>
+    static std::false_type HasFields(...);
+
+    template <class T, class Archive>
+    static void Fields(T& obj, Archive& archive) { obj.DelegateFields(archive); }
+};
+
+/// @brief True if T declares its fields with DELEGATE_FIELDS.
+template <class T>
+struct HasDelegateFields : decltype(DelegateAccess::HasFields<T>(nullptr)) { };
+
+/// @brief True if a contiguous sequence of T may be copied as one block of bytes.
+/// Pointers are excluded so each element reaches the DelegateSerializer check.
+template <class T>
+struct IsDelegateBlockCopyable : std::integral_constant<bool,
+    std::is_trivially_copyable<T>::value && !std::is_pointer<T>::value && !HasDelegateFields<T>::value> { };
+
+/// Read a sequence length written by a DelegateSerializer.
+/// @param[in] minBytes - the fewest encoded bytes per element.
+/// @return The length, or 0 with failbit set if the stream cannot hold that many elements.
+inline uint32_t DelegateReadSize(std::istream& s, size_t minBytes)
+{
+    uint32_t size = 0;
+    s.read(reinterpret_cast<char*>(&size), sizeof(size));
+    if (!s.good()) {
+        s.setstate(std::ios::failbit);
+        return 0;
+    }
+
+    // in_avail() is the exact remainder for the memory backed streams used by the 
+    // remote delegates; 0 means unknown and -1 means no more input
+    std::streamsize avail = s.rdbuf()->in_avail();
+    uint64_t limit = avail > 0 ? (uint64_t)avail : (avail < 0 ? 0 : DELEGATE_REMOTE_MAX_FRAME_SIZE);
+    if ((uint64_t)size * minBytes > limit) {
+        s.setstate(std::ios::failbit);
+        return 0;
+    }
+    return size;
+}
+
+/// @brief Binary encoder/decoder for one type. Specialized below for field listed
+/// types and the supported standard containers.
+template <class T, class Enable = void>
+struct DelegateSerializer
+{
+    static_assert(std::is_trivially_copyable<T>::value,
+        "Remote argument type is not serializable. Add DELEGATE_FIELDS to the type.");
+    static_assert(!std::is_pointer<T>::value,
+        "Remote field or element is a pointer, whose address means nothing to the receiver. Send the pointed to value.");
+
+    static void Write(std::ostream& s, const T& value) {
+        s.write(reinterpret_cast<const char*>(&value), sizeof(T)); }
+
+    static void Read(std::istream& s, T& value) {
+        s.read(reinterpret_cast<char*>(&value), sizeof(T)); }
+};
+
+/// @brief Encodes each field passed by DELEGATE_FIELDS.
+class DelegateFieldWriter
+{
+public:
+    DelegateFieldWriter(std::ostream& s) : m_s(s) { }
+
+    template <class... Fields>
+    void operator()(const Fields&... fields) {
+        // Braced initializer list guarantees left to right evaluation
+        int expand[] = { 0, (DelegateSerializer<Fields>::Write(m_s, fields), 0)... };
+        (void)expand;
+    }
+
+private:
+    std::ostream& m_s;
+};
+
+/// @brief Decodes each field passed by DELEGATE_FIELDS.
+class DelegateFieldReader
+{
+public:
+    DelegateFieldReader(std::istream& s) : m_s(s) { }
+
+    template <class... Fields>
+    void operator()(Fields&... fields) {
+        int expand[] = { 0, (DelegateSerializer<Fields>::Read(m_s, fields), 0)... };
+        (void)expand;
+    }
+
+private:
+    std::istream& m_s;
+};
+
+template <class T>
+struct DelegateSerializer<T, typename std::enable_if<HasDelegateFields<T>::value>::type>
+{
+    static void Write(std::ostream& s, const T& value) {
+        DelegateFieldWriter writer(s);
+        DelegateAccess::Fields(const_cast<T&>(value), writer);
+    }
+
+    static void Read(std::istream& s, T& value) {
+        DelegateFieldReader reader(s);
+        DelegateAccess::Fields(value, reader);
+    }
+};
+
+template <>
+struct DelegateSerializer<std::string>
+{
+    static void Write(std::ostream& s, const std::string& value) {
+        uint32_t size = (uint32_t)value.size();
+        s.write(reinterpret_cast<const char*>(&size), sizeof(size));
+        s.write(value.data(), size);
+    }
+
+    static void Read(std::istream& s, std::string& value) {
+        uint32_t size = DelegateReadSize(s, 1);
+        if (!s.good())
+            return;
+        value.resize(size);
+        if (size)
+            s.read(&value[0], size);
+    }
+};
+
+/// @brief Encode a sequence of elements, as one block if the elements allow it.
+template <class T>
+struct DelegateElements
+{
+    template <bool Block = IsDelegateBlockCopyable<T>::value>
+    static typename std::enable_if<Block>::type Write(std::ostream& s, const T* data, size_t count) {
+        s.write(reinterpret_cast<const char*>(data), count * sizeof(T)); }
+
+    template <bool Block = IsDelegateBlockCopyable<T>::value>
+    static typename std::enable_if<!Block>::type Write(std::ostream& s, const T* data, size_t count) {
+        for (size_t i = 0; i < count; i++)
+            DelegateSerializer<T>::Write(s, data[i]);
+    }
+
+    template <bool Block = IsDelegateBlockCopyable<T>::value>
+    static typename std::enable_if<Block>::type Read(std::istream& s, T* data, size_t count) {
+        s.read(reinterpret_cast<char*>(data), count * sizeof(T)); }
+
+    template <bool Block = IsDelegateBlockCopyable<T>::value>
+    static typename std::enable_if<!Block>::type Read(std::istream& s, T* data, size_t count) {
+        for (size_t i = 0; i < count; i++)
+            DelegateSerializer<T>::Read(s, data[i]);
+    }
+};
+
+template <class T, class Alloc>
+struct DelegateSerializer<std::vector<T, Alloc>>
+{
+    static void Write(std::ostream& s, const std::vector<T, Alloc>& value) {
+        uint32_t size = (uint32_t)value.size();
+        s.write(reinterpret_cast<const char*>(&size), sizeof(size));
+        if (size)
+            DelegateElements<T>::Write(s, &value[0], size);
+    }
+
+    static void Read(std::istream& s, std::vector<T, Alloc>& value) {
+        uint32_t size = DelegateReadSize(s, IsDelegateBlockCopyable<T>::value ? sizeof(T) : 1);
+        if (!s.good())
+            return;
+        value.resize(size);
+        if (size)
+            DelegateElements<T>::Read(s, &value[0], size);
+    }
+};
+
+// std::vector<bool> is not contiguous; encode one byte per element
+template <class Alloc>
+struct DelegateSerializer<std::vector<bool, Alloc>>
+{
+    static void Write(std::ostream& s, const std::vector<bool, Alloc>& value) {
+        uint32_t size = (uint32_t)value.size();
+        s.write(reinterpret_cast<const char*>(&size), sizeof(size));
+        for (bool b : value)
+            s.put(b ? 1 : 0);
+    }
+
+    static void Read(std::istream& s, std::vector<bool, Alloc>& value) {
+        uint32_t size = DelegateReadSize(s, 1);
+        if (!s.good())
+            return;
+        value.resize(size);
+        for (uint32_t i = 0; i < size; i++)
+            value[i] = s.get() != 0;
+    }
+};
+
+template <class T, size_t N>
+struct DelegateSerializer<std::array<T, N>>
+{
+    static void Write(std::ostream& s, const std::array<T, N>& value) {
+        DelegateElements<T>::Write(s, value.data(), N); }
+
+    static void Read(std::istream& s, std::array<T, N>& value) {
+        DelegateElements<T>::Read(s, value.data(), N); }
+};
+
+/// Write one remote delegate argument followed by the argument terminator. Types
+/// declaring DELEGATE_FIELDS are encoded in binary; all others use operator<<.
+template <class T>
+typename std::enable_if<!HasDelegateFields<T>::value>::type RemoteWrite(std::ostream& s, const T& value) {
+    s << value << std::ends; }
+
+template <class T>
+typename std::enable_if<HasDelegateFields<T>::value>::type RemoteWrite(std::ostream& s, const T& value) {
+    DelegateSerializer<T>::Write(s, value);
+    s << std::ends;
+}
+
+template <class T>
+typename std::enable_if<HasDelegateFields<T>::value>::type RemoteWrite(std::ostream& s, T* value) {
+    RemoteWrite(s, *value); }
+
+/// Read one remote delegate argument written by RemoteWrite() and skip the terminator.
+template <class T>
+typename std::enable_if<!HasDelegateFields<T>::value>::type RemoteRead(std::istream& s, T& value) {
+    s >> value;
+    s.seekg(s.tellg() + std::streampos(1));
+}
+
+template <class T>
+typename std::enable_if<HasDelegateFields<T>::value>::type RemoteRead(std::istream& s, T& value) {
+    DelegateSerializer<T>::Read(s, value);
+    s.seekg(s.tellg() + std::streampos(1));
+}
+
+template <class T>
+typename std::enable_if<HasDelegateFields<T>::value>::type RemoteRead(std::istream& s, T*& value) {
+    RemoteRead(s, *value); }
+
+}
+
+#endif
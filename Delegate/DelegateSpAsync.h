@@ -10,6 +10,7 @@
 
 #include "DelegateSp.h"
 #include "IDelegateThread.h"
+#include "DelegateAsync.h"
 #include "DelegateInvoker.h"
 
 namespace DelegateLib {
@@ -29,8 +30,8 @@ public:
     using BaseType = DelegateMemberSp<void(TClass(void))>;
 
 	// Contructors take a class instance, member function, and delegate thread
-	DelegateMemberSpAsync(ObjectPtr object, MemberFunc func, DelegateThread& thread) : BaseType(object, func), m_thread(thread) { Bind(object, func, thread); }
-	DelegateMemberSpAsync(ObjectPtr object, ConstMemberFunc func, DelegateThread& thread) : BaseType(object, func), m_thread(thread) { Bind(object, func, thread); }
+	DelegateMemberSpAsync(ObjectPtr object, MemberFunc func, DelegateThread& thread, IDelegateAllocator* allocator = nullptr) : BaseType(object, func), m_thread(thread), m_allocator(allocator) { Bind(object, func, thread); }
+	DelegateMemberSpAsync(ObjectPtr object, ConstMemberFunc func, DelegateThread& thread, IDelegateAllocator* allocator = nullptr) : BaseType(object, func), m_thread(thread), m_allocator(allocator) { Bind(object, func, thread); }
 	DelegateMemberSpAsync() = delete;
 
 	/// Bind a member function to a delegate. 
@@ -43,6 +44,9 @@ public:
 		m_thread = thread;
 		BaseType::Bind(object, func); }
 
+	/// Get the allocator for messages, clones and argument copies, or nullptr for the default.
+	IDelegateAllocator* GetAllocator() const { return m_allocator ? m_allocator : m_thread.GetAllocator(); }
+
 	virtual ClassType* Clone() const override { return new ClassType(*this); }
 
 	virtual bool operator==(const DelegateBase& rhs) const override {
@@ -54,10 +58,10 @@ public:
 	/// Invoke delegate function asynchronously
 	virtual void operator()() override {
 		// Create a clone instance of this delegate 
-		auto delegate = std::shared_ptr<ClassType>(Clone());
+		auto delegate = MakeDelegateClone(*this, GetAllocator());
 
 		// Create a new message instance 
-		auto msg = std::make_shared<DelegateMsgBase>(delegate);
+		auto msg = MakeDelegateMsg<DelegateMsgBase>(GetAllocator(), m_thread, delegate);
 
 		// Dispatch message onto the callback destination thread. DelegateInvoke()
 		// will be called by the target thread. 
@@ -73,6 +77,9 @@ public:
 private:
 	/// Target thread to invoke the delegate function
 	DelegateThread& m_thread;
+
+	/// Allocator for messages, clones and argument copies, or nullptr for the thread default
+	IDelegateAllocator* m_allocator;
 };
 
 template <class TClass, class Param1> 
@@ -85,8 +92,8 @@ public:
     using BaseType = DelegateMemberSp<void(TClass(Param1))>;
 
 	// Contructors take a class instance, member function, and callback thread
-	DelegateMemberSpAsync(ObjectPtr object, MemberFunc func, DelegateThread& thread) : BaseType(object, func), m_thread(thread) { Bind(object, func, thread); }
-	DelegateMemberSpAsync(ObjectPtr object, ConstMemberFunc func, DelegateThread& thread) : BaseType(object, func), m_thread(thread) { Bind(object, func, thread); }
+	DelegateMemberSpAsync(ObjectPtr object, MemberFunc func, DelegateThread& thread, IDelegateAllocator* allocator = nullptr) : BaseType(object, func), m_thread(thread), m_allocator(allocator) { Bind(object, func, thread); }
+	DelegateMemberSpAsync(ObjectPtr object, ConstMemberFunc func, DelegateThread& thread, IDelegateAllocator* allocator = nullptr) : BaseType(object, func), m_thread(thread), m_allocator(allocator) { Bind(object, func, thread); }
 	DelegateMemberSpAsync() = delete;
 
 	/// Bind a member function to a delegate. 
@@ -99,6 +106,9 @@ public:
 		m_thread = thread;
 		BaseType::Bind(object, func); }
 
+	/// Get the allocator for messages, clones and argument copies, or nullptr for the default.
+	IDelegateAllocator* GetAllocator() const { return m_allocator ? m_allocator : m_thread.GetAllocator(); }
+
 	virtual ClassType* Clone() const override { return new ClassType(*this); }
 
 	virtual bool operator==(const DelegateBase& rhs) const override {
@@ -110,13 +120,13 @@ public:
 	/// Invoke delegate function asynchronously
 	virtual void operator()(Param1 p1) override {
 		// Create a new instance of the function argument data and copy
-		Param1 heapParam1 = DelegateParam<Param1>::New(p1);
+		Param1 heapParam1 = NewDelegateParam<Param1>(p1, GetAllocator(), 0);
 
 		// Create a clone instance of this delegate 
-		auto delegate = std::shared_ptr<ClassType>(Clone());
+		auto delegate = MakeDelegateClone(*this, GetAllocator());
 
 		// Create a new message instance 
-		auto msg = std::make_shared<DelegateMsg1<Param1>>(delegate, heapParam1);
+		auto msg = MakeDelegateMsg<DelegateMsg1<Param1>>(GetAllocator(), m_thread, delegate, heapParam1);
 
 		// Dispatch message onto the callback destination thread. DelegateInvoke()
 		// will be called by the target thread. 
@@ -140,12 +150,15 @@ public:
 		BaseType::operator()(param1);
 
 		// Delete heap data created inside operator()
-		DelegateParam<Param1>::Delete(param1);
+		DeleteDelegateParam<Param1>(param1, GetAllocator(), 0);
 	}
 
 private:
 	/// Target thread to invoke the delegate function
 	DelegateThread& m_thread;
+
+	/// Allocator for messages, clones and argument copies, or nullptr for the thread default
+	IDelegateAllocator* m_allocator;
 };
 
 template <class TClass, class Param1, class Param2> 
@@ -158,8 +171,8 @@ public:
     using BaseType = DelegateMemberSp<void(TClass(Param1, Param2))>;
 
 	// Contructors take a class instance, member function, and callback thread
-	DelegateMemberSpAsync(ObjectPtr object, MemberFunc func, DelegateThread& thread) : BaseType(object, func), m_thread(thread) { Bind(object, func, thread); }
-	DelegateMemberSpAsync(ObjectPtr object, ConstMemberFunc func, DelegateThread& thread) : BaseType(object, func), m_thread(thread) { Bind(object, func, thread); }
+	DelegateMemberSpAsync(ObjectPtr object, MemberFunc func, DelegateThread& thread, IDelegateAllocator* allocator = nullptr) : BaseType(object, func), m_thread(thread), m_allocator(allocator) { Bind(object, func, thread); }
+	DelegateMemberSpAsync(ObjectPtr object, ConstMemberFunc func, DelegateThread& thread, IDelegateAllocator* allocator = nullptr) : BaseType(object, func), m_thread(thread), m_allocator(allocator) { Bind(object, func, thread); }
 	DelegateMemberSpAsync() = delete;
 
 	/// Bind a member function to a delegate. 
@@ -172,6 +185,9 @@ public:
 		m_thread = thread;
 		BaseType::Bind(object, func); }
 
+	/// Get the allocator for messages, clones and argument copies, or nullptr for the default.
+	IDelegateAllocator* GetAllocator() const { return m_allocator ? m_allocator : m_thread.GetAllocator(); }
+
 	virtual ClassType* Clone() const override {	return new ClassType(*this); }
 
 	virtual bool operator==(const DelegateBase& rhs) const override {
@@ -183,14 +199,14 @@ public:
 	/// Invoke delegate function asynchronously
 	virtual void operator()(Param1 p1, Param2 p2) override {
 		// Create a new instance of the function argument data and copy
-		Param1 heapParam1 = DelegateParam<Param1>::New(p1);
-		Param2 heapParam2 = DelegateParam<Param2>::New(p2);
+		Param1 heapParam1 = NewDelegateParam<Param1>(p1, GetAllocator(), 0);
+		Param2 heapParam2 = NewDelegateParam<Param2>(p2, GetAllocator(), 0);
 
 		// Create a clone instance of this delegate 
-		auto delegate = std::shared_ptr<ClassType>(Clone());
+		auto delegate = MakeDelegateClone(*this, GetAllocator());
 
 		// Create a new message instance 
-		auto msg = std::make_shared<DelegateMsg2<Param1, Param2>>(delegate, heapParam1, heapParam2);
+		auto msg = MakeDelegateMsg<DelegateMsg2<Param1, Param2>>(GetAllocator(), m_thread, delegate, heapParam1, heapParam2);
 
 		// Dispatch message onto the callback destination thread. DelegateInvoke()
 		// will be called by the target thread. 
@@ -216,13 +232,16 @@ public:
 		BaseType::operator()(param1, param2);
 
 		// Delete heap data created inside operator()
-		DelegateParam<Param1>::Delete(param1);
-		DelegateParam<Param2>::Delete(param2);
+		DeleteDelegateParam<Param1>(param1, GetAllocator(), 0);
+		DeleteDelegateParam<Param2>(param2, GetAllocator(), 0);
 	}
 
 private:
 	/// Target thread to invoke the delegate function
 	DelegateThread& m_thread;
+
+	/// Allocator for messages, clones and argument copies, or nullptr for the thread default
+	IDelegateAllocator* m_allocator;
 };
 
 template <class TClass, class Param1, class Param2, class Param3> 
@@ -235,8 +254,8 @@ public:
     using BaseType = DelegateMemberSp<void(TClass(Param1, Param2, Param3))>;
 
 	// Contructors take a class instance, member function, and callback thread
-	DelegateMemberSpAsync(ObjectPtr object, MemberFunc func, DelegateThread& thread) : BaseType(object, func), m_thread(thread) { Bind(object, func, thread); }
-	DelegateMemberSpAsync(ObjectPtr object, ConstMemberFunc func, DelegateThread& thread) : BaseType(object, func), m_thread(thread) { Bind(object, func, thread); }
+	DelegateMemberSpAsync(ObjectPtr object, MemberFunc func, DelegateThread& thread, IDelegateAllocator* allocator = nullptr) : BaseType(object, func), m_thread(thread), m_allocator(allocator) { Bind(object, func, thread); }
+	DelegateMemberSpAsync(ObjectPtr object, ConstMemberFunc func, DelegateThread& thread, IDelegateAllocator* allocator = nullptr) : BaseType(object, func), m_thread(thread), m_allocator(allocator) { Bind(object, func, thread); }
 	DelegateMemberSpAsync() = delete;
 
 	/// Bind a member function to a delegate. 
@@ -249,6 +268,9 @@ public:
 		m_thread = thread;
 		BaseType::Bind(object, func); }
 
+	/// Get the allocator for messages, clones and argument copies, or nullptr for the default.
+	IDelegateAllocator* GetAllocator() const { return m_allocator ? m_allocator : m_thread.GetAllocator(); }
+
 	virtual ClassType* Clone() const override {	return new ClassType(*this); }
 
 	virtual bool operator==(const DelegateBase& rhs) const override {
@@ -260,15 +282,15 @@ public:
 	/// Invoke delegate function asynchronously
 	virtual void operator()(Param1 p1, Param2 p2, Param3 p3) override {
 		// Create a new instance of the function argument data and copy
-		Param1 heapParam1 = DelegateParam<Param1>::New(p1);
-		Param2 heapParam2 = DelegateParam<Param2>::New(p2);
-		Param3 heapParam3 = DelegateParam<Param3>::New(p3);
+		Param1 heapParam1 = NewDelegateParam<Param1>(p1, GetAllocator(), 0);
+		Param2 heapParam2 = NewDelegateParam<Param2>(p2, GetAllocator(), 0);
+		Param3 heapParam3 = NewDelegateParam<Param3>(p3, GetAllocator(), 0);
 
 		// Create a clone instance of this delegate 
-		auto delegate = std::shared_ptr<ClassType>(Clone());
+		auto delegate = MakeDelegateClone(*this, GetAllocator());
 
 		// Create a new message instance 
-		auto msg = std::make_shared<DelegateMsg3<Param1, Param2, Param3>>(delegate, heapParam1, heapParam2, heapParam3);
+		auto msg = MakeDelegateMsg<DelegateMsg3<Param1, Param2, Param3>>(GetAllocator(), m_thread, delegate, heapParam1, heapParam2, heapParam3);
 
 		// Dispatch message onto the callback destination thread. DelegateInvoke()
 		// will be called by the target thread. 
@@ -296,14 +318,17 @@ public:
 		BaseType::operator()(param1, param2, param3);
 
 		// Delete heap data created inside operator()
-		DelegateParam<Param1>::Delete(param1);
-		DelegateParam<Param2>::Delete(param2);
-		DelegateParam<Param3>::Delete(param3);
+		DeleteDelegateParam<Param1>(param1, GetAllocator(), 0);
+		DeleteDelegateParam<Param2>(param2, GetAllocator(), 0);
+		DeleteDelegateParam<Param3>(param3, GetAllocator(), 0);
 	}
 
 private:
 	/// Target thread to invoke the delegate function
 	DelegateThread& m_thread;
+
+	/// Allocator for messages, clones and argument copies, or nullptr for the thread default
+	IDelegateAllocator* m_allocator;
 };
 
 template <class TClass, class Param1, class Param2, class Param3, class Param4> 
@@ -316,8 +341,8 @@ public:
     using BaseType = DelegateMemberSp<void(TClass(Param1, Param2, Param3, Param4))>;
 
 	// Contructors take a class instance, member function, and callback thread
-	DelegateMemberSpAsync(ObjectPtr object, MemberFunc func, DelegateThread& thread) : BaseType(object, func), m_thread(thread) { Bind(object, func, thread); }
-	DelegateMemberSpAsync(ObjectPtr object, ConstMemberFunc func, DelegateThread& thread) : BaseType(object, func), m_thread(thread) { Bind(object, func, thread); }
+	DelegateMemberSpAsync(ObjectPtr object, MemberFunc func, DelegateThread& thread, IDelegateAllocator* allocator = nullptr) : BaseType(object, func), m_thread(thread), m_allocator(allocator) { Bind(object, func, thread); }
+	DelegateMemberSpAsync(ObjectPtr object, ConstMemberFunc func, DelegateThread& thread, IDelegateAllocator* allocator = nullptr) : BaseType(object, func), m_thread(thread), m_allocator(allocator) { Bind(object, func, thread); }
 	DelegateMemberSpAsync() = delete;
 
 	/// Bind a member function to a delegate. 
@@ -330,6 +355,9 @@ public:
 		m_thread = thread;
 		BaseType::Bind(object, func); }
 
+	/// Get the allocator for messages, clones and argument copies, or nullptr for the default.
+	IDelegateAllocator* GetAllocator() const { return m_allocator ? m_allocator : m_thread.GetAllocator(); }
+
 	virtual ClassType* Clone() const override { return new ClassType(*this); }
 
 	virtual bool operator==(const DelegateBase& rhs) const override {
@@ -341,16 +369,16 @@ public:
 	/// Invoke delegate function asynchronously
 	virtual void operator()(Param1 p1, Param2 p2, Param3 p3, Param4 p4) override {
 		// Create a new instance of the function argument data and copy
-		Param1 heapParam1 = DelegateParam<Param1>::New(p1);
-		Param2 heapParam2 = DelegateParam<Param2>::New(p2);
-		Param3 heapParam3 = DelegateParam<Param3>::New(p3);
-		Param4 heapParam4 = DelegateParam<Param4>::New(p4);
+		Param1 heapParam1 = NewDelegateParam<Param1>(p1, GetAllocator(), 0);
+		Param2 heapParam2 = NewDelegateParam<Param2>(p2, GetAllocator(), 0);
+		Param3 heapParam3 = NewDelegateParam<Param3>(p3, GetAllocator(), 0);
+		Param4 heapParam4 = NewDelegateParam<Param4>(p4, GetAllocator(), 0);
 
 		// Create a clone instance of this delegate 
-		auto delegate = std::shared_ptr<ClassType>(Clone());
+		auto delegate = MakeDelegateClone(*this, GetAllocator());
 
 		// Create a new message instance 
-		auto msg = std::make_shared<DelegateMsg4<Param1, Param2, Param3, Param4>>(delegate, heapParam1, heapParam2, heapParam3, heapParam4);
+		auto msg = MakeDelegateMsg<DelegateMsg4<Param1, Param2, Param3, Param4>>(GetAllocator(), m_thread, delegate, heapParam1, heapParam2, heapParam3, heapParam4);
 
 		// Dispatch message onto the callback destination thread. DelegateInvoke()
 		// will be called by the target thread. 
@@ -380,15 +408,18 @@ public:
 		BaseType::operator()(param1, param2, param3, param4);
 
 		// Delete heap data created inside operator()
-		DelegateParam<Param1>::Delete(param1);
-		DelegateParam<Param2>::Delete(param2);
-		DelegateParam<Param3>::Delete(param3);
-		DelegateParam<Param4>::Delete(param4);
+		DeleteDelegateParam<Param1>(param1, GetAllocator(), 0);
+		DeleteDelegateParam<Param2>(param2, GetAllocator(), 0);
+		DeleteDelegateParam<Param3>(param3, GetAllocator(), 0);
+		DeleteDelegateParam<Param4>(param4, GetAllocator(), 0);
 	}
 
 private:
 	/// Target thread to invoke the delegate function
 	DelegateThread& m_thread;
+
+	/// Allocator for messages, clones and argument copies, or nullptr for the thread default
+	IDelegateAllocator* m_allocator;
 };
 
 template <class TClass, class Param1, class Param2, class Param3, class Param4, class Param5> 
@@ -401,8 +432,8 @@ public:
     using BaseType = DelegateMemberSp<void(TClass(Param1, Param2, Param3, Param4, Param5))>;
 
 	// Contructors take a class instance, member function, and callback thread
-	DelegateMemberSpAsync(ObjectPtr object, MemberFunc func, DelegateThread& thread) : BaseType(object, func), m_thread(thread) { Bind(object, func, thread); }
-	DelegateMemberSpAsync(ObjectPtr object, ConstMemberFunc func, DelegateThread& thread) : BaseType(object, func), m_thread(thread) { Bind(object, func, thread); }
+	DelegateMemberSpAsync(ObjectPtr object, MemberFunc func, DelegateThread& thread, IDelegateAllocator* allocator = nullptr) : BaseType(object, func), m_thread(thread), m_allocator(allocator) { Bind(object, func, thread); }
+	DelegateMemberSpAsync(ObjectPtr object, ConstMemberFunc func, DelegateThread& thread, IDelegateAllocator* allocator = nullptr) : BaseType(object, func), m_thread(thread), m_allocator(allocator) { Bind(object, func, thread); }
 	DelegateMemberSpAsync() = delete;
 
 	/// Bind a member function to a delegate. 
@@ -415,6 +446,9 @@ public:
 		m_thread = thread;
 		BaseType::Bind(object, func); }
 
+	/// Get the allocator for messages, clones and argument copies, or nullptr for the default.
+	IDelegateAllocator* GetAllocator() const { return m_allocator ? m_allocator : m_thread.GetAllocator(); }
+
 	virtual ClassType* Clone() const override { return new ClassType(*this); }
 
 	virtual bool operator==(const DelegateBase& rhs) const override {
@@ -426,17 +460,17 @@ public:
 	/// Invoke delegate function asynchronously
 	virtual void operator()(Param1 p1, Param2 p2, Param3 p3, Param4 p4, Param5 p5) override {
 		// Create a new instance of the function argument data and copy
-		Param1 heapParam1 = DelegateParam<Param1>::New(p1);
-		Param2 heapParam2 = DelegateParam<Param2>::New(p2);
-		Param3 heapParam3 = DelegateParam<Param3>::New(p3);
-		Param4 heapParam4 = DelegateParam<Param4>::New(p4);
-		Param5 heapParam5 = DelegateParam<Param5>::New(p5);
+		Param1 heapParam1 = NewDelegateParam<Param1>(p1, GetAllocator(), 0);
+		Param2 heapParam2 = NewDelegateParam<Param2>(p2, GetAllocator(), 0);
+		Param3 heapParam3 = NewDelegateParam<Param3>(p3, GetAllocator(), 0);
+		Param4 heapParam4 = NewDelegateParam<Param4>(p4, GetAllocator(), 0);
+		Param5 heapParam5 = NewDelegateParam<Param5>(p5, GetAllocator(), 0);
 
 		// Create a clone instance of this delegate 
-		auto delegate = std::shared_ptr<ClassType>(Clone());
+		auto delegate = MakeDelegateClone(*this, GetAllocator());
 
 		// Create a new message instance 
-		auto msg = std::make_shared<DelegateMsg5<Param1, Param2, Param3, Param4, Param5>>(delegate, heapParam1, heapParam2, heapParam3, heapParam4, heapParam5);
+		auto msg = MakeDelegateMsg<DelegateMsg5<Param1, Param2, Param3, Param4, Param5>>(GetAllocator(), m_thread, delegate, heapParam1, heapParam2, heapParam3, heapParam4, heapParam5);
 
 		// Dispatch message onto the callback destination thread. DelegateInvoke()
 		// will be called by the target thread. 
@@ -468,16 +502,19 @@ public:
 		BaseType::operator()(param1, param2, param3, param4, param5);
 
 		// Delete heap data created inside operator()
-		DelegateParam<Param1>::Delete(param1);
-		DelegateParam<Param2>::Delete(param2);
-		DelegateParam<Param3>::Delete(param3);
-		DelegateParam<Param4>::Delete(param4);
-		DelegateParam<Param5>::Delete(param5);
+		DeleteDelegateParam<Param1>(param1, GetAllocator(), 0);
+		DeleteDelegateParam<Param2>(param2, GetAllocator(), 0);
+		DeleteDelegateParam<Param3>(param3, GetAllocator(), 0);
+		DeleteDelegateParam<Param4>(param4, GetAllocator(), 0);
+		DeleteDelegateParam<Param5>(param5, GetAllocator(), 0);
 	}
 
 private:
 	/// Target thread to invoke the delegate function
 	DelegateThread& m_thread;
+
+	/// Allocator for messages, clones and argument copies, or nullptr for the thread default
+	IDelegateAllocator* m_allocator;
 };
 
 //N=0
@@ -486,66 +523,126 @@ DelegateMemberSpAsync<void(TClass(void))> MakeDelegate(std::shared_ptr<TClass> o
 	return DelegateMemberSpAsync<void(TClass(void))>(object, func, thread);
 }
 
+template <class TClass>
+DelegateMemberSpAsync<void(TClass(void))> MakeDelegate(std::shared_ptr<TClass> object, void (TClass::*func)(), DelegateThread& thread, IDelegateAllocator& allocator) {
+	return DelegateMemberSpAsync<void(TClass(void))>(object, func, thread, &allocator);
+}
+
 template <class TClass>
 DelegateMemberSpAsync<void(TClass(void))> MakeDelegate(std::shared_ptr<TClass> object, void (TClass::*func)() const, DelegateThread& thread) {
 	return DelegateMemberSpAsync<void(TClass(void))>(object, func, thread);
 }
 
+template <class TClass>
+DelegateMemberSpAsync<void(TClass(void))> MakeDelegate(std::shared_ptr<TClass> object, void (TClass::*func)() const, DelegateThread& thread, IDelegateAllocator& allocator) {
+	return DelegateMemberSpAsync<void(TClass(void))>(object, func, thread, &allocator);
+}
+
 //N=1
 template <class TClass, class Param1>
 DelegateMemberSpAsync<void(TClass(Param1))> MakeDelegate(std::shared_ptr<TClass> object, void (TClass::*func)(Param1 p1), DelegateThread& thread) {
 	return DelegateMemberSpAsync<void(TClass(Param1))>(object, func, thread);
 }
 
+template <class TClass, class Param1>
+DelegateMemberSpAsync<void(TClass(Param1))> MakeDelegate(std::shared_ptr<TClass> object, void (TClass::*func)(Param1 p1), DelegateThread& thread, IDelegateAllocator& allocator) {
+	return DelegateMemberSpAsync<void(TClass(Param1))>(object, func, thread, &allocator);
+}
+
 template <class TClass, class Param1>
 DelegateMemberSpAsync<void(TClass(Param1))> MakeDelegate(std::shared_ptr<TClass> object, void (TClass::*func)(Param1 p1) const, DelegateThread& thread) {
 	return DelegateMemberSpAsync<void(TClass(Param1))>(object, func, thread);
 }
 
+template <class TClass, class Param1>
+DelegateMemberSpAsync<void(TClass(Param1))> MakeDelegate(std::shared_ptr<TClass> object, void (TClass::*func)(Param1 p1) const, DelegateThread& thread, IDelegateAllocator& allocator) {
+	return DelegateMemberSpAsync<void(TClass(Param1))>(object, func, thread, &allocator);
+}
+
 //N=2
 template <class TClass, class Param1, class Param2>
 DelegateMemberSpAsync<void(TClass(Param1, Param2))> MakeDelegate(std::shared_ptr<TClass> object, void (TClass::*func)(Param1 p1, Param2 p2), DelegateThread& thread) {
 	return DelegateMemberSpAsync<void(TClass(Param1, Param2))>(object, func, thread);
 }
 
+template <class TClass, class Param1, class Param2>
+DelegateMemberSpAsync<void(TClass(Param1, Param2))> MakeDelegate(std::shared_ptr<TClass> object, void (TClass::*func)(Param1 p1, Param2 p2), DelegateThread& thread, IDelegateAllocator& allocator) {
+	return DelegateMemberSpAsync<void(TClass(Param1, Param2))>(object, func, thread, &allocator);
+}
+
 template <class TClass, class Param1, class Param2>
 DelegateMemberSpAsync<void(TClass(Param1, Param2))> MakeDelegate(std::shared_ptr<TClass> object, void (TClass::*func)(Param1 p1, Param2 p2) const, DelegateThread& thread) {
 	return DelegateMemberSpAsync<void(TClass(Param1, Param2))>(object, func, thread);
 }
 
+template <class TClass, class Param1, class Param2>
+DelegateMemberSpAsync<void(TClass(Param1, Param2))> MakeDelegate(std::shared_ptr<TClass> object, void (TClass::*func)(Param1 p1, Param2 p2) const, DelegateThread& thread, IDelegateAllocator& allocator) {
+	return DelegateMemberSpAsync<void(TClass(Param1, Param2))>(object, func, thread, &allocator);
+}
+
 //N=3
 template <class TClass, class Param1, class Param2, class Param3>
 DelegateMemberSpAsync<void(TClass(Param1, Param2, Param3))> MakeDelegate(std::shared_ptr<TClass> object, void (TClass::*func)(Param1 p1, Param2 p2, Param3 p3), DelegateThread& thread) {
 	return DelegateMemberSpAsync<void(TClass(Param1, Param2, Param3))>(object, func, thread);
 }
 
+template <class TClass, class Param1, class Param2, class Param3>
+DelegateMemberSpAsync<void(TClass(Param1, Param2, Param3))> MakeDelegate(std::shared_ptr<TClass> object, void (TClass::*func)(Param1 p1, Param2 p2, Param3 p3), DelegateThread& thread, IDelegateAllocator& allocator) {
+	return DelegateMemberSpAsync<void(TClass(Param1, Param2, Param3))>(object, func, thread, &allocator);
+}
+
 template <class TClass, class Param1, class Param2, class Param3>
 DelegateMemberSpAsync<void(TClass(Param1, Param2, Param3))> MakeDelegate(std::shared_ptr<TClass> object, void (TClass::*func)(Param1 p1, Param2 p2, Param3 p3) const, DelegateThread& thread) {
 	return DelegateMemberSpAsync<void(TClass(Param1, Param2, Param3))>(object, func, thread);
 }
 
+template <class TClass, class Param1, class Param2, class Param3>
+DelegateMemberSpAsync<void(TClass(Param1, Param2, Param3))> MakeDelegate(std::shared_ptr<TClass> object, void (TClass::*func)(Param1 p1, Param2 p2, Param3 p3) const, DelegateThread& thread, IDelegateAllocator& allocator) {
+	return DelegateMemberSpAsync<void(TClass(Param1, Param2, Param3))>(object, func, thread, &allocator);
+}
+
 //N=4
 template <class TClass, class Param1, class Param2, class Param3, class Param4>
 DelegateMemberSpAsync<void(TClass(Param1, Param2, Param3, Param4))> MakeDelegate(std::shared_ptr<TClass> object, void (TClass::*func)(Param1 p1, Param2 p2, Param3 p3, Param4 p4), DelegateThread& thread) {
 	return DelegateMemberSpAsync<void(TClass(Param1, Param2, Param3, Param4))>(object, func, thread);
 }
 
+template <class TClass, class Param1, class Param2, class Param3, class Param4>
+DelegateMemberSpAsync<void(TClass(Param1, Param2, Param3, Param4))> MakeDelegate(std::shared_ptr<TClass> object, void (TClass::*func)(Param1 p1, Param2 p2, Param3 p3, Param4 p4), DelegateThread& thread, IDelegateAllocator& allocator) {
+	return DelegateMemberSpAsync<void(TClass(Param1, Param2, Param3, Param4))>(object, func, thread, &allocator);
+}
+
 template <class TClass, class Param1, class Param2, class Param3, class Param4>
 DelegateMemberSpAsync<void(TClass(Param1, Param2, Param3, Param4))> MakeDelegate(std::shared_ptr<TClass> object, void (TClass::*func)(Param1 p1, Param2 p2, Param3 p3, Param4 p4) const, DelegateThread& thread) {
 	return DelegateMemberSpAsync<void(TClass(Param1, Param2, Param3, Param4))>(object, func, thread);
 }
 
+template <class TClass, class Param1, class Param2, class Param3, class Param4>
+DelegateMemberSpAsync<void(TClass(Param1, Param2, Param3, Param4))> MakeDelegate(std::shared_ptr<TClass> object, void (TClass::*func)(Param1 p1, Param2 p2, Param3 p3, Param4 p4) const, DelegateThread& thread, IDelegateAllocator& allocator) {
+	return DelegateMemberSpAsync<void(TClass(Param1, Param2, Param3, Param4))>(object, func, thread, &allocator);
+}
+
 //N=5
 template <class TClass, class Param1, class Param2, class Param3, class Param4, class Param5>
 DelegateMemberSpAsync<void(TClass(Param1, Param2, Param3, Param4, Param5))> MakeDelegate(std::shared_ptr<TClass> object, void (TClass::*func)(Param1 p1, Param2 p2, Param3 p3, Param4 p4, Param5 p5), DelegateThread& thread) {
 	return DelegateMemberSpAsync<void(TClass(Param1, Param2, Param3, Param4, Param5))>(object, func, thread);
 }
 
+template <class TClass, class Param1, class Param2, class Param3, class Param4, class Param5>
+DelegateMemberSpAsync<void(TClass(Param1, Param2, Param3, Param4, Param5))> MakeDelegate(std::shared_ptr<TClass> object, void (TClass::*func)(Param1 p1, Param2 p2, Param3 p3, Param4 p4, Param5 p5), DelegateThread& thread, IDelegateAllocator& allocator) {
+	return DelegateMemberSpAsync<void(TClass(Param1, Param2, Param3, Param4, Param5))>(object, func, thread, &allocator);
+}
+
 template <class TClass, class Param1, class Param2, class Param3, class Param4, class Param5>
 DelegateMemberSpAsync<void(TClass(Param1, Param2, Param3, Param4, Param5))> MakeDelegate(std::shared_ptr<TClass> object, void (TClass::*func)(Param1 p1, Param2 p2, Param3 p3, Param4 p4, Param5 p5) const, DelegateThread& thread) {
 	return DelegateMemberSpAsync<void(TClass(Param1, Param2, Param3, Param4, Param5))>(object, func, thread);
 }
 
+template <class TClass, class Param1, class Param2, class Param3, class Param4, class Param5>
+DelegateMemberSpAsync<void(TClass(Param1, Param2, Param3, Param4, Param5))> MakeDelegate(std::shared_ptr<TClass> object, void (TClass::*func)(Param1 p1, Param2 p2, Param3 p3, Param4 p4, Param5 p5) const, DelegateThread& thread, IDelegateAllocator& allocator) {
+	return DelegateMemberSpAsync<void(TClass(Param1, Param2, Param3, Param4, Param5))>(object, func, thread, &allocator);
+}
+
 }
 
 #endif
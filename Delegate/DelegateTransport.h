@@ -1,7 +1,10 @@
 #ifndef _DELEGATE_TRANSPORT_H
 #define _DELEGATE_TRANSPORT_H
 
+#include "DelegateBuffer.h"
+#include <memory>
 #include <ostream>
+#include <stddef.h>
 
 namespace DelegateLib {
 
@@ -23,6 +26,60 @@ public:
     virtual void DispatchDelegate(std::iostream& s) = 0;
 };
 
+/// @brief A buffer-oriented transport. The sender serializes directly into a
+/// contiguous pooled buffer and the transport writes those bytes to the link
+/// as-is, avoiding the stringstream extraction copy required by
+/// IDelegateTransport. The receiver passes the received bytes to
+/// DelegateRemoteInvoker::Invoke(const char*, size_t).
+class IDelegateBufferTransport
+{
+public:
+    /// Destructor
+    virtual ~IDelegateBufferTransport() = default;
+
+    /// Dispatch a contiguous block of bytes to a remote system. May be called
+    /// from several threads at once if remote delegates are sent concurrently.
+    /// @param[in] data - the serialized message. Only valid for the duration of the call.
+    /// @param[in] size - the number of bytes.
+    virtual void DispatchDelegate(const char* data, size_t size) = 0;
+
+    /// Dispatch a reference counted serialized message that may also be sent to
+    /// other transports. Override to keep a reference, e.g. to queue the message
+    /// without copying it. The default sends the bytes with DispatchDelegate().
+    /// @param[in] buffer - the serialized message. Must not be modified.
+    virtual void DispatchShared(const std::shared_ptr<DelegateBufferStream>& buffer) {
+        DispatchDelegate(buffer->Data(), buffer->Size());
+    }
+};
+
+/// @brief Adapts an IDelegateBufferTransport to the legacy IDelegateTransport
+/// stream interface. A DelegateBufferStream argument is passed through without
+/// copying; any other stream is first read into a contiguous per-thread buffer,
+/// so concurrent senders may share one adapter.
+class DelegateTransportAdapter : public IDelegateTransport
+{
+public:
+    /// Constructor
+    /// @param[in] transport - the buffer transport that sends the bytes.
+    DelegateTransportAdapter(IDelegateBufferTransport& transport) : m_transport(transport) { }
+
+    virtual void DispatchDelegate(std::iostream& s) override {
+        DelegateBufferStream* buffer = dynamic_cast<DelegateBufferStream*>(&s);
+        if (buffer) {
+            m_transport.DispatchDelegate(buffer->Data(), buffer->Size());
+            return;
+        }
+
+        static thread_local DelegateBufferStream copy;
+        copy.Reset();
+        copy << s.rdbuf();
+        m_transport.DispatchDelegate(copy.Data(), copy.Size());
+    }
+
+private:
+    IDelegateBufferTransport& m_transport;
+};
+
 }
 
 #endif
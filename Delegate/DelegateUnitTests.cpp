@@ -1,12 +1,32 @@
 #ifdef DELEGATE_UNIT_TESTS
 
 #include "DelegateLib.h"
+#include "Allocator.h"
+#include "xallocator.h"
+#include "Timer.h"
 #include <iostream>
+#include <sstream>
+#include <cstring>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <array>
+#include <string>
+#include <vector>
+#include <new>
+#include <fstream>
+#include <cstdio>
 #if USE_STD_THREADS
 	#include "WorkerThreadStd.h"
 #elif USE_WIN32_THREADS
 	#include "WorkerThreadWin.h"
 #endif
+#if defined(__linux__)
+	#include "ShmTransport.h"
+	#include "SocketTransport.h"
+	#include "DelegateRecorder.h"
+	#include "DelegateReplayer.h"
+#endif
 
 using namespace DelegateLib;
 
@@ -2544,6 +2564,1233 @@ void DelegateMemberAsyncWaitTests()
 		int ret = MemberFuncIntWithReturn5Delegate(TEST_INT, TEST_INT, TEST_INT, TEST_INT, TEST_INT);
 }
 
+static std::atomic<INT> remoteRecvCnt(0);
+void RemoteRecvInt1(INT i) { ASSERT_TRUE(i == TEST_INT); remoteRecvCnt++; }
+void RemoteRecvInt2(INT i, INT i2) { ASSERT_TRUE(i == TEST_INT); ASSERT_TRUE(i2 == TEST_INT); remoteRecvCnt++; }
+void RemoteRecvOnTestThread(INT i, const INT& i2) {
+	ASSERT_TRUE(i == TEST_INT && i2 == TEST_INT);
+	ASSERT_TRUE(WorkerThread::GetCurrentThreadId() == testThread.GetThreadId());
+	remoteRecvCnt++;
+}
+INT RemoteAddInt2(INT i, const INT& i2) { return i + i2; }
+void RemoteAddComplete(bool success, INT sum) { ASSERT_TRUE(success); ASSERT_TRUE(sum == TEST_INT * 2); remoteRecvCnt++; }
+void RemoteAddExpired(bool success, INT sum) { ASSERT_TRUE(!success); ASSERT_TRUE(sum == 0); remoteRecvCnt++; }
+
+static INT remoteSerializeCnt = 0;
+struct RemotePoint
+{
+	INT x = 0;
+	INT y = 0;
+	DELEGATE_FIELDS(x, y)
+};
+
+class RemoteRecord
+{
+public:
+	std::string name;
+	RemotePoint origin;
+	std::vector<INT> values;
+	std::vector<RemotePoint> points;
+	std::vector<std::string> tags;
+	std::vector<bool> flags;
+	std::array<UINT16, 3> ids = {{ 0, 0, 0 }};
+	DOUBLE scale = 0;
+	INT GetSecret() const { return m_secret; }
+	void SetSecret(INT secret) { m_secret = secret; }
+private:
+	INT m_secret = 0;
+	DELEGATE_FIELDS(name, origin, values, points, tags, flags, ids, scale, m_secret)
+};
+
+static RemoteRecord MakeRemoteRecord()
+{
+	RemoteRecord record;
+	record.name = std::string("rec\0ord", 7);
+	record.origin.x = -1;
+	record.origin.y = TEST_INT;
+	record.values = { 1, 2, 3 };
+	record.points.resize(2);
+	record.points[1].y = 7;
+	record.tags = { "a", "", "bc" };
+	record.flags = { true, false, true };
+	record.ids = {{ 10, 20, 30 }};
+	record.scale = 0.5;
+	record.SetSecret(42);
+	return record;
+}
+
+void RemoteRecvRecord(const RemoteRecord& r, INT i) {
+	RemoteRecord e = MakeRemoteRecord();
+	ASSERT_TRUE(r.name == e.name && r.origin.x == e.origin.x && r.origin.y == e.origin.y);
+	ASSERT_TRUE(r.values == e.values && r.points.size() == 2 && r.points[1].y == 7);
+	ASSERT_TRUE(r.tags == e.tags && r.flags == e.flags && r.ids == e.ids);
+	ASSERT_TRUE(r.scale == e.scale && r.GetSecret() == 42 && i == TEST_INT);
+	remoteSerializeCnt++;
+}
+void RemoteRecvPoint(RemotePoint* p) { ASSERT_TRUE(p->x == 3 && p->y == 4); remoteSerializeCnt++; }
+
+/// @brief Buffer transport that invokes the receiver directly from the sent bytes.
+class RemoteLoopbackTransport : public IDelegateBufferTransport
+{
+public:
+	virtual void DispatchDelegate(const char* data, size_t size) override {
+		ASSERT_TRUE(DelegateRemoteInvoker::Invoke(data, size));
+	}
+};
+
+/// @brief Buffer transport that invokes each sub-message of a received batch frame.
+class RemoteBatchLoopbackTransport : public IDelegateBufferTransport
+{
+public:
+	virtual void DispatchDelegate(const char* data, size_t size) override {
+		ASSERT_TRUE(DelegateRemoteBatch::Invoke(data, size) > 0);
+		frames++;
+	}
+	std::atomic<INT> frames{0};
+};
+
+/// @brief Buffer transport that keeps a reference to the last shared message.
+class RemoteSharedTransport : public IDelegateBufferTransport
+{
+public:
+	virtual void DispatchDelegate(const char* data, size_t size) override { }
+	virtual void DispatchShared(const std::shared_ptr<DelegateBufferStream>& buffer) override {
+		last = buffer;
+		ASSERT_TRUE(DelegateRemoteInvoker::Invoke(buffer->Data(), buffer->Size()));
+	}
+	std::shared_ptr<DelegateBufferStream> last;
+};
+
+/// @brief Buffer transport that takes a while to send each message.
+class RemoteSlowTransport : public IDelegateBufferTransport
+{
+public:
+	virtual void DispatchDelegate(const char* data, size_t size) override {
+		inUse = true;
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		inUse = false;
+	}
+	std::atomic<bool> inUse{false};
+};
+
+/// @brief Receiver that destroys itself when invoked.
+class RemoteSelfDeletingRecv : public DelegateRemoteInvoker
+{
+public:
+	RemoteSelfDeletingRecv(DelegateIdType id) : DelegateRemoteInvoker(id) { }
+	~RemoteSelfDeletingRecv() { Unregister(); }
+	static INT invoked;
+protected:
+	virtual void DelegateInvoke(std::istream& s) override { invoked++; delete this; }
+};
+INT RemoteSelfDeletingRecv::invoked = 0;
+
+/// @brief Buffer transport that loses every message.
+class RemoteDropTransport : public IDelegateBufferTransport
+{
+public:
+	virtual void DispatchDelegate(const char* data, size_t size) override { }
+};
+
+void DelegateRemoteTests()
+{
+	RemoteLoopbackTransport loopback;
+	DelegateFreeRemoteRecv<void(INT)> recv1(&RemoteRecvInt1, 1);
+	DelegateFreeRemoteRecv<void(INT, INT)> recv2(&RemoteRecvInt2, 2);
+
+	remoteRecvCnt = 0;
+	DelegateRemoteSend<void(INT)> send1(loopback, 1);
+	send1(TEST_INT);
+	send1(TEST_INT);
+	DelegateRemoteSend<void(INT, INT)> send2(loopback, 2);
+	send2(TEST_INT, TEST_INT);
+	ASSERT_TRUE(remoteRecvCnt == 3);
+
+	// Legacy stream interface adapted onto the buffer transport
+	DelegateTransportAdapter adapter(loopback);
+	std::stringstream ss(std::ios::in | std::ios::out | std::ios::binary);
+	DelegateRemoteSend<void(INT)> sendStream(adapter, ss, 1);
+	sendStream(TEST_INT);
+	ASSERT_TRUE(remoteRecvCnt == 4);
+
+	// Legacy stream interface serialized into pooled buffers
+	DelegateRemoteSend<void(INT)> sendPooled(adapter, 1);
+	sendPooled(TEST_INT);
+	ASSERT_TRUE(remoteRecvCnt == 5);
+
+	// Concurrent sends each serialize into their own pooled buffer
+	{
+		std::vector<std::thread> senders;
+		for (int t = 0; t < 4; t++)
+			senders.push_back(std::thread([&send2]() {
+				for (int i = 0; i < 100; i++)
+					send2(TEST_INT, TEST_INT);
+			}));
+		for (auto& sender : senders)
+			sender.join();
+		ASSERT_TRUE(remoteRecvCnt == 405);
+		ASSERT_TRUE(DelegateBufferPool::GetFreeCount() == DELEGATE_SEND_BUFFER_POOL_SIZE);
+	}
+
+	ASSERT_TRUE(send1 == DelegateRemoteSend<void(INT)>(loopback, 1));
+	ASSERT_TRUE(!(send1 == sendStream));
+	ASSERT_TRUE(!DelegateRemoteInvoker::Invoke("99", 3));
+
+	// Unregistered ids are no longer invoked and may be registered again
+	{
+		DelegateFreeRemoteRecv<void(INT)> recv3(&RemoteRecvInt1, 3);
+		DelegateRemoteSend<void(INT)> send3(loopback, 3);
+		send3(TEST_INT);
+	}
+	ASSERT_TRUE(remoteRecvCnt == 406);
+	ASSERT_TRUE(!DelegateRemoteInvoker::Invoke("3", 2));
+	DelegateFreeRemoteRecv<void(INT)> recv3(&RemoteRecvInt1, 3);
+	ASSERT_TRUE(DelegateRemoteInvoker::Invoke("3\0" "12345678", 11));
+	ASSERT_TRUE(remoteRecvCnt == 407);
+
+	// A receiver may destroy itself from within its own invocation
+	new RemoteSelfDeletingRecv(7);
+	ASSERT_TRUE(DelegateRemoteInvoker::Invoke("7", 2));
+	ASSERT_TRUE(!DelegateRemoteInvoker::Invoke("7", 2));
+	ASSERT_TRUE(RemoteSelfDeletingRecv::invoked == 1);
+	RemoteSelfDeletingRecv::invoked = 0;
+
+	// Receivers destroyed while another thread invokes them
+	{
+		std::atomic<bool> invoking(true);
+		std::thread invoker([&invoking]() {
+			while (invoking)
+				DelegateRemoteInvoker::Invoke("9\0" "12345678", 11);
+		});
+		for (INT i = 0; i < 200; i++)
+		{
+			DelegateFreeRemoteRecv<void(INT)> recv9(&RemoteRecvInt1, 9);
+			std::this_thread::yield();
+		}
+		invoking = false;
+		invoker.join();
+		remoteRecvCnt = 407;
+	}
+
+	// Unregistered ids free their table slot
+	for (INT id = 1000; id < 1000 + 4 * DELEGATE_REMOTE_TABLE_SIZE; id++)
+	{
+		DelegateFreeRemoteRecv<void(INT)> recvId(&RemoteRecvInt1, id);
+		std::string msg = std::to_string(id) + '\0' + "12345678";
+		ASSERT_TRUE(DelegateRemoteInvoker::Invoke(msg.c_str(), msg.size() + 1));
+	}
+	ASSERT_TRUE(DelegateRemoteInvoker::Invoke("3\0" "12345678", 11));
+	ASSERT_TRUE(remoteRecvCnt == 408 + 4 * DELEGATE_REMOTE_TABLE_SIZE);
+	remoteRecvCnt = 407;
+
+	// The table grows beyond its initial size
+	{
+		std::vector<std::unique_ptr<DelegateFreeRemoteRecv<void(INT)>>> recvIds;
+		for (INT id = 5000; id < 5000 + 2 * DELEGATE_REMOTE_TABLE_SIZE; id++)
+			recvIds.emplace_back(new DelegateFreeRemoteRecv<void(INT)>(&RemoteRecvInt1, id));
+		for (INT id = 5000; id < 5000 + 2 * DELEGATE_REMOTE_TABLE_SIZE; id++)
+		{
+			std::string msg = std::to_string(id) + '\0' + "12345678";
+			ASSERT_TRUE(DelegateRemoteInvoker::Invoke(msg.c_str(), msg.size() + 1));
+		}
+		ASSERT_TRUE(!DelegateRemoteInvoker::Invoke("4999\0" "12345678", 14));
+		ASSERT_TRUE(remoteRecvCnt == 407 + 2 * DELEGATE_REMOTE_TABLE_SIZE);
+		remoteRecvCnt = 407;
+	}
+
+	// Batch several invocations for different ids into one frame
+	RemoteBatchLoopbackTransport batchLoopback;
+	DelegateRemoteBatch batch(batchLoopback, 4096, 0);
+	DelegateRemoteSend<void(INT)> batchSend1(batch, 1);
+	DelegateRemoteSend<void(INT, INT)> batchSend2(batch, 2);
+	batchSend1(TEST_INT);
+	batchSend2(TEST_INT, TEST_INT);
+	batchSend1(TEST_INT);
+	ASSERT_TRUE(remoteRecvCnt == 407 && batchLoopback.frames == 0);
+	batch.Flush();
+	ASSERT_TRUE(remoteRecvCnt == 410 && batchLoopback.frames == 1);
+
+	// Flush on size
+	batch.SetWindow(1, 0);
+	batchSend2(TEST_INT, TEST_INT);
+	ASSERT_TRUE(remoteRecvCnt == 411 && batchLoopback.frames == 2);
+	ASSERT_TRUE(DelegateRemoteBatch::Invoke("\x10\0\0\0" "1", 5) == -1);
+
+	// Flush on the latency deadline without another send or Poll()
+	{
+		RemoteBatchLoopbackTransport deadlineLoopback;
+		DelegateRemoteBatch deadlineBatch(deadlineLoopback, 4096, 20);
+		DelegateRemoteSend<void(INT)> deadlineSend(deadlineBatch, 1);
+		deadlineSend(TEST_INT);
+		for (int wait = 0; wait < 2000 && deadlineLoopback.frames == 0; wait++)
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		ASSERT_TRUE(deadlineLoopback.frames == 1 && remoteRecvCnt == 412);
+		remoteRecvCnt = 411;
+	}
+
+	// Binary serialized argument types
+	{
+		DelegateFreeRemoteRecv<void(const RemoteRecord&, INT)> recvRecord(&RemoteRecvRecord, 5);
+		DelegateRemoteSend<void(const RemoteRecord&, INT)> sendRecord(loopback, 5);
+		DelegateFreeRemoteRecv<void(RemotePoint*)> recvPoint(&RemoteRecvPoint, 6);
+		DelegateRemoteSend<void(RemotePoint*)> sendPoint(loopback, 6);
+		RemotePoint point;
+		point.x = 3;
+		point.y = 4;
+		remoteSerializeCnt = 0;
+		sendRecord(MakeRemoteRecord(), TEST_INT);
+		sendPoint(&point);
+		ASSERT_TRUE(remoteSerializeCnt == 2);
+
+		// A corrupt sequence length fails the stream instead of allocating
+		std::string str;
+		DelegateBufferStream badString("\xF0\xFF\xFF\xFF" "abc", 7);
+		DelegateSerializer<std::string>::Read(badString, str);
+		ASSERT_TRUE(badString.fail() && str.empty());
+
+		std::vector<INT> vec;
+		DelegateBufferStream badVector("\x02\0\0\0" "abcd", 8);
+		DelegateSerializer<std::vector<INT>>::Read(badVector, vec);
+		ASSERT_TRUE(badVector.fail() && vec.empty());
+	}
+
+	// One serialization fanned out to several transports
+	{
+		RemoteSharedTransport shared1, shared2;
+		DelegateRemoteMulticast<void(INT, INT)> multicast(2);
+		multicast.AddTransport(shared1);
+		multicast.AddTransport(shared2);
+		multicast.AddTransport(loopback);
+		multicast.AddTransport(adapter);
+		ASSERT_TRUE(multicast.GetTransportCount() == 4);
+
+		MulticastDelegateSafe<void(INT, INT)> event;
+		event += multicast;
+		event(TEST_INT, TEST_INT);
+		ASSERT_TRUE(remoteRecvCnt == 415);
+		ASSERT_TRUE(shared1.last && shared1.last == shared2.last);
+		shared1.last.reset();
+		shared2.last.reset();
+
+		// Endpoints change while another thread publishes
+		std::atomic<bool> publish(true);
+		std::thread publisher([&]() {
+			while (publish)
+				multicast(TEST_INT, TEST_INT);
+		});
+		for (int i = 0; i < 100; i++) {
+			multicast.RemoveTransport(loopback);
+			multicast.AddTransport(loopback);
+		}
+		publish = false;
+		publisher.join();
+		multicast.RemoveTransport(shared1);
+		multicast.RemoveTransport(shared2);
+		multicast.RemoveTransport(loopback);
+		multicast.RemoveTransport(adapter);
+		ASSERT_TRUE(multicast.GetTransportCount() == 0);
+
+		// The number of concurrent publishes is timing dependent
+		remoteRecvCnt = 415;
+
+		// A removed transport is no longer in use once RemoveTransport() returns
+		RemoteSlowTransport slow;
+		multicast.AddTransport(slow);
+		std::thread slowPublisher([&]() { multicast(TEST_INT, TEST_INT); });
+		for (int wait = 0; wait < 2000 && !slow.inUse; wait++)
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		multicast.RemoveTransport(slow);
+		ASSERT_TRUE(!slow.inUse);
+		slowPublisher.join();
+	}
+
+	// Decode on the invoking thread, invoke the target on testThread
+	{
+		DelegateRemoteRecvAsync<void(INT, const INT&)> recvAsync(&RemoteRecvOnTestThread, testThread, 4);
+		DelegateRemoteSend<void(INT, const INT&)> sendAsync(loopback, 4);
+		sendAsync(TEST_INT, TEST_INT);
+		sendAsync(TEST_INT, TEST_INT);
+	}
+	for (int wait = 0; wait < 2000 && remoteRecvCnt != 417; wait++)
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	ASSERT_TRUE(remoteRecvCnt == 417);
+
+	// Request/response; one transport per direction
+	RemoteLoopbackTransport requestLoopback, responseLoopback;
+	DelegateRemoteResponder<INT(INT, const INT&)> responder(responseLoopback, 10, 11, MakeDelegate(&RemoteAddInt2));
+	DelegateRemoteRequest<INT(INT, const INT&)> request(requestLoopback, 10, 11, 1000);
+	ASSERT_TRUE(request(TEST_INT, TEST_INT) == TEST_INT * 2);
+	ASSERT_TRUE(request.IsSuccess());
+	INT sum = 0;
+	ASSERT_TRUE(request.Invoke(sum, 1, 2) && sum == 3);
+	request.Invoke(MakeDelegate(&RemoteAddComplete), TEST_INT, TEST_INT);
+	ASSERT_TRUE(remoteRecvCnt == 418 && request.GetPendingCount() == 0);
+
+	// Lost requests time out
+	RemoteDropTransport dropTransport;
+	DelegateRemoteRequest<INT(INT, const INT&)> lostRequest(dropTransport, 10, 12, 0);
+	ASSERT_TRUE(lostRequest(TEST_INT, TEST_INT) == 0);
+	ASSERT_TRUE(!lostRequest.IsSuccess());
+	lostRequest.Invoke(MakeDelegate(&RemoteAddExpired), TEST_INT, TEST_INT);
+	for (int wait = 0; wait < 2000 && remoteRecvCnt != 419; wait++)
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	ASSERT_TRUE(remoteRecvCnt == 419 && lostRequest.GetPendingCount() == 0);
+
+	// Per request timeouts override the default
+	INT lostRetVal = 0;
+	ASSERT_TRUE(!lostRequest.Invoke(10, lostRetVal, TEST_INT, TEST_INT));
+	lostRequest.Invoke(WAIT_INFINITE, MakeDelegate(&RemoteAddExpired), TEST_INT, TEST_INT);
+	lostRequest.Invoke(200, MakeDelegate(&RemoteAddExpired), TEST_INT, TEST_INT);
+	ASSERT_TRUE(remoteRecvCnt == 419 && lostRequest.GetPendingCount() == 2);
+	for (int wait = 0; wait < 2000 && remoteRecvCnt != 420; wait++)
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	ASSERT_TRUE(remoteRecvCnt == 420 && lostRequest.GetPendingCount() == 1);
+	remoteRecvCnt = 419;
+
+#if defined(__linux__)
+	// Shared memory ring, both ends within this process
+	ShmTransport shmSend, shmRecv;
+	ShmTransport::Unlink("/DelegateUnitTestRing");
+	ASSERT_TRUE(shmRecv.Open("/DelegateUnitTestRing", 128, ShmTransport::RECEIVE));
+	ASSERT_TRUE(shmSend.Open("/DelegateUnitTestRing", 128, ShmTransport::SEND));
+	DelegateRemoteSend<void(INT, INT)> shmSend2(shmSend, 2);
+	ASSERT_TRUE(shmRecv.Receive(0) == 0);
+	for (int i = 0; i < 10; i++)
+	{
+		// Small ring exercises the wrap marker
+		shmSend2(TEST_INT, TEST_INT);
+		shmSend2(TEST_INT, TEST_INT);
+		ASSERT_TRUE(shmRecv.Receive(0) == 2);
+	}
+	ASSERT_TRUE(remoteRecvCnt == 439);
+
+	// A sender gives up on a ring the receiver stops draining
+	shmSend.SetSendTimeout(10);
+	for (int i = 0; i < 10; i++)
+		shmSend2(TEST_INT, TEST_INT);
+	ASSERT_TRUE(shmSend.GetDroppedCount() > 0);
+	ASSERT_TRUE(shmRecv.Receive(0) == (int)(10 - shmSend.GetDroppedCount()));
+	remoteRecvCnt = 439;
+
+	// A message needing more than half the ring is dropped and counted
+	uint64_t shmDropped = shmSend.GetDroppedCount();
+	CHAR shmOversize[65] = { '2', 0 };
+	ASSERT_TRUE(!shmSend.Send(shmOversize, sizeof(shmOversize)));
+	shmSend.DispatchDelegate(shmOversize, sizeof(shmOversize));
+	ASSERT_TRUE(shmSend.GetDroppedCount() == shmDropped + 1);
+	ASSERT_TRUE(shmRecv.Receive(0) == 0);
+	shmSend.Close();
+	shmRecv.Close();
+
+	// Record invocations of a multicast event, rotating through small segments, then replay
+	{
+		// A segment must hold the largest record
+		DelegateRecorder recorder;
+		ASSERT_TRUE(!recorder.Open("/tmp/DelegateUnitTest.log", 256));
+		recorder.SetMaxRecordSize(64);
+		ASSERT_TRUE(recorder.Open("/tmp/DelegateUnitTest.log", 256));
+		MulticastDelegateSafe<void(INT, INT)> event;
+		event += MakeDelegate<INT, INT>(recorder, 2);
+		for (int i = 0; i < 20; i++)
+			event(TEST_INT, TEST_INT);
+		ASSERT_TRUE(remoteRecvCnt == 439);
+		ASSERT_TRUE(recorder.GetRecordCount() == 20);
+
+		// A longer message is dropped and counted
+		CHAR oversize[65] = { '2', 0 };
+		recorder.Record(oversize, sizeof(oversize));
+		ASSERT_TRUE(recorder.GetRecordCount() == 20 && recorder.GetDroppedCount() == 1);
+		recorder.Close();
+
+		DelegateReplayer replayer;
+		ASSERT_TRUE(replayer.Open("/tmp/DelegateUnitTest.log"));
+		ASSERT_TRUE(replayer.GetSegmentCount() > 1);
+		ASSERT_TRUE(replayer.Replay(DelegateReplayer::FAST) == 20);
+		ASSERT_TRUE(remoteRecvCnt == 459);
+		ASSERT_TRUE(replayer.Replay(DelegateReplayer::ORIGINAL, &loopback) == 20);
+		ASSERT_TRUE(remoteRecvCnt == 479);
+
+		// Keep only the newest two segments
+		ASSERT_TRUE(recorder.Open("/tmp/DelegateUnitTest.log", 256, 2));
+		for (int i = 0; i < 20; i++)
+			recorder.Record("2\0" "1\0" "1", 6);
+		recorder.Close();
+		ASSERT_TRUE(replayer.Open("/tmp/DelegateUnitTest.log"));
+		ASSERT_TRUE(replayer.GetSegmentCount() == 2);
+		uint64_t replayed = replayer.Replay(DelegateReplayer::FAST, &dropTransport);
+		ASSERT_TRUE(replayed > 0 && replayed < 20);
+	}
+
+	// Unix domain socket with the receive loop, then marshalled onto testThread, 
+	// then loopback TCP
+	for (int mode = 0; mode < 3; mode++)
+	{
+		SocketTransport server, client;
+		if (mode < 2)
+		{
+			ASSERT_TRUE(server.ListenUnix("/tmp/DelegateUnitTest.sock"));
+			ASSERT_TRUE(server.Start(mode == 1 ? &testThread : NULL));
+			ASSERT_TRUE(client.ConnectUnix("/tmp/DelegateUnitTest.sock"));
+		}
+		else
+		{
+			ASSERT_TRUE(server.ListenTcp(47311));
+			ASSERT_TRUE(server.Start());
+			ASSERT_TRUE(client.ConnectTcp(47311));
+		}
+
+		INT expected = remoteRecvCnt + 3;
+		DelegateRemoteSend<void(INT)> socketSend1(client, 1);
+		DelegateRemoteSend<void(INT, INT)> socketSend2(client, 2);
+		socketSend1(TEST_INT);
+		socketSend2(TEST_INT, TEST_INT);
+		socketSend1(TEST_INT);
+		for (int wait = 0; wait < 2000 && remoteRecvCnt != expected; wait++)
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		ASSERT_TRUE(remoteRecvCnt == expected);
+	}
+
+	// A frame longer than the receiver's limit drops the connection
+	{
+		SocketTransport server, client;
+		server.SetMaxFrameSize(4);
+		ASSERT_TRUE(server.ListenUnix("/tmp/DelegateUnitTest.sock"));
+		ASSERT_TRUE(server.Start());
+		ASSERT_TRUE(client.ConnectUnix("/tmp/DelegateUnitTest.sock"));
+		for (int wait = 0; wait < 2000 && !server.IsConnected(); wait++)
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		ASSERT_TRUE(server.IsConnected());
+
+		INT expected = remoteRecvCnt;
+		DelegateRemoteSend<void(INT)> socketSend1(client, 1);
+		socketSend1(TEST_INT);
+		for (int wait = 0; wait < 2000 && server.IsConnected(); wait++)
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		ASSERT_TRUE(!server.IsConnected());
+		ASSERT_TRUE(remoteRecvCnt == expected);
+	}
+
+	// A peer that never reads fills the send queue; later messages are dropped
+	{
+		SocketTransport server, client;
+		ASSERT_TRUE(server.ListenUnix("/tmp/DelegateUnitTest.sock"));
+		ASSERT_TRUE(client.ConnectUnix("/tmp/DelegateUnitTest.sock"));
+		ASSERT_TRUE(client.Start());
+		client.SetMaxSendQueueSize(64 * 1024);
+
+		std::vector<CHAR> message(16 * 1024, 0);
+		for (int i = 0; i < 256 && client.GetDroppedCount() == 0; i++)
+			client.DispatchDelegate(message.data(), message.size());
+		ASSERT_TRUE(client.GetDroppedCount() > 0);
+		ASSERT_TRUE(client.IsConnected());
+	}
+#endif
+}
+
+/// Fill a block with a pattern derived from its size
+static void XallocFill(void* mem, size_t size)
+{
+	memset(mem, (int)(size & 0x7F), size);
+}
+
+static bool XallocCheck(void* mem, size_t size)
+{
+	for (size_t i = 0; i < size; i++)
+		if (static_cast<CHAR*>(mem)[i] != (CHAR)(size & 0x7F))
+			return false;
+	return true;
+}
+
+static void XallocNewHandler()
+{
+}
+
+static std::string XallocReadFile(const char* path)
+{
+	std::ifstream file(path);
+	std::stringstream contents;
+	contents << file.rdbuf();
+	return contents.str();
+}
+
+struct alignas(32) XallocAligned
+{
+	XALLOCATOR_ALIGNED(32)
+public:
+	float values[8];
+};
+
+void XallocatorTests()
+{
+	// Threads allocate and free a mix of sizes through their caches
+	std::vector<std::thread> threads;
+	for (int t = 0; t < 4; t++)
+	{
+		threads.push_back(std::thread([t]() {
+			std::vector<std::pair<void*, size_t>> blocks;
+			for (int i = 0; i < 2000; i++)
+			{
+				size_t size = 1 + ((i * 37 + t * 11) % 600);
+				void* mem = xmalloc(size);
+				ASSERT_TRUE(mem != NULL);
+				XallocFill(mem, size);
+				blocks.push_back(std::make_pair(mem, size));
+				if (i % 3 == 0)
+				{
+					ASSERT_TRUE(XallocCheck(blocks.front().first, blocks.front().second));
+					xfree(blocks.front().first);
+					blocks.erase(blocks.begin());
+				}
+			}
+			for (auto& block : blocks)
+			{
+				ASSERT_TRUE(XallocCheck(block.first, block.second));
+				xfree(block.first);
+			}
+		}));
+	}
+	for (auto& thread : threads)
+		thread.join();
+
+	// Blocks allocated on one thread and freed on another
+	std::vector<void*> produced;
+	for (int i = 0; i < 1000; i++)
+	{
+		void* mem = xmalloc(24);
+		XallocFill(mem, 24);
+		produced.push_back(mem);
+	}
+	std::thread consumer([&produced]() {
+		for (void* mem : produced)
+		{
+			ASSERT_TRUE(XallocCheck(mem, 24));
+			xfree(mem);
+		}
+	});
+	consumer.join();
+
+	// Sizes either side of every size class boundary
+	for (size_t blockSize = 8; blockSize <= (1 << 19); blockSize <<= 1)
+	{
+		const size_t sizes[] = { blockSize - 9, blockSize - 8, blockSize - 7, 388, 389, 760, 761 };
+		for (size_t size : sizes)
+		{
+			if (size > blockSize)
+				continue;
+			void* mem = xmalloc(size);
+			ASSERT_TRUE(mem != NULL);
+			XallocFill(mem, size);
+			ASSERT_TRUE(XallocCheck(mem, size));
+			xfree(mem);
+		}
+	}
+
+	// Aligned classes
+	for (size_t alignment = 1; alignment <= 64; alignment <<= 1)
+	{
+		const size_t sizes[] = { 1, 24, 64, 100, 390, 1000 };
+		for (size_t size : sizes)
+		{
+			void* mem = xmalloc_aligned(size, alignment);
+			ASSERT_TRUE(mem != NULL && ((size_t)mem & (alignment - 1)) == 0);
+			XallocFill(mem, size);
+			ASSERT_TRUE(XallocCheck(mem, size));
+			xfree(mem);
+		}
+	}
+	XallocAligned* aligned = new XallocAligned();
+	ASSERT_TRUE(((size_t)aligned & 31) == 0);
+	delete aligned;
+
+	// Slab mode allocators find the owner of a block by address
+	Allocator slabSmall(16, 0, NULL, "SlabSmall", 0, Allocator::SLABS);
+	Allocator slabLarge(100000, 0, NULL, "SlabLarge", 64, Allocator::SLABS);
+	std::vector<void*> slabBlocks;
+	for (int i = 0; i < 10000; i++)
+	{
+		void* block = slabSmall.Allocate(16);
+		ASSERT_TRUE(Allocator::GetSlabOwner(block) == &slabSmall);
+		slabBlocks.push_back(block);
+	}
+	for (int i = 0; i < 3; i++)
+	{
+		void* block = slabLarge.Allocate(100000);
+		ASSERT_TRUE(Allocator::GetSlabOwner(block) == &slabLarge && ((size_t)block & 63) == 0);
+		XallocFill(block, 100000);
+		slabBlocks.push_back(block);
+	}
+	ASSERT_TRUE(slabSmall.GetBlockCount() == 10000 && slabLarge.GetBlocksInUse() == 3);
+	for (void* block : slabBlocks)
+		Allocator::GetSlabOwner(block)->Deallocate(block);
+
+	void* alignedMem = xmalloc_aligned(40, 64);
+	XallocFill(alignedMem, 40);
+	alignedMem = xrealloc(alignedMem, 300);
+	ASSERT_TRUE(XallocCheck(alignedMem, 40));
+	xfree(alignedMem);
+
+	void* mem = xmalloc(10);
+	XallocFill(mem, 10);
+	mem = xrealloc(mem, 100);
+	ASSERT_TRUE(XallocCheck(mem, 10));
+	xfree(mem);
+
+#ifndef STATIC_POOLS
+	// Requests over 1 MB come from classes the thread caches do not hold
+	void* largeMem = xmalloc(3 * 1024 * 1024);
+	XallocFill(largeMem, 3 * 1024 * 1024);
+	largeMem = xrealloc(largeMem, 5 * 1024 * 1024);
+	ASSERT_TRUE(XallocCheck(largeMem, 3 * 1024 * 1024));
+	std::thread largeThread([largeMem]() { xfree(largeMem); });
+	largeThread.join();
+	largeMem = xmalloc(1024 * 1024);
+	XallocFill(largeMem, 1024 * 1024);
+	xfree(largeMem);
+#endif
+
+	// Statistics of every size class are consistent and track the high water mark
+	std::vector<void*> held;
+	for (int i = 0; i < 100; i++)
+		held.push_back(xmalloc(3000));
+	XallocStats stats[128];
+	size_t statsCount = xalloc_get_stats(stats, 128);
+	ASSERT_TRUE(statsCount > 0 && statsCount <= 128);
+	BOOL found = FALSE;
+	for (size_t i = 0; i < statsCount; i++)
+	{
+		// Blocks freed to a remote free list stay in use until reclaimed
+		ASSERT_TRUE(stats[i].allocations - stats[i].deallocations <= stats[i].blocksInUse);
+		ASSERT_TRUE(stats[i].highWater >= stats[i].blocksInUse + stats[i].blocksCached);
+		ASSERT_TRUE(stats[i].bytesUsed == stats[i].blocksInUse * stats[i].blockSize);
+		ASSERT_TRUE(stats[i].bytesReserved >= stats[i].bytesUsed);
+		if (stats[i].alignment == 0 && stats[i].blockSize == 4096)
+		{
+			ASSERT_TRUE(stats[i].blocksInUse >= 100 && stats[i].highWater >= 100);
+			found = TRUE;
+		}
+	}
+	ASSERT_TRUE(found);
+	for (void* block : held)
+		xfree(block);
+
+	// Allocations and deallocations count client calls, not magazine refills and flushes
+	UINT statsAllocations = 0, statsDeallocations = 0;
+	statsCount = xalloc_get_stats(stats, 128);
+	for (size_t i = 0; i < statsCount; i++)
+	{
+		if (stats[i].alignment == 0 && stats[i].blockSize == 4096)
+		{
+			statsAllocations = stats[i].allocations;
+			statsDeallocations = stats[i].deallocations;
+		}
+	}
+	for (int i = 0; i < 1000; i++)
+		xfree(xmalloc(3000));
+	statsCount = xalloc_get_stats(stats, 128);
+	for (size_t i = 0; i < statsCount; i++)
+	{
+		if (stats[i].alignment == 0 && stats[i].blockSize == 4096)
+		{
+			ASSERT_TRUE(stats[i].allocations == statsAllocations + 1000);
+			ASSERT_TRUE(stats[i].deallocations == statsDeallocations + 1000);
+		}
+	}
+
+	// Blocks freed by another thread are reclaimed at most a magazine at a time
+	held.clear();
+	for (int i = 0; i < 200; i++)
+		held.push_back(xmalloc(1800));
+	std::thread freeThread([&held]() {
+		for (void* block : held)
+			xfree(block);
+	});
+	freeThread.join();
+	held.clear();
+	for (int i = 0; i < 40; i++)
+		held.push_back(xmalloc(1800));
+	UINT blockCount = 0;
+	statsCount = xalloc_get_stats(stats, 128);
+	for (size_t i = 0; i < statsCount; i++)
+	{
+		if (stats[i].alignment == 0 && stats[i].blockSize == 2048)
+		{
+			ASSERT_TRUE(stats[i].blocksCached <= 2 * 32);
+			blockCount = stats[i].blockCount;
+		}
+	}
+
+	// The rest remain available to other threads without creating blocks
+	std::thread allocThread([]() {
+		std::vector<void*> blocks;
+		for (int i = 0; i < 100; i++)
+			blocks.push_back(xmalloc(1800));
+		for (void* block : blocks)
+			xfree(block);
+	});
+	allocThread.join();
+	statsCount = xalloc_get_stats(stats, 128);
+	for (size_t i = 0; i < statsCount; i++)
+	{
+		if (stats[i].alignment == 0 && stats[i].blockSize == 2048)
+			ASSERT_TRUE(stats[i].blockCount == blockCount);
+	}
+	for (void* block : held)
+		xfree(block);
+	held.clear();
+
+	// Blocks freed into this thread's cache are reported as cached, not in use
+	statsCount = xalloc_get_stats(stats, 128);
+	for (size_t i = 0; i < statsCount; i++)
+	{
+		if (stats[i].alignment == 0 && stats[i].blockSize == 4096)
+			ASSERT_TRUE(stats[i].blocksCached > 0);
+	}
+
+	// An exhausted pool counts the failed allocation
+	std::new_handler oldHandler = std::set_new_handler(&XallocNewHandler);
+	AllocatorPool<CHAR[16], 2> statsPool;
+	void* poolBlock1 = statsPool.Allocate(16);
+	void* poolBlock2 = statsPool.Allocate(16);
+	ASSERT_TRUE(statsPool.Allocate(16) == NULL);
+	statsPool.Deallocate(poolBlock1);
+	statsPool.Deallocate(poolBlock2);
+	std::set_new_handler(oldHandler);
+	ASSERT_TRUE(statsPool.GetFailedAllocations() == 1 && statsPool.GetHighWater() == 2);
+	ASSERT_TRUE(statsPool.GetBlocksInUse() == 0 && statsPool.GetBytesReserved() == 32);
+
+	// Reserved blocks are created ahead of use
+	Allocator reserved(64);
+	ASSERT_TRUE(reserved.Reserve(100) == TRUE);
+	ASSERT_TRUE(reserved.GetBlockCount() == 100 && reserved.GetBlocksInUse() == 0);
+	std::vector<void*> reservedBlocks;
+	for (int i = 0; i < 100; i++)
+		reservedBlocks.push_back(reserved.Allocate(64));
+	ASSERT_TRUE(reserved.GetBlockCount() == 100);
+	for (void* block : reservedBlocks)
+		reserved.Deallocate(block);
+	reserved.Reserve(150, TRUE);
+	ASSERT_TRUE(reserved.GetBlockCount() == 150);
+
+	// Free blocks on a thread safe allocator's shared stack cannot be locked
+	Allocator sharedReserved(64, 0, NULL, NULL, 0, Allocator::THREAD_SAFE);
+	ASSERT_TRUE(sharedReserved.Reserve(10) == TRUE);
+	ASSERT_TRUE(sharedReserved.Reserve(20, TRUE) == FALSE && sharedReserved.GetBlockCount() == 20);
+	ASSERT_TRUE(statsPool.Reserve(10) == TRUE);
+	xalloc_reserve(3000, 200, FALSE);
+	statsCount = xalloc_get_stats(stats, 128);
+	found = FALSE;
+	for (size_t i = 0; i < statsCount; i++)
+	{
+		if (stats[i].alignment == 0 && stats[i].blockSize == 4096)
+			found = stats[i].blockCount >= 200;
+	}
+	ASSERT_TRUE(found);
+
+	// Huge page pools fall back to ordinary pages when huge pages are unavailable. Pool
+	// blocks are rounded up to a pointer multiple so free-list links stay aligned.
+	HugePageAllocatorPool<CHAR[100], 5000> hugePool;
+	ASSERT_TRUE(hugePool.GetBlockSize() == 104);
+	Allocator hugeShared(100, 16, NULL, NULL, 0, Allocator::HUGE_PAGES | Allocator::THREAD_SAFE);
+	ASSERT_TRUE(hugeShared.GetThreadSafe() && hugeShared.GetBlockSize() == 104);
+	hugeShared.Deallocate(hugeShared.Allocate(100));
+	ASSERT_TRUE(hugePool.Reserve(5000) == TRUE);
+	std::vector<void*> hugeBlocks;
+	for (int i = 0; i < 5000; i++)
+	{
+		void* block = hugePool.Allocate(100);
+		ASSERT_TRUE(block != NULL && ((size_t)block & (alignof(void*) - 1)) == 0);
+		XallocFill(block, 100);
+		hugeBlocks.push_back(block);
+	}
+	for (void* block : hugeBlocks)
+	{
+		ASSERT_TRUE(XallocCheck(block, 100));
+		hugePool.Deallocate(block);
+	}
+	ASSERT_TRUE(hugePool.GetHighWater() == 5000 && hugePool.GetBytesReserved() == 520000);
+
+	// A pool over caller memory sizes its buffer with the rounded block size
+	AllocatorPool<CHAR[100], 3> oddPool;
+	ASSERT_TRUE(oddPool.GetBlockSize() == 104 && oddPool.GetBytesReserved() == 312);
+
+	// The request size profile is empty unless built with XALLOC_PROFILE
+	XallocProfileEntry entries[64];
+	size_t entryCount = xalloc_get_profile(entries, 64);
+	for (size_t i = 0; i < entryCount && i < 64; i++)
+		ASSERT_TRUE(entries[i].peak >= entries[i].inUse && entries[i].allocations >= entries[i].peak);
+
+	// Static pool configuration generated from a profile
+	XallocProfileEntry profile[] = { { 8, 100, 0, 10 }, { 16, 50, 0, 5 }, { 24, 20, 0, 2 }, { 104, 1, 0, 1 } };
+	const char* configPath = "xalloc_pools_test.h";
+	ASSERT_TRUE(xalloc_write_pool_config(configPath, profile, 4, 455) == FALSE);
+	ASSERT_TRUE(xalloc_write_pool_config(configPath, profile, 4, 456) == TRUE);
+	std::string config = XallocReadFile(configPath);
+	ASSERT_TRUE(config.find("XALLOC_POOL(16, 10) \\\n\tXALLOC_POOL(24, 5) \\\n\tXALLOC_POOL(32, 2) \\\n\tXALLOC_POOL(112, 1)\n") != std::string::npos);
+
+	// Only one pool between powers of two may be smaller than the power of two
+	XallocProfileEntry bucketProfile[] = { { 32, 1, 0, 1 }, { 40, 1, 0, 1 } };
+	ASSERT_TRUE(xalloc_write_pool_config(configPath, bucketProfile, 2, 1000) == TRUE);
+	config = XallocReadFile(configPath);
+	ASSERT_TRUE(config.find("XALLOC_POOL(48, 20)\n") != std::string::npos && config.find("XALLOC_POOL(40") == std::string::npos);
+	std::remove(configPath);
+}
+
+class SharedMsg
+{
+	DECLARE_ALLOCATOR
+public:
+	SharedMsg(INT v) : value(v) { }
+	INT value;
+};
+IMPLEMENT_THREAD_SAFE_ALLOCATOR(SharedMsg, 0, NULL)
+
+void ThreadSafeAllocatorTests()
+{
+	// Blocks allocated on one thread and freed on another, concurrently
+	const INT count = 20000;
+	std::atomic<SharedMsg*> slot(nullptr);
+	std::thread consumer([&slot, count]() {
+		for (INT i = 0; i < count; i++)
+		{
+			SharedMsg* msg;
+			while ((msg = slot.exchange(nullptr, std::memory_order_acquire)) == nullptr)
+				std::this_thread::yield();
+			ASSERT_TRUE(msg->value == i);
+			delete msg;
+		}
+	});
+	std::vector<std::thread> threads;
+	for (int t = 0; t < 3; t++)
+	{
+		threads.push_back(std::thread([]() {
+			for (INT i = 0; i < 5000; i++)
+				delete new SharedMsg(i);
+		}));
+	}
+	for (INT i = 0; i < count; i++)
+	{
+		SharedMsg* msg = new SharedMsg(i);
+		SharedMsg* expected = nullptr;
+		while (!slot.compare_exchange_weak(expected, msg, std::memory_order_release))
+		{
+			expected = nullptr;
+			std::this_thread::yield();
+		}
+	}
+	consumer.join();
+	for (auto& thread : threads)
+		thread.join();
+
+	// Fixed pool blocks are reused and the stats balance
+	AllocatorPool<SharedMsg, 4, TRUE> pool;
+	void* blocks[4];
+	for (int i = 0; i < 4; i++)
+		blocks[i] = pool.Allocate(sizeof(SharedMsg));
+	ASSERT_TRUE(pool.GetBlocksInUse() == 4);
+	pool.Deallocate(blocks[2]);
+	ASSERT_TRUE(pool.Allocate(sizeof(SharedMsg)) == blocks[2]);
+	for (int i = 0; i < 4; i++)
+		pool.Deallocate(blocks[i]);
+	ASSERT_TRUE(pool.GetBlocksInUse() == 0);
+	ASSERT_TRUE(pool.GetAllocations() == 5 && pool.GetDeallocations() == 5);
+
+	// A block freed by another thread is counted at once and reused by the owner
+	for (int i = 0; i < 4; i++)
+		blocks[i] = pool.Allocate(sizeof(SharedMsg));
+	std::thread freeThread([&pool, &blocks]() { pool.Deallocate(blocks[1]); });
+	freeThread.join();
+	ASSERT_TRUE(pool.GetBlocksInUse() == 3 && pool.GetHighWater() == 4);
+	ASSERT_TRUE(pool.Allocate(sizeof(SharedMsg)) == blocks[1]);
+
+	// Another thread allocates the block it freed from the remote free-list
+	pool.Deallocate(blocks[3]);
+	std::thread allocThread([&pool, &blocks]() {
+		pool.Deallocate(blocks[2]);
+		blocks[3] = pool.Allocate(sizeof(SharedMsg));
+	});
+	allocThread.join();
+	ASSERT_TRUE(blocks[3] == blocks[2] && pool.GetBlocksInUse() == 3);
+	for (int i = 0; i < 3; i++)
+		pool.Deallocate(blocks[i]);
+	ASSERT_TRUE(pool.GetBlocksInUse() == 0);
+}
+
+static std::atomic<INT> arenaMsgCount(0);
+static void ArenaMsgFunc(StructParam* s, INT i) { ASSERT_TRUE(s->val == i); arenaMsgCount++; }
+
+void MessageArenaTests()
+{
+	// Three 64 byte messages fit in each chunk after the chunk header
+	MessageArena arena(256, 3);
+	void* blocks[9];
+	for (int i = 0; i < 9; i++)
+	{
+		blocks[i] = arena.Allocate(64);
+		ASSERT_TRUE(blocks[i] != NULL && arena.Owns(blocks[i]));
+	}
+	ASSERT_TRUE(arena.GetChunksInUse() == 3);
+
+	// The next chunk in the ring is reused only once all of its messages are released
+	ASSERT_TRUE(arena.Allocate(64) == NULL);
+	arena.Deallocate(blocks[0]);
+	arena.Deallocate(blocks[1]);
+	ASSERT_TRUE(arena.Allocate(64) == NULL);
+	arena.Deallocate(blocks[2]);
+	void* reused = arena.Allocate(64);
+	ASSERT_TRUE(reused == blocks[0]);
+	ASSERT_TRUE(arena.Allocate(256) == NULL && arena.GetFailedAllocations() == 3);
+	arena.Deallocate(reused);
+	for (int i = 3; i < 9; i++)
+		arena.Deallocate(blocks[i]);
+	ASSERT_TRUE(arena.GetChunksInUse() == 1 && arena.GetAllocations() == 10);
+
+#if USE_STD_THREADS
+	// Async messages dispatched to a thread with an arena, falling back to the heap
+	// whenever the consumer is a whole arena behind
+	WorkerThread arenaThread("MessageArenaThread");
+	arenaThread.EnableMessageArena(1024, 4);
+	arenaThread.CreateThread();
+	auto delegate = MakeDelegate(&ArenaMsgFunc, arenaThread);
+	arenaMsgCount = 0;
+	for (INT i = 0; i < 1000; i++)
+	{
+		StructParam param;
+		param.val = i;
+		delegate(&param, i);
+	}
+	StructParam param;
+	param.val = 1000;
+	MakeDelegate(&ArenaMsgFunc, arenaThread, WAIT_INFINITE)(&param, 1000);
+	ASSERT_TRUE(arenaMsgCount == 1001);
+	MessageArena* threadArena = arenaThread.GetMessageArena();
+	ASSERT_TRUE(threadArena->GetAllocations() + threadArena->GetFailedAllocations() == 2 * 1001);
+
+	// Several producer threads share the arena
+	UINT allocations = threadArena->GetAllocations();
+	UINT failed = threadArena->GetFailedAllocations();
+	std::vector<std::thread> producers;
+	for (INT t = 0; t < 4; t++)
+	{
+		producers.emplace_back([&]() {
+			for (INT i = 0; i < 100; i++)
+			{
+				StructParam otherParam;
+				otherParam.val = i;
+				delegate(&otherParam, i);
+			}
+		});
+	}
+	for (auto& producer : producers)
+		producer.join();
+	param.val = 1001;
+	MakeDelegate(&ArenaMsgFunc, arenaThread, WAIT_INFINITE)(&param, 1001);
+	ASSERT_TRUE(arenaMsgCount == 1402);
+	ASSERT_TRUE(threadArena->GetAllocations() + threadArena->GetFailedAllocations() == allocations + failed + 2 * 401);
+	ASSERT_TRUE(threadArena->GetAllocations() > allocations + 2);
+	arenaThread.ExitThread();
+#endif
+}
+
+class AllocatorTestClass
+{
+public:
+	void Func(StructParam& s, INT i) { ASSERT_TRUE(s.val == i); count++; }
+	std::atomic<INT> count{0};
+};
+
+/// Records the size of the last allocation.
+class SizeRecordingAllocator : public IDelegateAllocator
+{
+public:
+	virtual void* Allocate(size_t size, size_t) override { lastSize = size; return ::operator new(size); }
+	virtual void Deallocate(void* block, size_t, size_t) override { ::operator delete(block); }
+	size_t lastSize = 0;
+};
+
+void DelegateAllocatorTests()
+{
+	// The computed allocate_shared sizes match this standard library's control blocks
+	SizeRecordingAllocator recorder;
+	typedef DelegateMemberAsync<void(AllocatorTestClass(StructParam&, INT))> MemberAsyncType;
+	typedef DelegateMsg2<StructParam*, INT> Msg2Type;
+	AllocatorTestClass sizeObject;
+	std::shared_ptr<MemberAsyncType> sizeInvoker = std::allocate_shared<MemberAsyncType>(
+		DelegateAllocatorAdapter<MemberAsyncType>(&recorder), &sizeObject, &AllocatorTestClass::Func, testThread);
+	ASSERT_TRUE(recorder.lastSize == DelegateSharedSize<MemberAsyncType>::value);
+	std::allocate_shared<Msg2Type>(DelegateAllocatorAdapter<Msg2Type>(&recorder), sizeInvoker, nullptr, 0);
+	ASSERT_TRUE(recorder.lastSize == DelegateSharedSize<Msg2Type>::value);
+	std::allocate_shared<DelegateMsgBase>(DelegateAllocatorAdapter<DelegateMsgBase>(&recorder), sizeInvoker);
+	ASSERT_TRUE(recorder.lastSize == DelegateSharedSize<DelegateMsgBase>::value);
+	std::allocate_shared<StructParam>(DelegateAllocatorAdapter<StructParam>(&recorder));
+	ASSERT_TRUE(recorder.lastSize == DelegateSharedSize<StructParam>::value);
+	std::allocate_shared<CHAR>(DelegateAllocatorAdapter<CHAR>(&recorder));
+	ASSERT_TRUE(recorder.lastSize == DelegateSharedSize<CHAR>::value);
+	sizeInvoker.reset();
+
+	// Messages, clones and argument copies of a delegate come from its allocator
+	DelegatePoolAllocator pool("DelegatePool");
+	arenaMsgCount = 0;
+	auto freeDelegate = MakeDelegate(&ArenaMsgFunc, testThread, pool);
+	for (INT i = 0; i < 100; i++)
+	{
+		StructParam param;
+		param.val = i;
+		freeDelegate(&param, i);
+	}
+	AllocatorTestClass object;
+	auto memberDelegate = MakeDelegate(&object, &AllocatorTestClass::Func, testThread, pool);
+	StructParam param;
+	param.val = 5;
+	memberDelegate(param, 5);
+	MakeDelegate(&FreeFunc0, testThread, WAIT_INFINITE)();
+	ASSERT_TRUE(arenaMsgCount == 100 && object.count == 1);
+	ASSERT_TRUE(pool.GetAllocations() == 3 * 101 && pool.GetBlocksInUse() == 0);
+
+	// The allocator is kept when a delegate is copied into a container
+	MulticastDelegateSafe<void(StructParam*, INT)> multicast;
+	multicast += MakeDelegate(&ArenaMsgFunc, testThread, pool);
+	multicast(&param, 5);
+	MakeDelegate(&FreeFunc0, testThread, WAIT_INFINITE)();
+	ASSERT_TRUE(pool.GetAllocations() == 3 * 102 && pool.GetBlocksInUse() == 0);
+
+#if USE_STD_THREADS
+	// Delegates without their own allocator use the target thread's allocator
+	DelegatePoolAllocator threadPool("ThreadPool");
+	WorkerThread poolThread("DelegatePoolThread");
+	poolThread.SetAllocator(&threadPool);
+	poolThread.CreateThread();
+	MakeDelegate(&ArenaMsgFunc, poolThread)(&param, 5);
+	MakeDelegate(&object, &AllocatorTestClass::Func, poolThread)(param, 5);
+	poolThread.ExitThread();
+	ASSERT_TRUE(threadPool.GetAllocations() == 2 * 4 && threadPool.GetBlocksInUse() == 0);
+#endif
+
+	// Over-aligned requests get aligned heap memory
+	UINT heapAllocations = pool.GetHeapAllocations();
+	void* alignedBlock = pool.Allocate(100, 128);
+	ASSERT_TRUE(((size_t)alignedBlock & 127) == 0 && pool.GetHeapAllocations() == heapAllocations + 1);
+	XallocFill(alignedBlock, 100);
+	pool.Deallocate(alignedBlock, 100, 128);
+
+	// Pools sized at compile time fit every message, clone and argument copy exactly
+	typedef DelegatePoolSizes<void(StructParam*, INT), void(AllocatorTestClass(StructParam&, INT))> TestPools;
+	static_assert(TestPools::HasBlockSize(sizeof(StructParam)), "Argument copy pool missing");
+	static_assert(TestPools::BlockSizes[0] == sizeof(StructParam) && TestPools::Count <= 5, "Pool sizes not distinct");
+	DelegatePoolAllocator exactPool(TestPools::BlockSizes, TestPools::Count, 16, "ExactPool");
+	UINT reserved = exactPool.GetAllocations();
+	MakeDelegate(&ArenaMsgFunc, testThread, exactPool)(&param, 5);
+	MakeDelegate(&object, &AllocatorTestClass::Func, testThread, exactPool)(param, 5);
+	MakeDelegate(&FreeFunc0, testThread, WAIT_INFINITE)();
+	ASSERT_TRUE(exactPool.GetAllocations() == reserved + 6 && exactPool.GetBlocksInUse() == 0);
+	ASSERT_TRUE(exactPool.GetWastedBytes() == 0 && exactPool.GetHeapAllocations() == 0);
+}
+
+static std::atomic<INT> fastTimerCount(0);
+static std::atomic<INT> cascadeTimerCount(0);
+static std::atomic<INT> slowTimerCount(0);
+static void FastTimerFunc() { fastTimerCount++; }
+static void CascadeTimerFunc() { cascadeTimerCount++; }
+static void SlowTimerFunc() { slowTimerCount++; }
+
+// Timers started from Expired callbacks while the wheel catches up
+static Timer* restartTimer;
+static std::atomic<bool> restartArmed(false);
+static std::atomic<unsigned long> restartStart(0);
+static std::atomic<unsigned long> restartElapsed(0);
+static std::atomic<INT> restartTimerCount(0);
+static void LagTimerFunc()
+{
+	// Hold up every ProcessTimers() caller so the next call has ticks to catch up
+	if (!restartArmed && restartTimerCount == 0 && restartStart == 0)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(60));
+		restartArmed = true;
+	}
+}
+static void KickTimerFunc()
+{
+	if (restartArmed.exchange(false))
+	{
+		restartStart = Timer::GetTime();
+		restartTimer->Start(40);
+	}
+}
+static void RestartTimerFunc()
+{
+	restartElapsed = Timer::Difference(restartStart, Timer::GetTime());
+	restartTimerCount++;
+	restartTimer->Stop();
+}
+
+void TimerTests()
+{
+	unsigned long active = Timer::GetActiveTimers();
+
+	// A 300 ms timer waits in the second wheel level until it cascades down
+	Timer fastTimer, cascadeTimer, slowTimer;
+	fastTimer.Expired = MakeDelegate(&FastTimerFunc);
+	cascadeTimer.Expired = MakeDelegate(&CascadeTimerFunc);
+	slowTimer.Expired = MakeDelegate(&SlowTimerFunc);
+	unsigned long start = Timer::GetTime();
+	fastTimer.Start(5);
+	cascadeTimer.Start(300);
+	slowTimer.Start(100000);
+	ASSERT_TRUE(Timer::GetActiveTimers() == active + 3);
+
+	// Starting and stopping many timers leaves the wheel as it was
+	{
+		std::vector<Timer> timers(10000);
+		for (size_t i = 0; i < timers.size(); i++)
+			timers[i].Start((unsigned long)(i * 7919 % 200000 + 1));
+		ASSERT_TRUE(Timer::GetActiveTimers() == active + 3 + 10000);
+		for (size_t i = 0; i < timers.size(); i += 2)
+			timers[i].Stop();
+		ASSERT_TRUE(Timer::GetActiveTimers() == active + 3 + 5000);
+	}
+	ASSERT_TRUE(Timer::GetActiveTimers() == active + 3);
+
+	while (cascadeTimerCount == 0 && Timer::Difference(start, Timer::GetTime()) < 5000)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(2));
+		Timer::ProcessTimers();
+	}
+	ASSERT_TRUE(cascadeTimerCount >= 1 && Timer::Difference(start, Timer::GetTime()) >= 300);
+	ASSERT_TRUE(fastTimerCount >= 10 && slowTimerCount == 0);
+
+	// A stopped timer no longer expires
+	fastTimer.Stop();
+	ASSERT_TRUE(!fastTimer.Enabled());
+	INT fastCount = fastTimerCount;
+	for (INT i = 0; i < 10; i++)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(2));
+		Timer::ProcessTimers();
+	}
+	ASSERT_TRUE(fastTimerCount == fastCount);
+
+	// A timer started from a callback during catch-up waits its full timeout
+	Timer lagTimer, kickTimer, restarted;
+	restartTimer = &restarted;
+	lagTimer.Expired = MakeDelegate(&LagTimerFunc);
+	kickTimer.Expired = MakeDelegate(&KickTimerFunc);
+	restarted.Expired = MakeDelegate(&RestartTimerFunc);
+	start = Timer::GetTime();
+	lagTimer.Start(10);
+	kickTimer.Start(5);
+	while (restartTimerCount == 0 && Timer::Difference(start, Timer::GetTime()) < 5000)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		Timer::ProcessTimers();
+	}
+	ASSERT_TRUE(restartTimerCount == 1 && restartElapsed >= 40);
+	lagTimer.Stop();
+	kickTimer.Stop();
+
+	cascadeTimer.Stop();
+	slowTimer.Stop();
+	ASSERT_TRUE(Timer::GetActiveTimers() == active);
+}
+
 void DelegateUnitTests()
 {
 	testThread.CreateThread();
@@ -2567,6 +3814,7 @@ void DelegateUnitTests()
 		DelegateMemberAsyncWaitTests();
 		DelegateMemberSpTests();
 		DelegateMemberAsyncSpTests();
+		DelegateRemoteTests();
 	}
 
 #ifdef WIN32
@@ -2577,6 +3825,12 @@ void DelegateUnitTests()
 	std::cout << "Elapsed Time: " << (float)ElapsedMicroseconds.QuadPart / 1000000.0f << " seconds" << std::endl;
 #endif
 
+	XallocatorTests();
+	ThreadSafeAllocatorTests();
+	MessageArenaTests();
+	DelegateAllocatorTests();
+	TimerTests();
+
 	testThread.ExitThread();
 }
 
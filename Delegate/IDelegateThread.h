@@ -2,6 +2,10 @@
 #define _DELEGATE_THREAD_H
 
 #include "DelegateMsg.h"
+#include "MessageArena.h"
+#include "DelegateAllocator.h"
+#include <memory>
+#include <utility>
 
 namespace DelegateLib {
 
@@ -22,8 +26,45 @@ public:
 	/// @pre Caller *must* create the DelegateMsg argument dynamically using operator new.
 	/// @post The destination thread must delete the msg instance by calling DelegateInvoke().
 	virtual void DispatchDelegate(std::shared_ptr<DelegateLib::DelegateMsgBase> msg) = 0;
+
+	/// Get the arena that messages dispatched to this thread are allocated from.
+	/// @return The message arena, or nullptr to allocate messages from the heap.
+	virtual MessageArena* GetMessageArena() { return nullptr; }
+
+	/// Get the allocator for the messages, delegate clones and argument copies of
+	/// asynchronous delegates targeting this thread that were not given their own.
+	/// @return The allocator, or nullptr to use the default allocation.
+	virtual IDelegateAllocator* GetAllocator() { return nullptr; }
 };
 
+/// Create a message to dispatch to a thread. The message comes from allocator if
+/// not nullptr, else from the thread's message arena if it has one, otherwise from
+/// the heap.
+/// @param[in] allocator - the allocator or nullptr.
+/// @param[in] thread - the destination thread.
+/// @param[in] args - the message constructor arguments.
+/// @return The new message.
+template <class TMsg, class... Args>
+std::shared_ptr<TMsg> MakeDelegateMsg(IDelegateAllocator* allocator, DelegateThread& thread, Args&&... args)
+{
+	if (allocator)
+		return std::allocate_shared<TMsg>(DelegateAllocatorAdapter<TMsg>(allocator), std::forward<Args>(args)...);
+	MessageArena* arena = thread.GetMessageArena();
+	if (arena)
+		return std::allocate_shared<TMsg>(MessageArenaAllocator<TMsg>(arena), std::forward<Args>(args)...);
+	return std::make_shared<TMsg>(std::forward<Args>(args)...);
+}
+
+/// Create a message to dispatch to a thread using the thread's allocator.
+/// @param[in] thread - the destination thread.
+/// @param[in] args - the message constructor arguments.
+/// @return The new message.
+template <class TMsg, class... Args>
+std::shared_ptr<TMsg> MakeDelegateMsg(DelegateThread& thread, Args&&... args)
+{
+	return MakeDelegateMsg<TMsg>(thread.GetAllocator(), thread, std::forward<Args>(args)...);
+}
+
 }
 
 #endif
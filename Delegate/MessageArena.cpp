@@ -0,0 +1,141 @@
+#include "MessageArena.h"
+#include "Fault.h"
+
+using namespace std;
+
+namespace DelegateLib
+{
+
+//------------------------------------------------------------------------------
+// Constructor
+//------------------------------------------------------------------------------
+MessageArena::MessageArena(size_t chunkSize, UINT chunks) :
+	m_chunkSize((chunkSize + HEADER_SIZE - 1) & ~(HEADER_SIZE - 1)),
+	m_chunks(chunks),
+	m_pMemory(NULL),
+	m_state(PackState(0, HEADER_SIZE)),
+	m_allocations(0),
+	m_failedAllocations(0)
+{
+	ASSERT_TRUE(m_chunks >= 2 && m_chunkSize > HEADER_SIZE && m_chunkSize <= 0xFFFFFFFF);
+	LockGuard::Create(&m_lock);
+	m_pMemory = new CHAR[m_chunkSize * m_chunks];
+	for (UINT i = 0; i < m_chunks; i++)
+		new (GetChunk(i)) Chunk();
+	GetChunk(0)->live.store(HELD, memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------
+// Destructor
+//------------------------------------------------------------------------------
+MessageArena::~MessageArena()
+{
+	// Every message has been released
+	UINT current = StateIndex(m_state.load());
+	ASSERT_TRUE(GetChunksInUse() == 1 && GetChunk(current)->live.load() == HELD);
+	delete [] m_pMemory;
+	LockGuard::Destroy(&m_lock);
+}
+
+//------------------------------------------------------------------------------
+// Allocate
+//------------------------------------------------------------------------------
+void* MessageArena::Allocate(size_t size, size_t alignment)
+{
+	// A message must fit in an empty chunk
+	if (size + alignment > m_chunkSize - HEADER_SIZE)
+	{
+		m_failedAllocations.fetch_add(1, memory_order_relaxed);
+		return NULL;
+	}
+
+	uint64_t state = m_state.load(memory_order_acquire);
+	for (;;)
+	{
+		UINT index = StateIndex(state);
+		uintptr_t chunk = (uintptr_t)GetChunk(index);
+		uintptr_t block = (chunk + StateOffset(state) + alignment - 1) & ~(uintptr_t)(alignment - 1);
+		if (block + size > chunk + m_chunkSize)
+		{
+			if (!NextChunk(state))
+			{
+				m_failedAllocations.fetch_add(1, memory_order_relaxed);
+				return NULL;
+			}
+			state = m_state.load(memory_order_acquire);
+			continue;
+		}
+
+		// Count the message before claiming its space. A successful claim means
+		// the chunk was still current, so its count still held the HELD bias and
+		// cannot have reached zero before this message was counted.
+		Chunk* pChunk = GetChunk(index);
+		pChunk->live.fetch_add(1, memory_order_relaxed);
+		if (m_state.compare_exchange_weak(state, PackState(index, block + size - chunk),
+			memory_order_acq_rel, memory_order_acquire))
+		{
+			m_allocations.fetch_add(1, memory_order_relaxed);
+			return (void*)block;
+		}
+		pChunk->live.fetch_sub(1, memory_order_relaxed);
+	}
+}
+
+//------------------------------------------------------------------------------
+// NextChunk
+//------------------------------------------------------------------------------
+BOOL MessageArena::NextChunk(uint64_t state)
+{
+	LockGuard lockGuard(&m_lock);
+
+	// The chunk index only changes under the lock. If another producer has
+	// already moved on, retry in the new chunk.
+	uint64_t current = m_state.load(memory_order_acquire);
+	UINT index = StateIndex(state);
+	if (StateIndex(current) != index)
+		return TRUE;
+
+	// Take the next chunk in the ring once its messages are all processed. The
+	// acquire pairs with the release in Deallocate() so the consumer is done with
+	// the old messages before the memory is reused. A producer counting a message
+	// against a stale state can briefly hold the count above zero; the arena then
+	// reports full and the caller falls back to the heap.
+	UINT next = (index + 1) % m_chunks;
+	UINT expected = 0;
+	if (!GetChunk(next)->live.compare_exchange_strong(expected, HELD, memory_order_acquire))
+		return FALSE;
+
+	// Other producers may still bump the old chunk's offset until it is replaced
+	while (!m_state.compare_exchange_weak(current, PackState(next, HEADER_SIZE), memory_order_acq_rel))
+		;
+
+	// Drop the bias; the old chunk is free once its remaining messages are released
+	GetChunk(index)->live.fetch_sub(HELD, memory_order_release);
+	return TRUE;
+}
+
+//------------------------------------------------------------------------------
+// Deallocate
+//------------------------------------------------------------------------------
+void MessageArena::Deallocate(void* block)
+{
+	ASSERT_TRUE(Owns(block));
+	UINT index = (UINT)(((CHAR*)block - m_pMemory) / m_chunkSize);
+	GetChunk(index)->live.fetch_sub(1, memory_order_release);
+}
+
+//------------------------------------------------------------------------------
+// GetChunksInUse
+//------------------------------------------------------------------------------
+UINT MessageArena::GetChunksInUse() const
+{
+	UINT inUse = 0;
+	for (UINT i = 0; i < m_chunks; i++)
+	{
+		if (GetChunk(i)->live.load(memory_order_relaxed) != 0)
+			inUse++;
+	}
+	return inUse;
+}
+
+}
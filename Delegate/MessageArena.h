@@ -0,0 +1,155 @@
+#ifndef _MESSAGE_ARENA_H
+#define _MESSAGE_ARENA_H
+
+// MessageArena.h
+// @see https://github.com/endurodave/AsyncMulticastDelegateCpp11
+
+#include "DataTypes.h"
+#include "LockGuard.h"
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <stdint.h>
+
+namespace DelegateLib {
+
+/// @brief A region allocator for the messages dispatched to one DelegateThread.
+/// Messages queued to a thread are processed in FIFO order, so their storage is
+/// bump allocated from a ring of fixed size chunks instead of the heap.
+///
+/// Any number of producer threads bump allocate from the current chunk with a
+/// compare-and-swap of the chunk offset. Each chunk counts its live messages: a
+/// producer counts its message before claiming the space and the consumer
+/// decrements the count when the message is released, so once every message in a
+/// chunk has been processed the whole chunk is free again and is reused when the
+/// ring comes round to it. Moving to the next chunk is rare and is serialized by a
+/// lock. If the next chunk still holds unprocessed messages (the consumer has
+/// fallen behind by the whole arena) or a message is larger than a chunk,
+/// Allocate() returns NULL and the caller uses the heap.
+///
+/// Deallocate() is lock-free and may be called by any thread.
+class MessageArena
+{
+public:
+	/// Constructor
+	/// @param[in] chunkSize - size of each chunk in bytes. Rounded up to a multiple
+	///		of the cache line size.
+	/// @param[in] chunks - number of chunks in the ring. At least 2.
+	MessageArena(size_t chunkSize, UINT chunks);
+
+	/// Destructor. Every allocation must have been deallocated.
+	~MessageArena();
+
+	/// Get memory for a message from the current chunk. Thread safe.
+	/// @param[in] size - size of the message in bytes.
+	/// @param[in] alignment - required alignment, a power of two.
+	/// @return Pointer to the memory, or NULL if the arena cannot satisfy the request.
+	void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+	/// Release a message obtained from Allocate(). Thread safe.
+	/// @param[in] block - the message memory.
+	void Deallocate(void* block);
+
+	/// Check whether memory belongs to the arena.
+	/// @param[in] block - the memory to check.
+	/// @return TRUE if block was returned by Allocate().
+	BOOL Owns(const void* block) const {
+		return (const CHAR*)block >= m_pMemory && (const CHAR*)block < m_pMemory + m_chunkSize * m_chunks; }
+
+	/// Gets the size of each chunk in bytes.
+	size_t GetChunkSize() const { return m_chunkSize; }
+
+	/// Gets the number of chunks in the ring.
+	UINT GetChunkCount() const { return m_chunks; }
+
+	/// Gets the number of chunks holding unprocessed messages, including the
+	/// current chunk. Approximate while messages are dispatched.
+	UINT GetChunksInUse() const;
+
+	/// Gets the number of successful allocations.
+	UINT GetAllocations() const { return m_allocations.load(std::memory_order_relaxed); }
+
+	/// Gets the number of requests the arena could not satisfy.
+	UINT GetFailedAllocations() const { return m_failedAllocations.load(std::memory_order_relaxed); }
+
+private:
+	MessageArena(const MessageArena&) = delete;
+	MessageArena& operator=(const MessageArena&) = delete;
+
+	/// Chunk header. While the chunk is current the count is biased by HELD so
+	/// that it never reaches zero as the consumer releases messages; the bias is
+	/// removed when the arena moves on to the next chunk.
+	struct Chunk
+	{
+		std::atomic<UINT> live;
+	};
+
+	static const size_t HEADER_SIZE = 64;
+	static const UINT HELD = 0x80000000;
+
+	/// The current chunk index and the offset of its free space are packed into
+	/// one word so producers claim space with a single compare-and-swap.
+	static uint64_t PackState(UINT index, size_t offset) { return ((uint64_t)index << 32) | (uint64_t)offset; }
+	static UINT StateIndex(uint64_t state) { return (UINT)(state >> 32); }
+	static size_t StateOffset(uint64_t state) { return (size_t)(state & 0xFFFFFFFF); }
+
+	/// Move from the chunk in state to the next chunk in the ring.
+	/// @return TRUE if the arena moved on (or another producer already did).
+	///		FALSE if the next chunk still holds unprocessed messages.
+	BOOL NextChunk(uint64_t state);
+
+	Chunk* GetChunk(UINT index) const { return (Chunk*)(m_pMemory + m_chunkSize * index); }
+
+	const size_t m_chunkSize;
+	const UINT m_chunks;
+	CHAR* m_pMemory;
+	std::atomic<uint64_t> m_state;
+	LOCK m_lock;
+	std::atomic<UINT> m_allocations;
+	std::atomic<UINT> m_failedAllocations;
+};
+
+/// @brief A standard library allocator that obtains memory from a MessageArena and
+/// falls back to operator new when the arena is full. Used with std::allocate_shared
+/// so the message and its shared_ptr control block share one arena allocation. The
+/// arena is not owned; every message must be released before the arena is destroyed.
+template <class T>
+class MessageArenaAllocator
+{
+public:
+	typedef T value_type;
+
+	MessageArenaAllocator(MessageArena* arena) : m_arena(arena) { }
+
+	template <class U>
+	MessageArenaAllocator(const MessageArenaAllocator<U>& other) : m_arena(other.GetArena()) { }
+
+	T* allocate(size_t n) {
+		void* mem = m_arena->Allocate(n * sizeof(T), alignof(T));
+		if (!mem)
+			mem = ::operator new(n * sizeof(T));
+		return static_cast<T*>(mem);
+	}
+
+	void deallocate(T* p, size_t) {
+		if (m_arena->Owns(p))
+			m_arena->Deallocate(p);
+		else
+			::operator delete(p);
+	}
+
+	MessageArena* GetArena() const { return m_arena; }
+
+private:
+	MessageArena* m_arena;
+};
+
+template <class T, class U>
+bool operator==(const MessageArenaAllocator<T>& a, const MessageArenaAllocator<U>& b) { return a.GetArena() == b.GetArena(); }
+
+template <class T, class U>
+bool operator!=(const MessageArenaAllocator<T>& a, const MessageArenaAllocator<U>& b) { return a.GetArena() != b.GetArena(); }
+
+}
+
+#endif
@@ -1,9 +1,15 @@
 #include "Allocator.h"
 #include "xallocator.h"
 #include "Fault.h"
+#include <algorithm>
+#include <atomic>
 #include <cstring>
+#include <fstream>
 #include <iostream>
+#include <map>
 #include <mutex>
+#include <new>
+#include <vector>
 
 using namespace std;
 
@@ -15,34 +21,178 @@ static BOOL _xallocInitialized = FALSE;
 
 // Define STATIC_POOLS to switch from heap blocks mode to static pools mode
 //#define STATIC_POOLS 
+
+// Define XALLOC_HUGE_PAGES to place every STATIC_POOLS pool in one memory region 
+// backed by huge pages where available (see Allocator::NewHugePages()) instead of 
+// static storage, so a few TLB entries cover all pools. 
+//#define XALLOC_HUGE_PAGES
+#if defined(XALLOC_HUGE_PAGES) && !defined(STATIC_POOLS)
+	#error XALLOC_HUGE_PAGES requires STATIC_POOLS
+#endif
+
 #ifdef STATIC_POOLS
-	// Update this section as necessary if you want to use static memory pools.
-	// See also xalloc_init() and xalloc_destroy() for additional updates required.
-	#define MAX_ALLOCATORS	12
-	#define MAX_BLOCKS		32
+	// Define XALLOC_POOL_CONFIG as a header written by xalloc_write_pool_config() to 
+	// use pools sized from a profile, e.g. -DXALLOC_POOL_CONFIG=\"xalloc_pools.h\". 
+	// Otherwise update this section as necessary. XALLOC_POOLS lists each pool as 
+	// XALLOC_POOL(block size, blocks) in increasing block size order. Above each power 
+	// of two, at most one block size may precede the next power of two. Block sizes 
+	// include the Allocator* header.
+	#ifdef XALLOC_POOL_CONFIG
+		#include XALLOC_POOL_CONFIG
+	#else
+		#define MAX_BLOCKS		32
+		#define XALLOC_POOLS(XALLOC_POOL) \
+			XALLOC_POOL(8, MAX_BLOCKS) \
+			XALLOC_POOL(16, MAX_BLOCKS) \
+			XALLOC_POOL(32, MAX_BLOCKS) \
+			XALLOC_POOL(64, MAX_BLOCKS) \
+			XALLOC_POOL(128, MAX_BLOCKS) \
+			XALLOC_POOL(256, MAX_BLOCKS) \
+			XALLOC_POOL(396, MAX_BLOCKS) \
+			XALLOC_POOL(512, MAX_BLOCKS) \
+			XALLOC_POOL(768, MAX_BLOCKS) \
+			XALLOC_POOL(1024, MAX_BLOCKS) \
+			XALLOC_POOL(2048, MAX_BLOCKS) \
+			XALLOC_POOL(4096, MAX_BLOCKS)
+	#endif
 
+#ifdef XALLOC_HUGE_PAGES
+	// Create static storage for each allocator instance. The pools follow each other 
+	// in the huge page region, each rounded up to a cache line.
+	#define XALLOC_POOL_STORAGE(size, blocks) \
+		alignas(Allocator) static CHAR _allocator##size [sizeof(Allocator)];
+	#define XALLOC_POOL_BYTES(size, blocks)	((((size_t)(size) * (blocks)) + 63) & ~(size_t)63)
+	#define XALLOC_POOL_TOTAL(size, blocks)	+ XALLOC_POOL_BYTES(size, blocks)
+	#define XALLOC_HUGE_PAGES_SIZE	(0 XALLOC_POOLS(XALLOC_POOL_TOTAL))
+	static CHAR* _hugePages;
+#else
 	// Create static storage for each static allocator instance
-	CHAR* _allocator8 [sizeof(AllocatorPool<CHAR[8], MAX_BLOCKS>)];
-	CHAR* _allocator16 [sizeof(AllocatorPool<CHAR[16], MAX_BLOCKS>)];
-	CHAR* _allocator32 [sizeof(AllocatorPool<CHAR[32], MAX_BLOCKS>)];
-	CHAR* _allocator64 [sizeof(AllocatorPool<CHAR[64], MAX_BLOCKS>)];
-	CHAR* _allocator128 [sizeof(AllocatorPool<CHAR[128], MAX_BLOCKS>)];
-	CHAR* _allocator256 [sizeof(AllocatorPool<CHAR[256], MAX_BLOCKS>)];
-	CHAR* _allocator396 [sizeof(AllocatorPool<CHAR[396], MAX_BLOCKS>)];
-	CHAR* _allocator512 [sizeof(AllocatorPool<CHAR[512], MAX_BLOCKS>)];
-	CHAR* _allocator768 [sizeof(AllocatorPool<CHAR[768], MAX_BLOCKS>)];
-	CHAR* _allocator1024 [sizeof(AllocatorPool<CHAR[1024], MAX_BLOCKS>)];
-	CHAR* _allocator2048 [sizeof(AllocatorPool<CHAR[2048], MAX_BLOCKS>)];	
-	CHAR* _allocator4096 [sizeof(AllocatorPool<CHAR[4096], MAX_BLOCKS>)];
+	#define XALLOC_POOL_STORAGE(size, blocks) \
+		alignas(AllocatorPool<CHAR[size], blocks>) static CHAR _allocator##size [sizeof(AllocatorPool<CHAR[size], blocks>)];
+#endif
+	XALLOC_POOLS(XALLOC_POOL_STORAGE)
+
+	#define XALLOC_POOL_COUNT(size, blocks)	+ 1
+	#define MAX_ALLOCATORS	(0 XALLOC_POOLS(XALLOC_POOL_COUNT))
+
+	#define XALLOC_POOL_SIZE(size, blocks)	size,
+	static const size_t _poolBlockSize[] = { XALLOC_POOLS(XALLOC_POOL_SIZE) };
+
+	#define XALLOC_POOL_BLOCKS(size, blocks)	blocks,
+	static const UINT _poolBlocks[] = { XALLOC_POOLS(XALLOC_POOL_BLOCKS) };
 
 	// Array of pointers to all allocator instances
-	static Allocator* _allocators[MAX_ALLOCATORS];
+	static std::atomic<Allocator*> _allocators[MAX_ALLOCATORS];
+
+	// Every pool may be cached by threads
+	#define MAX_CACHED_ALLOCATORS	MAX_ALLOCATORS
 
 #else
-	#define MAX_ALLOCATORS  15
-	static Allocator* _allocators[MAX_ALLOCATORS];
+	// Size classes from 8 bytes up to the largest power of two a size_t holds
+	#define MAX_ALLOCATORS  ((INT)(sizeof(size_t) * CHAR_BIT) - 1)
+	static std::atomic<Allocator*> _allocators[MAX_ALLOCATORS];
+
+	// Only the classes up to 1 MB are cached by threads
+	#define MAX_CACHED_ALLOCATORS	20
 #endif	// STATIC_POOLS
 
+// Allocators are indexed by size class. The classes are the powers of two from 8
+// bytes plus the 396 and 768 byte blocks, or the STATIC_POOLS block sizes, in 
+// increasing block size order. 
+static size_t _classBlockSize[MAX_ALLOCATORS];
+
+/// Size class lookup for one power of two bucket, i.e. blocks larger than half 
+/// the power of two and up to the power of two. A bucket holds at most two 
+/// classes: blocks up to split bytes use the lower class, others the upper class.
+struct XallocSizeClassEntry
+{
+	size_t split;
+	INT lower;
+	INT upper;
+};
+
+// Direct-indexed size class table built by xalloc_init(), indexed by the log2 
+// of the block size rounded up to a power of two. 
+static XallocSizeClassEntry _sizeClassTable[sizeof(size_t) * CHAR_BIT + 1];
+
+// Define XALLOC_NO_THREAD_CACHE to have every xmalloc/xfree lock the shared pools. 
+// Otherwise each thread keeps a small cache (magazine) of free blocks per allocator. 
+// Full magazines flush a batch to a lock-free depot shared by every thread and 
+// empty magazines refill from it, locking only when the allocator must supply new 
+// blocks. 
+//#define XALLOC_NO_THREAD_CACHE
+#ifndef XALLOC_MAGAZINE_SIZE
+	// Maximum free blocks of each size a thread may hold
+	#define XALLOC_MAGAZINE_SIZE	32
+#endif
+#ifndef XALLOC_POOL_CACHE_SHARE
+	// With STATIC_POOLS, a thread holds at most 1/XALLOC_POOL_CACHE_SHARE of a pool's 
+	// blocks, so idle threads cannot exhaust a pool. Pools too small for a magazine 
+	// of at least one block are not cached.
+	#define XALLOC_POOL_CACHE_SHARE	8
+#endif
+#ifndef XALLOC_DEPOT_SIZE
+	// Flushed batches of each size class held for any thread's magazine to take
+	#define XALLOC_DEPOT_SIZE	64
+#endif
+
+// Free blocks of each size class a thread cache may hold; 0 if the class is not cached
+static INT _magazineSize[MAX_ALLOCATORS];
+
+// Client calls of each size class not served by a thread cache. Guarded by the lock.
+static UINT _uncachedAllocations[MAX_ALLOCATORS];
+static UINT _uncachedDeallocations[MAX_ALLOCATORS];
+
+#ifndef XALLOC_NO_THREAD_CACHE
+static void xalloc_release_depots();
+#endif
+
+// Define XALLOC_CACHE_LINE_BLOCKS to align every block to a cache line and pad the 
+// block sizes to whole cache lines, so blocks used by different threads (e.g. async 
+// delegate messages) never share a cache line. Costs up to a cache line per block.
+//#define XALLOC_CACHE_LINE_BLOCKS
+#ifndef XALLOC_CACHE_LINE_SIZE
+	#define XALLOC_CACHE_LINE_SIZE	64
+#endif
+#if defined(XALLOC_CACHE_LINE_BLOCKS) && defined(STATIC_POOLS)
+	#error XALLOC_CACHE_LINE_BLOCKS requires heap blocks mode
+#endif
+
+// xmalloc_aligned() size classes, one set per alignment from 8 to XALLOC_MAX_ALIGNMENT 
+// bytes. A block of an aligned class is aligned to the alignment and starts with a 
+// header of that many bytes, so the client memory that follows is aligned too. 
+#define XALLOC_MAX_ALIGNMENT	64
+#define XALLOC_ALIGNED_SETS		4
+static std::atomic<Allocator*> _alignedAllocators[XALLOC_ALIGNED_SETS][MAX_ALLOCATORS];
+
+// Set in the Allocator* stored in blocks of an aligned class
+#define XALLOC_ALIGNED_TAG		((size_t)1)
+
+// Define XALLOC_SLABS to remove the per-block Allocator* header. Allocators carve 
+// blocks from slabs aligned to ALLOCATOR_SLAB_SIZE and xfree finds the owner in the 
+// slab header by masking the block address, so an 8 byte object uses an 8 byte block.
+//#define XALLOC_SLABS
+#ifdef XALLOC_SLABS
+	#ifdef STATIC_POOLS
+		#error XALLOC_SLABS requires heap blocks mode
+	#endif
+	#define XALLOC_HEADER_SIZE	0
+#else
+	#define XALLOC_HEADER_SIZE	sizeof(Allocator*)
+#endif
+
+// Define XALLOC_PROFILE to record a histogram of the sizes requested from xmalloc() 
+// with the peak number of blocks of each size in use at once. The last UINT32 of each 
+// block holds its profile bucket, so profiled requests may use a larger size class. 
+// See xalloc_get_profile() and xalloc_write_pool_config().
+//#define XALLOC_PROFILE
+#ifndef XALLOC_PROFILE_MAX_SIZE
+	// Largest requested size recorded individually
+	#define XALLOC_PROFILE_MAX_SIZE		65536
+#endif
+// Requested sizes are recorded in buckets of this many bytes
+#define XALLOC_PROFILE_GRANULARITY	8
+
 // For C++ applications, must define AUTOMATIC_XALLOCATOR_INIT_DESTROY to 
 // correctly ensure allocators are initialized before any static user C++ 
 // construtor/destructor executes which might call into the xallocator API. 
@@ -73,17 +223,19 @@ XallocInitDestroy::~XallocInitDestroy()
 }
 #endif	// AUTOMATIC_XALLOCATOR_INIT_DESTROY
 
-/// Returns the next higher powers of two. For instance, pass in 12 and 
-/// the value returned would be 16. 
-/// @param[in] k - numeric value to compute the next higher power of two.
-/// @return	The next higher power of two based on the input k. 
-template <class T>
-T nexthigher(T k) 
+/// Returns log2 of the next higher power of two. For instance, pass in 12 and 
+/// the value returned would be 4. 
+/// @param[in] k - numeric value greater than 0.
+static inline INT log2higher(size_t k)
 {
-    k--;
-    for (size_t i=1; i<sizeof(T)*CHAR_BIT; i<<=1)
-        k |= (k >> i);
-    return k+1;
+#if defined(__GNUC__)
+	return (k <= 1) ? 0 : (INT)(sizeof(unsigned long long) * CHAR_BIT) - __builtin_clzll((unsigned long long)(k - 1));
+#else
+	INT log2 = 0;
+	while (log2 < (INT)(sizeof(size_t) * CHAR_BIT) && ((size_t)1 << log2) < k)
+		log2++;
+	return log2;
+#endif
 }
 
 static std::mutex& get_mutex()
@@ -92,6 +244,27 @@ static std::mutex& get_mutex()
 	return _mutex;
 }
 
+#ifdef XALLOC_SLABS
+// The slab header records the allocator; the client memory is the raw block.
+static inline void *set_block_allocator(void* block, Allocator* allocator)
+{
+	return block;
+}
+
+/// Gets the allocator instance from the header of the block's slab.
+/// @param[in] block - a pointer to the client's memory block. 
+/// @return	The original allocator instance of the memory block.
+static inline Allocator* get_block_allocator(void* block)
+{
+	return Allocator::GetSlabOwner(block);
+}
+
+/// Returns the raw memory block pointer given a client memory pointer. 
+static inline void *get_block_ptr(void* block)
+{
+	return block;
+}
+#else
 // Stored a pointer to the allocator instance within the block region. 
 ///	a pointer to the client's area within the block.
 /// @param[in] block - a pointer to the raw memory block. 
@@ -122,7 +295,14 @@ static inline Allocator* get_block_allocator(void* block)
 	pAllocatorInBlock--;
 
 	// Return the allocator instance stored within the memory block
-	return *pAllocatorInBlock;
+	return (Allocator*)((size_t)*pAllocatorInBlock & ~XALLOC_ALIGNED_TAG);
+}
+
+/// Returns TRUE if the block was allocated by xmalloc_aligned() from an aligned class.
+/// @param[in] block - a pointer to the client memory block. 
+static inline BOOL is_aligned_block(void* block)
+{
+	return ((size_t)static_cast<Allocator**>(block)[-1] & XALLOC_ALIGNED_TAG) ? TRUE : FALSE;
 }
 
 /// Returns the raw memory block pointer given a client memory pointer. 
@@ -130,83 +310,184 @@ static inline Allocator* get_block_allocator(void* block)
 /// @return	A pointer to the original raw memory block address. 
 static inline void *get_block_ptr(void* block)
 {
+	// An aligned class header is as long as the block alignment
+	if (is_aligned_block(block))
+		return static_cast<CHAR*>(block) - get_block_allocator(block)->GetAlignment();
+
 	// Cast the client memory to a Allocator* pointer
 	Allocator** pAllocatorInBlock = static_cast<Allocator**>(block);
 
 	// Back up one Allocator* position and return the original raw memory block pointer
 	return --pAllocatorInBlock;
 }
+#endif	// XALLOC_SLABS
+
+#ifdef XALLOC_PROFILE
+// One bucket per XALLOC_PROFILE_GRANULARITY bytes of requested size, plus a last 
+// bucket for requests larger than XALLOC_PROFILE_MAX_SIZE
+#define XALLOC_PROFILE_BUCKETS	(XALLOC_PROFILE_MAX_SIZE / XALLOC_PROFILE_GRANULARITY + 2)
 
-/// Returns an allocator instance matching the size provided
-/// @param[in] size - allocator block size
-/// @return Allocator instance handling requested block size or NULL
-/// if no allocator exists. 
-static inline Allocator* find_allocator(size_t size)
+/// Profile counters of the requests of one bucket of sizes.
+struct XallocProfileBucket
 {
-	for (INT i=0; i<MAX_ALLOCATORS; i++)
-	{
-		if (_allocators[i] == 0)
-			break;
-		
-		if (_allocators[i]->GetBlockSize() == size)
-			return _allocators[i];
-	}
-	
-	return NULL;
+	std::atomic<UINT> allocations;
+	std::atomic<UINT> inUse;
+	std::atomic<UINT> peak;
+};
+static XallocProfileBucket _profile[XALLOC_PROFILE_BUCKETS];
+
+/// Returns the profile bucket index stored in the last UINT32 of a raw block.
+static inline UINT32* get_profile_bucket(void* blockPtr, Allocator* allocator)
+{
+	return reinterpret_cast<UINT32*>(static_cast<CHAR*>(blockPtr) + allocator->GetBlockSize() - sizeof(UINT32));
 }
 
-/// Insert an allocator instance into the array
-/// @param[in] allocator - An allocator instance
-static inline void insert_allocator(Allocator* allocator)
+/// Record an xmalloc() request in the profile.
+/// @param[in] blockPtr - the raw memory block. 
+/// @param[in] allocator - the block's allocator.
+/// @param[in] size - the client requested size.
+static void xalloc_profile_allocate(void* blockPtr, Allocator* allocator, size_t size)
 {
+	UINT32 bucket = (size <= XALLOC_PROFILE_MAX_SIZE) ? 
+		(UINT32)((size + XALLOC_PROFILE_GRANULARITY - 1) / XALLOC_PROFILE_GRANULARITY) : XALLOC_PROFILE_BUCKETS - 1;
+	*get_profile_bucket(blockPtr, allocator) = bucket;
+
+	XallocProfileBucket& profile = _profile[bucket];
+	profile.allocations.fetch_add(1, memory_order_relaxed);
+	UINT inUse = profile.inUse.fetch_add(1, memory_order_relaxed) + 1;
+	UINT peak = profile.peak.load(memory_order_relaxed);
+	while (inUse > peak && !profile.peak.compare_exchange_weak(peak, inUse, memory_order_relaxed))
+		;
+}
+
+/// Record the xfree() of a block allocated by xmalloc() in the profile.
+static void xalloc_profile_deallocate(void* blockPtr, Allocator* allocator)
+{
+	_profile[*get_profile_bucket(blockPtr, allocator)].inUse.fetch_sub(1, memory_order_relaxed);
+}
+#endif	// XALLOC_PROFILE
+
+/// Returns the size class for a block size. O(1); no allocator is searched. 
+/// @param[in] blockSize - the raw block size including the Allocator* header.
+/// @return Index of the size class holding blocks of blockSize bytes or -1
+/// if blockSize is larger than the largest class. 
+static inline INT xalloc_size_class(size_t blockSize)
+{
+	const XallocSizeClassEntry& entry = _sizeClassTable[log2higher(blockSize)];
+	return (blockSize <= entry.split) ? entry.lower : entry.upper;
+}
+
+/// Returns the size class of a standard block for the thread cache.
+/// @param[in] block - a pointer to the client memory block. 
+/// @param[in] allocator - the block's allocator.
+/// @return The size class or -1 if the block is from an aligned class.
+static inline INT get_block_class(void* block, Allocator* allocator)
+{
+#ifdef XALLOC_SLABS
+	// An aligned class allocator is not the standard allocator of its size
+	INT index = xalloc_size_class(allocator->GetBlockSize());
+	return (_allocators[index].load(memory_order_relaxed) == allocator) ? index : -1;
+#else
+	return is_aligned_block(block) ? -1 : xalloc_size_class(allocator->GetBlockSize());
+#endif
+}
+
+/// Build the size classes and the lookup table. 
+static void xalloc_build_size_classes()
+{
+#ifdef STATIC_POOLS
 	for (INT i=0; i<MAX_ALLOCATORS; i++)
 	{
-		if (_allocators[i] == 0)
+		_classBlockSize[i] = _poolBlockSize[i];
+		_magazineSize[i] = (INT)std::min<UINT>(XALLOC_MAGAZINE_SIZE, _poolBlocks[i] / XALLOC_POOL_CACHE_SHARE);
+	}
+#else
+	// Powers of two, with the 396 and 768 byte blocks inserted to minimize wasted 
+	// storage for common sizes. This offers application specific tuning.
+	size_t blockSize = 8;
+	for (INT i=0; i<MAX_ALLOCATORS; i++)
+	{
+#ifdef XALLOC_CACHE_LINE_BLOCKS
+		// Whole cache lines. The smallest classes round to the same size and the 
+		// lookup table only uses the first of them.
+		_classBlockSize[i] = (blockSize + XALLOC_CACHE_LINE_SIZE - 1) & ~(size_t)(XALLOC_CACHE_LINE_SIZE - 1);
+#elif defined(XALLOC_SLABS)
+		// Slab blocks are contiguous; keep every block pointer aligned
+		_classBlockSize[i] = (blockSize + sizeof(Allocator*) - 1) & ~(sizeof(Allocator*) - 1);
+#else
+		_classBlockSize[i] = blockSize;
+#endif
+		_magazineSize[i] = (i < MAX_CACHED_ALLOCATORS) ? XALLOC_MAGAZINE_SIZE : 0;
+		if (blockSize == 256)
+			blockSize = 396;
+		else if (blockSize == 396)
+			blockSize = 512;
+		else if (blockSize == 512)
+			blockSize = 768;
+		else if (blockSize == 768)
+			blockSize = 1024;
+		else
+			blockSize <<= 1;
+	}
+#endif
+
+	for (INT log2=0; log2<(INT)(sizeof(_sizeClassTable) / sizeof(_sizeClassTable[0])); log2++)
+	{
+		// Smallest class holding blocks of the bucket's lowest size
+		size_t low = (log2 == 0) ? 1 : ((size_t)1 << (log2 - 1)) + 1;
+		INT lower = 0;
+		while (lower < MAX_ALLOCATORS && _classBlockSize[lower] < low)
+			lower++;
+
+		XallocSizeClassEntry& entry = _sizeClassTable[log2];
+		if (lower == MAX_ALLOCATORS)
 		{
-			_allocators[i] = allocator;
-			return;
+			entry.split = 0;
+			entry.lower = entry.upper = -1;
+			continue;
+		}
+		entry.split = _classBlockSize[lower];
+		entry.lower = lower;
+		entry.upper = -1;
+		if (log2 < (INT)(sizeof(size_t) * CHAR_BIT) && entry.split < ((size_t)1 << log2) && 
+			lower + 1 < MAX_ALLOCATORS)
+		{
+			// The next class holds the rest of the bucket, so only one class of a 
+			// bucket may be smaller than its power of two
+			entry.upper = lower + 1;
+			ASSERT_TRUE(_classBlockSize[entry.upper] >= ((size_t)1 << log2));
 		}
 	}
-	
-	ASSERT();
 }
 
 /// This function must be called exactly one time *before* any other xallocator
 /// API is called. XallocInitDestroy constructor calls this function automatically. 
 extern "C" void xalloc_init()
 {
+	xalloc_build_size_classes();
+	_xallocInitialized = TRUE;
+
 #ifdef STATIC_POOLS
 	get_mutex().lock();
 
 	// For STATIC_POOLS mode, the allocators must be initialized before any other
 	// static user class constructor is run. Therefore, use placement new to initialize
-	// each allocator into the previously reserved static memory locations.
-	new (&_allocator8) AllocatorPool<CHAR[8], MAX_BLOCKS>();
-	new (&_allocator16) AllocatorPool<CHAR[16], MAX_BLOCKS>();
-	new (&_allocator32) AllocatorPool<CHAR[32], MAX_BLOCKS>();
-	new (&_allocator64) AllocatorPool<CHAR[64], MAX_BLOCKS>();
-	new (&_allocator128) AllocatorPool<CHAR[128], MAX_BLOCKS>();
-	new (&_allocator256) AllocatorPool<CHAR[256], MAX_BLOCKS>();
-	new (&_allocator396) AllocatorPool<CHAR[396], MAX_BLOCKS>();
-	new (&_allocator512) AllocatorPool<CHAR[512], MAX_BLOCKS>();
-	new (&_allocator768) AllocatorPool<CHAR[768], MAX_BLOCKS>();
-	new (&_allocator1024) AllocatorPool<CHAR[1024], MAX_BLOCKS>();
-	new (&_allocator2048) AllocatorPool<CHAR[2048], MAX_BLOCKS>();
-	new (&_allocator4096) AllocatorPool<CHAR[4096], MAX_BLOCKS>();
-
-	// Populate allocator array with all instances 
-	_allocators[0] = (Allocator*)&_allocator8;
-	_allocators[1] = (Allocator*)&_allocator16;
-	_allocators[2] = (Allocator*)&_allocator32;
-	_allocators[3] = (Allocator*)&_allocator64;
-	_allocators[4] = (Allocator*)&_allocator128;
-	_allocators[5] = (Allocator*)&_allocator256;
-	_allocators[6] = (Allocator*)&_allocator396;
-	_allocators[7] = (Allocator*)&_allocator512;
-	_allocators[8] = (Allocator*)&_allocator768;
-	_allocators[9] = (Allocator*)&_allocator1024;
-	_allocators[10] = (Allocator*)&_allocator2048;
-	_allocators[11] = (Allocator*)&_allocator4096;
+	// each allocator into the previously reserved static memory locations and 
+	// populate the allocator array with all instances.
+	INT index = 0;
+#ifdef XALLOC_HUGE_PAGES
+	_hugePages = Allocator::NewHugePages(XALLOC_HUGE_PAGES_SIZE);
+	CHAR* poolMemory = _hugePages;
+	#define XALLOC_POOL_NEW(size, blocks) \
+		new (&_allocator##size) Allocator(size, blocks, poolMemory); \
+		poolMemory += XALLOC_POOL_BYTES(size, blocks); \
+		_allocators[index++] = (Allocator*)&_allocator##size;
+#else
+	#define XALLOC_POOL_NEW(size, blocks) \
+		new (&_allocator##size) AllocatorPool<CHAR[size], blocks>(); \
+		_allocators[index++] = (Allocator*)&_allocator##size;
+#endif
+	XALLOC_POOLS(XALLOC_POOL_NEW)
 
 	get_mutex().unlock();
 #endif
@@ -218,47 +499,61 @@ extern "C" void xalloc_destroy()
 {
 	get_mutex().lock();
 
+#ifndef XALLOC_NO_THREAD_CACHE
+	xalloc_release_depots();
+#endif
+
 #ifdef STATIC_POOLS
 	for (INT i=0; i<MAX_ALLOCATORS; i++)
 	{
-		_allocators[i]->~Allocator();
+		_allocators[i].load()->~Allocator();
 		_allocators[i] = 0;
 	}
+#ifdef XALLOC_HUGE_PAGES
+	Allocator::DeleteHugePages(_hugePages, XALLOC_HUGE_PAGES_SIZE);
+	_hugePages = NULL;
+#endif
 #else
 	for (INT i=0; i<MAX_ALLOCATORS; i++)
 	{
-		if (_allocators[i] == 0)
-			break;
-		delete _allocators[i];
+		delete _allocators[i].load();
 		_allocators[i] = 0;
 	}
 #endif
 
+	for (INT set=0; set<XALLOC_ALIGNED_SETS; set++)
+	{
+		for (INT i=0; i<MAX_ALLOCATORS; i++)
+		{
+			delete _alignedAllocators[set][i].load();
+			_alignedAllocators[set][i] = 0;
+		}
+	}
+
 	get_mutex().unlock();
 }
 
+/// Get the size class for the client's requested block size. Add the header size
+/// to the requested block size to hold the allocator within the block memory region.
+///	@param[in] size - the client's requested block size.
+///	@return The size class index or -1 if the size is too large.
+static inline INT xalloc_request_class(size_t size)
+{
+	return xalloc_size_class(size + XALLOC_HEADER_SIZE);
+}
+
 /// Get an Allocator instance based upon the client's requested block size.
 /// If a Allocator instance is not currently available to handle the size,
-///	then a new Allocator instance is create.
+///	then a new Allocator instance is create. Caller must hold the lock.
 ///	@param[in] size - the client's requested block size.
 ///	@return An Allocator instance that handles blocks of the requested
 ///	size.
 extern "C" Allocator* xallocator_get_allocator(size_t size)
 {
-	// Based on the size, find the next higher powers of two value.
-	// Add sizeof(Allocator*) to the requested block size to hold the size
-	// within the block memory region. Most blocks are powers of two,
-	// however some common allocator block sizes can be explicitly defined
-	// to minimize wasted storage. This offers application specific tuning.
-	size_t blockSize = size + sizeof(Allocator*);
-	if (blockSize > 256 && blockSize <= 396)
-		blockSize = 396;
-	else if (blockSize > 512 && blockSize <= 768)
-		blockSize = 768;
-	else
-		blockSize = nexthigher<size_t>(blockSize);
-
-	Allocator* allocator = find_allocator(blockSize);
+	ASSERT_TRUE(_xallocInitialized);
+	INT index = xalloc_request_class(size);
+	ASSERT_TRUE(index >= 0);
+	Allocator* allocator = _allocators[index].load(memory_order_relaxed);
 
 #ifdef STATIC_POOLS
 	ASSERT_TRUE(allocator != NULL);
@@ -266,36 +561,574 @@ extern "C" Allocator* xallocator_get_allocator(size_t size)
 	// If there is not an allocator already created to handle this block size
 	if (allocator == NULL)  
 	{
-		// Create a new allocator to handle blocks of the size required
-		allocator = new Allocator(blockSize, 0, 0, "xallocator");
-
-		// Insert allocator into array
-		insert_allocator(allocator);
+		// Create a new allocator to handle blocks of the size required. Allocators 
+		// are only ever added, so the array may be read without the lock.
+#ifdef XALLOC_CACHE_LINE_BLOCKS
+		const size_t alignment = XALLOC_CACHE_LINE_SIZE;
+#else
+		const size_t alignment = 0;
+#endif
+#ifdef XALLOC_SLABS
+		allocator = new Allocator(_classBlockSize[index], 0, 0, "xallocator", alignment, Allocator::SLABS);
+#else
+		allocator = new Allocator(_classBlockSize[index], 0, 0, "xallocator", alignment);
+#endif
+		_allocators[index].store(allocator, memory_order_release);
 	}
 #endif
 	
 	return allocator;
 }
 
+/// Get the aligned class Allocator instance for the client's requested block size 
+/// and alignment, creating it if necessary. Caller must hold the lock.
+///	@param[in] size - the client's requested block size.
+///	@param[in] alignment - a power of two from 8 to XALLOC_MAX_ALIGNMENT.
+///	@return An Allocator instance of blocks aligned to alignment with room for 
+///	an alignment sized header followed by size bytes.
+static Allocator* xallocator_get_aligned_allocator(size_t size, size_t alignment)
+{
+	ASSERT_TRUE(_xallocInitialized);
+	INT set = log2higher(alignment) - 3;
+	INT index = xalloc_size_class(size + (XALLOC_HEADER_SIZE ? alignment : 0));
+	ASSERT_TRUE(index >= 0);
+
+	Allocator* allocator = _alignedAllocators[set][index].load(memory_order_relaxed);
+	if (allocator == NULL)
+	{
+		size_t blockSize = (_classBlockSize[index] + alignment - 1) & ~(alignment - 1);
+#ifdef XALLOC_SLABS
+		allocator = new Allocator(blockSize, 0, 0, "xallocator aligned", alignment, Allocator::SLABS);
+#else
+		allocator = new Allocator(blockSize, 0, 0, "xallocator aligned", alignment);
+#endif
+		_alignedAllocators[set][index].store(allocator, memory_order_relaxed);
+	}
+	return allocator;
+}
+
+#ifndef XALLOC_NO_THREAD_CACHE
+/// A thread's cache of free blocks, one magazine per allocator. A full magazine 
+/// parks a batch of blocks in its size class's lock-free depot, and an empty magazine 
+/// takes a whole batch back, so blocks allocated by one thread and freed by another 
+/// (e.g. async delegate messages) circulate without locking or walking the blocks. 
+/// Batches that do not fit the depot go to the allocator's remote free list. The 
+/// lock is only taken to get new blocks from an allocator. 
+class XallocThreadCache
+{
+public:
+	XallocThreadCache();
+	~XallocThreadCache();
+
+	/// Get the calling thread's cache, creating it on first use.
+	/// @return The cache, or NULL once the thread's cache is destroyed at thread exit.
+	static XallocThreadCache* Get();
+
+	/// Get a block from the allocator at index, refilling the magazine if empty.
+	void* Allocate(INT index);
+
+	/// Cache a free block of the allocator at index, flushing if the magazine is full.
+	void Deallocate(INT index, void* block);
+
+	/// TRUE once this thread's cache is destroyed at thread exit. Blocks then go 
+	/// straight to the shared allocators. 
+	static thread_local BOOL destroyed;
+
+	/// Get the free blocks of a size class held by every thread's cache. Caller 
+	/// must hold the lock.
+	static UINT GetCachedBlocks(INT index);
+
+	/// Get the client allocations and deallocations of a size class served by 
+	/// every thread's cache, including caches of threads that have exited. Caller 
+	/// must hold the lock.
+	static void GetClientCounts(INT index, UINT& allocations, UINT& deallocations);
+
+	/// Return the depot's batches to their allocators' remote free lists so the 
+	/// allocators reclaim them when destroyed. Caller must hold the lock.
+	static void ReleaseDepots();
+
+private:
+	/// Create the calling thread's cache. Its memory comes from malloc() so an 
+	/// application routing operator new to xmalloc() cannot recurse here.
+	static XallocThreadCache* Create();
+
+	/// Get a block from the magazine's chain, the depot or the allocator once the 
+	/// magazine is empty.
+	void* Refill(INT index);
+
+	/// Keep a magazine of a chain reclaimed from the remote free list and share the 
+	/// rest in depot batches, visiting each block once.
+	void Reclaim(INT index, void* chain);
+
+	/// Return the oldest count blocks of a magazine to the depot, or to its 
+	/// allocator's remote free list if not a full batch or the depot is full.
+	void Flush(INT index, INT count);
+
+	/// Blocks in one depot batch, half a magazine.
+	static INT BatchSize(INT index) { return (_magazineSize[index] + 1) / 2; }
+
+	/// Park a chain of BatchSize() blocks in the depot.
+	/// @return TRUE if parked, FALSE if the depot is full.
+	static BOOL PutBatch(INT index, void* batch);
+
+	/// Take a chain of BatchSize() blocks from the depot.
+	/// @return The batch, or NULL if the depot is empty.
+	static void* TakeBatch(INT index);
+
+	/// Update the cached block count read by GetCachedBlocks(). Only the owning 
+	/// thread writes it, so no read-modify-write is needed.
+	void AddCached(INT index, INT count) {
+		std::atomic<UINT>& cached = m_magazines[index].cached;
+		cached.store(cached.load(memory_order_relaxed) + count, memory_order_relaxed); }
+
+	/// Count a client call served by the cache. Only the owning thread writes it.
+	static void AddCount(std::atomic<UINT>& counter) {
+		counter.store(counter.load(memory_order_relaxed) + 1, memory_order_relaxed); }
+
+	/// The counters sit with the magazine's state so a call touches few cache lines.
+	struct Magazine
+	{
+		INT count;
+		void* chain;		// Blocks taken from the depot or the remote free list
+		std::atomic<UINT> cached;			// Blocks in the magazine and chain
+		std::atomic<UINT> allocations;		// Client xmalloc() calls served
+		std::atomic<UINT> deallocations;	// Client xfree() calls served
+		void* blocks[XALLOC_MAGAZINE_SIZE];
+	};
+
+	/// Each slot holds the first block of a NULL terminated chain, or NULL if empty. 
+	/// The count lets an empty or full depot be skipped without scanning the slots.
+	struct Depot
+	{
+		std::atomic<void*> batches[XALLOC_DEPOT_SIZE];
+		std::atomic<INT> count;
+	};
+
+	Magazine m_magazines[MAX_CACHED_ALLOCATORS] = {};
+
+	// Client calls served by the caches of threads that have exited
+	static UINT m_exitedAllocations[MAX_CACHED_ALLOCATORS];
+	static UINT m_exitedDeallocations[MAX_CACHED_ALLOCATORS];
+
+	// Every thread's cache, linked under the lock for GetCachedBlocks()
+	XallocThreadCache* m_next;
+	static XallocThreadCache* m_caches;
+
+	// Full batches of each size class shared by every thread
+	static Depot m_depots[MAX_CACHED_ALLOCATORS];
+};
+
+thread_local BOOL XallocThreadCache::destroyed = FALSE;
+XallocThreadCache* XallocThreadCache::m_caches = NULL;
+UINT XallocThreadCache::m_exitedAllocations[MAX_CACHED_ALLOCATORS];
+UINT XallocThreadCache::m_exitedDeallocations[MAX_CACHED_ALLOCATORS];
+XallocThreadCache::Depot XallocThreadCache::m_depots[MAX_CACHED_ALLOCATORS];
+
+// The calling thread's cache. A plain pointer needs no per-access initialization 
+// check, unlike a thread_local object with a constructor, keeping xmalloc() and 
+// xfree() fast. 
+static thread_local XallocThreadCache* _pThreadCache = NULL;
+
+/// Destroys the thread's cache at thread exit.
+struct XallocThreadCacheOwner
+{
+	XallocThreadCache* cache;
+	~XallocThreadCacheOwner()
+	{
+		if (cache == NULL)
+			return;
+		_pThreadCache = NULL;
+		cache->~XallocThreadCache();
+		free(cache);
+	}
+};
+static thread_local XallocThreadCacheOwner _threadCacheOwner;
+
+inline XallocThreadCache* XallocThreadCache::Get()
+{
+	XallocThreadCache* cache = _pThreadCache;
+	return (cache != NULL) ? cache : Create();
+}
+
+XallocThreadCache* XallocThreadCache::Create()
+{
+	if (destroyed)
+		return NULL;
+	void* memory = malloc(sizeof(XallocThreadCache));
+	if (memory == NULL)
+		return NULL;
+	_threadCacheOwner.cache = new (memory) XallocThreadCache();
+	_pThreadCache = _threadCacheOwner.cache;
+	return _pThreadCache;
+}
+
+XallocThreadCache::XallocThreadCache()
+{
+	for (INT i=0; i<MAX_CACHED_ALLOCATORS; i++)
+	{
+		m_magazines[i].cached.store(0, memory_order_relaxed);
+		m_magazines[i].allocations.store(0, memory_order_relaxed);
+		m_magazines[i].deallocations.store(0, memory_order_relaxed);
+	}
+
+	lock_guard<mutex> lock(get_mutex());
+	m_next = m_caches;
+	m_caches = this;
+}
+
+XallocThreadCache::~XallocThreadCache()
+{
+	for (INT i=0; i<MAX_CACHED_ALLOCATORS; i++)
+	{
+		Magazine& magazine = m_magazines[i];
+		Flush(i, magazine.count);
+		if (magazine.chain)
+		{
+			void* last = magazine.chain;
+			while (Allocator::NextBlock(last))
+				last = Allocator::NextBlock(last);
+			_allocators[i].load(memory_order_relaxed)->DeallocateRemote(magazine.chain, last);
+		}
+		magazine.cached.store(0, memory_order_relaxed);
+	}
+	destroyed = TRUE;
+
+	lock_guard<mutex> lock(get_mutex());
+	for (INT i=0; i<MAX_CACHED_ALLOCATORS; i++)
+	{
+		m_exitedAllocations[i] += m_magazines[i].allocations.load(memory_order_relaxed);
+		m_exitedDeallocations[i] += m_magazines[i].deallocations.load(memory_order_relaxed);
+	}
+	XallocThreadCache** link = &m_caches;
+	while (*link != this)
+		link = &(*link)->m_next;
+	*link = m_next;
+}
+
+UINT XallocThreadCache::GetCachedBlocks(INT index)
+{
+	UINT cached = 0;
+	if (index >= MAX_CACHED_ALLOCATORS)
+		return cached;
+	for (XallocThreadCache* cache = m_caches; cache != NULL; cache = cache->m_next)
+		cached += cache->m_magazines[index].cached.load(memory_order_relaxed);
+	return cached;
+}
+
+void XallocThreadCache::GetClientCounts(INT index, UINT& allocations, UINT& deallocations)
+{
+	allocations = 0;
+	deallocations = 0;
+	if (index >= MAX_CACHED_ALLOCATORS)
+		return;
+	allocations = m_exitedAllocations[index];
+	deallocations = m_exitedDeallocations[index];
+	for (XallocThreadCache* cache = m_caches; cache != NULL; cache = cache->m_next)
+	{
+		allocations += cache->m_magazines[index].allocations.load(memory_order_relaxed);
+		deallocations += cache->m_magazines[index].deallocations.load(memory_order_relaxed);
+	}
+}
+
+void XallocThreadCache::ReleaseDepots()
+{
+	for (INT i=0; i<MAX_CACHED_ALLOCATORS; i++)
+	{
+		void* batch;
+		while ((batch = TakeBatch(i)) != NULL)
+		{
+			void* last = batch;
+			while (Allocator::NextBlock(last))
+				last = Allocator::NextBlock(last);
+			_allocators[i].load(memory_order_relaxed)->DeallocateRemote(batch, last);
+		}
+	}
+}
+
+/// Return the batches parked in the thread caches' depot to the allocators.
+/// Caller must hold the lock.
+static void xalloc_release_depots()
+{
+	XallocThreadCache::ReleaseDepots();
+}
+
+inline void* XallocThreadCache::Allocate(INT index)
+{
+	Magazine& magazine = m_magazines[index];
+	void* block;
+	if (magazine.count > 0)
+	{
+		block = magazine.blocks[--magazine.count];
+		AddCached(index, -1);
+	}
+	else if ((block = Refill(index)) == NULL)
+		return NULL;
+	AddCount(magazine.allocations);
+	return block;
+}
+
+void* XallocThreadCache::Refill(INT index)
+{
+	Magazine& magazine = m_magazines[index];
+
+	// Take a batch another thread flushed, or else the blocks freed to the remote 
+	// free list in one atomic exchange
+	if (magazine.chain == NULL)
+	{
+		void* batch = TakeBatch(index);
+		if (batch)
+		{
+			magazine.chain = batch;
+			AddCached(index, BatchSize(index));
+		}
+		else
+		{
+			void* chain = _allocators[index].load(memory_order_relaxed)->ReclaimRemote();
+			if (chain)
+				Reclaim(index, chain);
+		}
+	}
+
+	if (magazine.chain)
+	{
+		void* block = magazine.chain;
+		magazine.chain = Allocator::NextBlock(block);
+		AddCached(index, -1);
+		return block;
+	}
+
+	// Refill half the magazine from the shared allocator
+	Allocator* allocator = _allocators[index].load(memory_order_relaxed);
+	lock_guard<mutex> lock(get_mutex());
+	while (magazine.count < (_magazineSize[index] + 1) / 2)
+	{
+		void* block = allocator->Allocate(allocator->GetBlockSize());
+		if (block == NULL)
+			break;
+		magazine.blocks[magazine.count++] = block;
+	}
+	if (magazine.count == 0)
+		return NULL;
+	AddCached(index, magazine.count - 1);
+	return magazine.blocks[--magazine.count];
+}
+
+void XallocThreadCache::Reclaim(INT index, void* chain)
+{
+	// Keep at most a magazine of the blocks
+	void* last = chain;
+	INT count = 1;
+	while (count < _magazineSize[index] && Allocator::NextBlock(last))
+	{
+		last = Allocator::NextBlock(last);
+		count++;
+	}
+	void* rest = Allocator::NextBlock(last);
+	Allocator::LinkBlock(last, NULL);
+	m_magazines[index].chain = chain;
+	AddCached(index, count);
+
+	// Share the rest with other threads. Cutting it into batches visits each block 
+	// once, and blocks that do not make a full batch or fit the depot go back to 
+	// the remote free list in one push.
+	void* leftFirst = NULL;
+	void* leftLast = NULL;
+	while (rest)
+	{
+		void* first = rest;
+		void* end = rest;
+		INT batchCount = 1;
+		while (batchCount < BatchSize(index) && Allocator::NextBlock(end))
+		{
+			end = Allocator::NextBlock(end);
+			batchCount++;
+		}
+		rest = Allocator::NextBlock(end);
+		Allocator::LinkBlock(end, NULL);
+
+		if (batchCount < BatchSize(index) || !PutBatch(index, first))
+		{
+			if (leftLast)
+				Allocator::LinkBlock(leftLast, first);
+			else
+				leftFirst = first;
+			leftLast = end;
+		}
+	}
+	if (leftFirst)
+		_allocators[index].load(memory_order_relaxed)->DeallocateRemote(leftFirst, leftLast);
+}
+
+BOOL XallocThreadCache::PutBatch(INT index, void* batch)
+{
+	Depot& depot = m_depots[index];
+	if (depot.count.load(memory_order_relaxed) >= XALLOC_DEPOT_SIZE)
+		return FALSE;
+	for (INT i=0; i<XALLOC_DEPOT_SIZE; i++)
+	{
+		// Release publishes the batch's links to the thread that takes it
+		void* expected = NULL;
+		if (depot.batches[i].load(memory_order_relaxed) == NULL &&
+			depot.batches[i].compare_exchange_strong(expected, batch, memory_order_release, memory_order_relaxed))
+		{
+			depot.count.fetch_add(1, memory_order_relaxed);
+			return TRUE;
+		}
+	}
+	return FALSE;
+}
+
+void* XallocThreadCache::TakeBatch(INT index)
+{
+	Depot& depot = m_depots[index];
+	if (depot.count.load(memory_order_relaxed) <= 0)
+		return NULL;
+	for (INT i=0; i<XALLOC_DEPOT_SIZE; i++)
+	{
+		if (depot.batches[i].load(memory_order_relaxed) != NULL)
+		{
+			void* batch = depot.batches[i].exchange(NULL, memory_order_acquire);
+			if (batch)
+			{
+				depot.count.fetch_sub(1, memory_order_relaxed);
+				return batch;
+			}
+		}
+	}
+	return NULL;
+}
+
+inline void XallocThreadCache::Deallocate(INT index, void* block)
+{
+	Magazine& magazine = m_magazines[index];
+
+	// Cap the blocks this thread hoards
+	if (magazine.count == _magazineSize[index])
+		Flush(index, (_magazineSize[index] + 1) / 2);
+
+	magazine.blocks[magazine.count++] = block;
+	AddCached(index, 1);
+	AddCount(magazine.deallocations);
+}
+
+void XallocThreadCache::Flush(INT index, INT count)
+{
+	Magazine& magazine = m_magazines[index];
+	if (count == 0)
+		return;
+
+	// Link the blocks into a chain and park or push it with one atomic operation
+	for (INT i=0; i<count-1; i++)
+		Allocator::LinkBlock(magazine.blocks[i], magazine.blocks[i+1]);
+	Allocator::LinkBlock(magazine.blocks[count-1], NULL);
+	if (count != BatchSize(index) || !PutBatch(index, magazine.blocks[0]))
+		_allocators[index].load(memory_order_relaxed)->DeallocateRemote(magazine.blocks[0], magazine.blocks[count-1]);
+
+	magazine.count -= count;
+	memmove(&magazine.blocks[0], &magazine.blocks[count], magazine.count * sizeof(void*));
+	AddCached(index, -count);
+}
+#endif	// XALLOC_NO_THREAD_CACHE
+
 /// Allocates a memory block of the requested size. The blocks are created from
 ///	the fixed block allocators.
 ///	@param[in] size - the client requested size of the block.
 /// @return	A pointer to the client's memory block.
 extern "C" void *xmalloc(size_t size)
 {
-	get_mutex().lock();
+	void* blockMemoryPtr;
+	Allocator* allocator;
 
-	// Allocate a raw memory block 
-	Allocator* allocator = xallocator_get_allocator(size);
-	void* blockMemoryPtr = allocator->Allocate(sizeof(Allocator*) + size);
+#ifdef XALLOC_PROFILE
+	// Reserve the profile bucket index at the end of the block
+	size_t requestedSize = size;
+	size += sizeof(UINT32);
+#endif
 
-	get_mutex().unlock();
+#ifndef XALLOC_NO_THREAD_CACHE
+	INT index = xalloc_request_class(size);
+	allocator = (index >= 0) ? _allocators[index].load(memory_order_acquire) : NULL;
+	XallocThreadCache* cache = (allocator != NULL && _magazineSize[index] > 0) ? XallocThreadCache::Get() : NULL;
+	if (cache != NULL)
+	{
+		// Lock-free unless the magazine must be refilled
+		blockMemoryPtr = cache->Allocate(index);
+	}
+	else
+#endif
+	{
+		get_mutex().lock();
+
+		// Allocate a raw memory block 
+		allocator = xallocator_get_allocator(size);
+		blockMemoryPtr = allocator->Allocate(XALLOC_HEADER_SIZE + size);
+#ifndef XALLOC_NO_THREAD_CACHE
+		if (blockMemoryPtr != NULL && index >= 0)
+			_uncachedAllocations[index]++;
+#endif
+
+		get_mutex().unlock();
+	}
+
+	// A static pool is exhausted
+	if (blockMemoryPtr == NULL)
+		return NULL;
+
+#ifdef XALLOC_PROFILE
+	xalloc_profile_allocate(blockMemoryPtr, allocator, requestedSize);
+#endif
 
 	// Set the block Allocator* within the raw memory block region
 	void* clientsMemoryPtr = set_block_allocator(blockMemoryPtr, allocator);
 	return clientsMemoryPtr;
 }
 
+/// Allocates a memory block of the requested size with the client memory aligned 
+/// to the requested alignment.
+///	@param[in] size - the client requested size of the block.
+///	@param[in] alignment - a power of two up to XALLOC_MAX_ALIGNMENT.
+/// @return	A pointer to the client's memory block.
+extern "C" void *xmalloc_aligned(size_t size, size_t alignment)
+{
+	ASSERT_TRUE(alignment != 0 && (alignment & (alignment - 1)) == 0 && alignment <= XALLOC_MAX_ALIGNMENT);
+
+	// Standard blocks are already pointer aligned
+	if (alignment <= sizeof(Allocator*))
+		return xmalloc(size);
+
+	get_mutex().lock();
+	Allocator* allocator = xallocator_get_aligned_allocator(size, alignment);
+	void* blockMemoryPtr = allocator->Allocate(allocator->GetBlockSize());
+	get_mutex().unlock();
+	if (blockMemoryPtr == NULL)
+		return NULL;
+
+#ifdef XALLOC_SLABS
+	// Slab blocks are aligned to the allocator alignment
+	return blockMemoryPtr;
+#else
+	// Client memory follows an alignment sized header ending with the tagged Allocator*
+	CHAR* clientsMemoryPtr = static_cast<CHAR*>(blockMemoryPtr) + alignment;
+	reinterpret_cast<Allocator**>(clientsMemoryPtr)[-1] = (Allocator*)((size_t)allocator | XALLOC_ALIGNED_TAG);
+	return clientsMemoryPtr;
+#endif
+}
+
+/// Reserve pre-faulted free blocks of the size class serving requests of size bytes.
+///	@param[in] size - the client requested block size.
+///	@param[in] blocks - the number of free blocks to have ready.
+///	@param[in] lockPages - if TRUE, lock the blocks' pages in memory.
+/// @return TRUE if successful. 
+extern "C" BOOL xalloc_reserve(size_t size, UINT blocks, BOOL lockPages)
+{
+#ifdef XALLOC_PROFILE
+	// The class xmalloc() uses with the profile bucket index
+	size += sizeof(UINT32);
+#endif
+	lock_guard<mutex> lock(get_mutex());
+	return xallocator_get_allocator(size)->Reserve(blocks, lockPages);
+}
+
 /// Frees a memory block previously allocated with xalloc. The blocks are returned
 ///	to the fixed block allocator that originally created it.
 ///	@param[in] ptr - a pointer to a block created with xalloc.
@@ -310,10 +1143,31 @@ extern "C" void xfree(void* ptr)
 	// Convert the client pointer into the original raw block pointer
 	void* blockPtr = get_block_ptr(ptr);
 
+#ifdef XALLOC_PROFILE
+	// xmalloc_aligned() requests are not profiled
+	if (get_block_class(ptr, allocator) >= 0)
+		xalloc_profile_deallocate(blockPtr, allocator);
+#endif
+
+#ifndef XALLOC_NO_THREAD_CACHE
+	// Aligned classes are not cached
+	INT index = get_block_class(ptr, allocator);
+	XallocThreadCache* cache = (index >= 0 && _magazineSize[index] > 0) ? XallocThreadCache::Get() : NULL;
+	if (cache != NULL)
+	{
+		cache->Deallocate(index, blockPtr);
+		return;
+	}
+#endif
+
 	get_mutex().lock();
 
 	// Deallocate the block 
 	allocator->Deallocate(blockPtr);
+#ifndef XALLOC_NO_THREAD_CACHE
+	if (index >= 0)
+		_uncachedDeallocations[index]++;
+#endif
 
 	get_mutex().unlock();
 }
@@ -339,7 +1193,8 @@ extern "C" void *xrealloc(void *oldMem, size_t size)
 		{
 			// Get the original allocator instance from the old memory block
 			Allocator* oldAllocator = get_block_allocator(oldMem);
-			size_t oldSize = oldAllocator->GetBlockSize() - sizeof(Allocator*);
+			size_t oldSize = oldAllocator->GetBlockSize() - 
+				(static_cast<CHAR*>(oldMem) - static_cast<CHAR*>(get_block_ptr(oldMem)));
 
 			// Copy the bytes from the old memory block into the new (as much as will fit)
 			memcpy(newMem, oldMem, (oldSize < size) ? oldSize : size);
@@ -354,25 +1209,255 @@ extern "C" void *xrealloc(void *oldMem, size_t size)
 	}
 }
 
-/// Output xallocator usage statistics
-extern "C" void xalloc_stats()
+/// Copy the statistics of an allocator. Caller must hold the lock so that the 
+/// counters are consistent. The allocations and deallocations are those of the 
+/// allocator; the caller replaces them with the client calls if thread caches 
+/// sit between the clients and the allocator.
+/// @param[in] cached - the allocator's free blocks held by thread caches.
+static void xalloc_get_allocator_stats(Allocator* allocator, size_t alignment, UINT cached, XallocStats& stats)
 {
-	get_mutex().lock();
+	stats.blockSize = allocator->GetBlockSize();
+	stats.alignment = alignment;
+	stats.blockCount = allocator->GetBlockCount();
+	stats.blocksCached = cached;
+	stats.blocksInUse = allocator->GetBlocksInUse() - cached;
+	stats.highWater = allocator->GetHighWater();
+	stats.allocations = allocator->GetAllocations();
+	stats.deallocations = allocator->GetDeallocations();
+	stats.failedAllocations = allocator->GetFailedAllocations();
+	stats.bytesReserved = allocator->GetBytesReserved();
+	stats.bytesUsed = stats.blocksInUse * stats.blockSize;
+}
+
+/// Get the statistics of every size class allocator.
+///	@param[out] stats - array receiving one entry per size class allocator.
+///	@param[in] maxStats - the number of entries stats can hold.
+/// @return The number of size class allocators.
+extern "C" size_t xalloc_get_stats(XallocStats* stats, size_t maxStats)
+{
+	size_t count = 0;
+	lock_guard<mutex> lock(get_mutex());
 
 	for (INT i=0; i<MAX_ALLOCATORS; i++)
 	{
-		if (_allocators[i] == 0)
-			break;
+		Allocator* allocator = _allocators[i].load();
+		if (allocator == 0)
+			continue;
+		if (count < maxStats)
+		{
+#ifndef XALLOC_NO_THREAD_CACHE
+			UINT cached = XallocThreadCache::GetCachedBlocks(i);
+#else
+			UINT cached = 0;
+#endif
+			xalloc_get_allocator_stats(allocator, 0, cached, stats[count]);
 
-		if (_allocators[i]->GetName() != NULL)
-			cout << _allocators[i]->GetName();
-		cout << " Block Size: " << _allocators[i]->GetBlockSize();
-		cout << " Block Count: " << _allocators[i]->GetBlockCount();
-		cout << " Blocks In Use: " << _allocators[i]->GetBlocksInUse();
+#ifndef XALLOC_NO_THREAD_CACHE
+			// The allocator counts magazine refills and flushes, so count the 
+			// client calls the caches served plus those that bypassed them
+			UINT allocations, deallocations;
+			XallocThreadCache::GetClientCounts(i, allocations, deallocations);
+			stats[count].allocations = allocations + _uncachedAllocations[i];
+			stats[count].deallocations = deallocations + _uncachedDeallocations[i];
+#endif
+		}
+		count++;
+	}
+
+	for (INT set=0; set<XALLOC_ALIGNED_SETS; set++)
+	{
+		for (INT i=0; i<MAX_ALLOCATORS; i++)
+		{
+			Allocator* allocator = _alignedAllocators[set][i].load();
+			if (allocator == 0)
+				continue;
+			if (count < maxStats)
+				xalloc_get_allocator_stats(allocator, allocator->GetAlignment(), 0, stats[count]);
+			count++;
+		}
+	}
+	return count;
+}
+
+/// Output xallocator usage statistics
+extern "C" void xalloc_stats()
+{
+	XallocStats stats[MAX_ALLOCATORS * (XALLOC_ALIGNED_SETS + 1)];
+	size_t count = xalloc_get_stats(stats, sizeof(stats) / sizeof(stats[0]));
+
+	for (size_t i=0; i<count; i++)
+	{
+		if (stats[i].alignment)
+			cout << "xallocator aligned Alignment: " << stats[i].alignment;
+		else
+			cout << "xallocator";
+		cout << " Block Size: " << stats[i].blockSize;
+		cout << " Block Count: " << stats[i].blockCount;
+		cout << " Blocks In Use: " << stats[i].blocksInUse;
+		cout << " Cached: " << stats[i].blocksCached;
+		cout << " High Water: " << stats[i].highWater;
+		cout << " Failed: " << stats[i].failedAllocations;
+		cout << " Bytes Reserved: " << stats[i].bytesReserved;
+		cout << " Bytes Used: " << stats[i].bytesUsed;
 		cout << endl;
 	}
+}
 
-	get_mutex().unlock();
+/// Get the profile of the xmalloc() request sizes.
+///	@param[out] profile - array receiving one entry per requested size bucket.
+///	@param[in] maxEntries - the number of entries profile can hold.
+/// @return The number of requested size buckets. 
+extern "C" size_t xalloc_get_profile(XallocProfileEntry* profile, size_t maxEntries)
+{
+	size_t count = 0;
+#ifdef XALLOC_PROFILE
+	for (INT i=0; i<XALLOC_PROFILE_BUCKETS; i++)
+	{
+		UINT allocations = _profile[i].allocations.load(memory_order_relaxed);
+		if (allocations == 0)
+			continue;
+		if (count < maxEntries)
+		{
+			XallocProfileEntry& entry = profile[count];
+			entry.size = (i < XALLOC_PROFILE_BUCKETS - 1) ? (size_t)i * XALLOC_PROFILE_GRANULARITY : (size_t)-1;
+			entry.allocations = allocations;
+			entry.inUse = _profile[i].inUse.load(memory_order_relaxed);
+			entry.peak = _profile[i].peak.load(memory_order_relaxed);
+		}
+		count++;
+	}
+#else
+	(void)profile;
+	(void)maxEntries;
+#endif
+	return count;
 }
 
+/// Write a STATIC_POOLS configuration header for a profile. Each profiled size needs 
+/// a block of the size plus the Allocator* header, rounded up to a pointer multiple. 
+/// Pools are contiguous runs of those block sizes, sized by the largest, so the 
+/// internal fragmentation of a pool is the bytes its peak blocks waste. A dynamic 
+/// program over the sorted block sizes finds the pools with the least total waste, 
+/// allowing the size class lookup table's one pool between consecutive powers of two 
+/// besides the powers of two themselves. The pools hold the sum of the peaks of their 
+/// sizes, an upper bound on their peak as the sizes may peak at different times, and 
+/// the remaining budget is shared in proportion to the peaks as headroom. 
+///	@param[in] path - the header file to write.
+///	@param[in] profile - the profile entries from xalloc_get_profile().
+///	@param[in] count - the number of profile entries.
+///	@param[in] budget - the memory for all pools in bytes.
+/// @return TRUE if written. FALSE if the profile is empty or includes requests larger 
+///	than XALLOC_PROFILE_MAX_SIZE, the peaks do not fit the budget, or the file cannot 
+/// be written.
+extern "C" BOOL xalloc_write_pool_config(const char* path, const XallocProfileEntry* profile, size_t count, size_t budget)
+{
+	// Peak blocks in use of each block size, in increasing block size order
+	std::map<size_t, uint64_t> peaks;
+	for (size_t i=0; i<count; i++)
+	{
+		if (profile[i].size == (size_t)-1)
+			return FALSE;
+		size_t blockSize = (profile[i].size + sizeof(Allocator*) + sizeof(Allocator*) - 1) & ~(sizeof(Allocator*) - 1);
+		peaks[blockSize] += profile[i].peak;
+	}
+	if (peaks.empty())
+		return FALSE;
+
+	// Block sizes and prefix sums of the peaks and peak bytes, indexed from 1
+	const size_t n = peaks.size();
+	std::vector<size_t> sizes(n + 1, 0);
+	std::vector<uint64_t> blocks(n + 1, 0), bytes(n + 1, 0);
+	size_t index = 1;
+	for (auto& peak : peaks)
+	{
+		sizes[index] = peak.first;
+		blocks[index] = blocks[index - 1] + peak.second;
+		bytes[index] = bytes[index - 1] + peak.second * peak.first;
+		index++;
+	}
+
+	// waste[k][i] is the least waste of pools holding sizes 1 to i, the last of them 
+	// classSize[k][i] bytes, where k is 1 if a pool of the power of two bucket of 
+	// sizes[i] is not a power of two. A pool is as large as its largest size, or that 
+	// size rounded up to the power of two if no larger size would then fit the pool.
+	const uint64_t NONE = (uint64_t)-1;
+	std::vector<uint64_t> waste[2] = { std::vector<uint64_t>(n + 1, NONE), std::vector<uint64_t>(n + 1, NONE) };
+	std::vector<size_t> classSize[2] = { std::vector<size_t>(n + 1, 0), std::vector<size_t>(n + 1, 0) };
+	std::vector<size_t> prev[2] = { std::vector<size_t>(n + 1, 0), std::vector<size_t>(n + 1, 0) };
+	std::vector<INT> prevK[2] = { std::vector<INT>(n + 1, 0), std::vector<INT>(n + 1, 0) };
+	for (size_t i=1; i<=n; i++)
+	{
+		size_t powerOfTwo = (size_t)1 << log2higher(sizes[i]);
+		size_t candidates[2] = { sizes[i], powerOfTwo };
+		INT candidateCount = (powerOfTwo != sizes[i] && (i == n || sizes[i + 1] > powerOfTwo)) ? 2 : 1;
+
+		for (size_t j=0; j<i; j++)
+		{
+			for (INT c=0; c<candidateCount; c++)
+			{
+				// Waste of a pool of candidates[c] bytes holding sizes j+1 to i
+				uint64_t poolWaste = candidates[c] * (blocks[i] - blocks[j]) - (bytes[i] - bytes[j]);
+				for (INT prevPool=0; prevPool<2; prevPool++)
+				{
+					if (j == 0 && prevPool > 0)
+						break;
+					uint64_t total = (j == 0) ? 0 : waste[prevPool][j];
+					if (total == NONE)
+						continue;
+					INT k = (candidates[c] != powerOfTwo) ? 1 : 0;
+					if (j > 0 && log2higher(sizes[j]) == log2higher(sizes[i]))
+					{
+						k += prevPool;
+						if (k > 1)
+							continue;
+					}
+					total += poolWaste;
+					if (total < waste[k][i])
+					{
+						waste[k][i] = total;
+						classSize[k][i] = candidates[c];
+						prev[k][i] = j;
+						prevK[k][i] = prevPool;
+					}
+				}
+			}
+		}
+	}
+
+	// Walk back from the largest size to list the pools
+	std::vector<std::pair<size_t, uint64_t> > pools;
+	INT k = (waste[1][n] < waste[0][n]) ? 1 : 0;
+	for (size_t i=n; i>0; )
+	{
+		size_t j = prev[k][i];
+		pools.insert(pools.begin(), std::make_pair(classSize[k][i], blocks[i] - blocks[j]));
+		k = prevK[k][i];
+		i = j;
+	}
 
+	uint64_t required = 0;
+	for (auto& pool : pools)
+		required += pool.first * pool.second;
+	if (required > budget)
+		return FALSE;
+
+	std::ofstream file(path);
+	if (!file)
+		return FALSE;
+
+	file << "// xallocator static pool configuration written by xalloc_write_pool_config()." << endl;
+	file << "// Build xallocator.cpp with STATIC_POOLS and XALLOC_POOL_CONFIG defined as this file." << endl;
+	file << "// Profiled peak blocks need " << required << " bytes, of which " << 
+		std::min(waste[0][n], waste[1][n]) << " bytes are unused within blocks." << endl;
+	file << "// Memory budget " << budget << " bytes; spare memory is shared as headroom." << endl;
+	file << "#define XALLOC_POOLS(XALLOC_POOL) \\";
+	for (auto& pool : pools)
+	{
+		uint64_t poolBlocks = pool.second * budget / required;
+		file << endl << "\tXALLOC_POOL(" << pool.first << ", " << poolBlocks << ")";
+		if (&pool != &pools.back())
+			file << " \\";
+	}
+	file << endl;
+	return file.good() ? TRUE : FALSE;
+}
@@ -55,21 +55,98 @@ void xalloc_init();
 void xalloc_destroy();
 
 /// Allocate a block of memory
-/// @param[in] size - the size of the block to allocate. 
+/// @param[in] size - the size of the block to allocate. Blocks come from size classes
+/// including a pointer sized header. With STATIC_POOLS the size is limited by the 
+/// largest pool block; otherwise blocks over 1 MB come from uncached classes.
 void *xmalloc(size_t size);
 
+/// Allocate a block of memory aligned for types declared with alignas, e.g. for SIMD 
+/// loads. Blocks come from separate aligned size classes and are not thread cached. 
+/// @param[in] size - the size of the block to allocate. 
+/// @param[in] alignment - a power of two up to 64. Alignments up to the pointer size 
+/// are satisfied by xmalloc().
+void *xmalloc_aligned(size_t size, size_t alignment);
+
+/// Create and pre-fault free blocks of the size class serving requests of size bytes, 
+/// so the first xmalloc() calls after startup neither call the heap nor page fault. 
+/// Call once per size class in use, e.g. for the classes xalloc_get_stats() lists 
+/// after a representative run. With STATIC_POOLS, touches the unused pool blocks.
+/// @param[in] size - a request size of the class.
+/// @param[in] blocks - the number of free blocks to have ready.
+/// @param[in] lockPages - if TRUE, also lock the blocks' pages in memory (mlock).
+/// @return TRUE if successful. FALSE if the pages could not be locked.
+BOOL xalloc_reserve(size_t size, UINT blocks, BOOL lockPages);
+
 /// Frees a previously xalloc allocated block
 /// @param[in] ptr - a pointer to a previously allocated memory using xalloc.
 void xfree(void* ptr);
 
-/// Reallocates an existing xalloc block to a new size
+/// Reallocates an existing xalloc block to a new size. The new block has xmalloc() alignment.
 /// @param[in] ptr - a pointer to a previously allocated memory using xalloc.
 /// @param[in] size - the size of the new block
 void *xrealloc(void *ptr, size_t size);	
 
-/// Output allocator statistics to the standard output
+/// Output allocator statistics to the standard output. Free blocks held in thread
+/// caches are reported separately from the blocks in use.
 void xalloc_stats();
 
+/// Statistics of one xallocator size class. See xalloc_get_stats().
+typedef struct
+{
+	size_t blockSize;			// Fixed block size in bytes, including any header
+	size_t alignment;			// xmalloc_aligned() alignment, or 0 for an xmalloc() class
+	UINT blockCount;			// Heap blocks created; 0 with STATIC_POOLS
+	UINT blocksInUse;			// Blocks allocated to clients, or freed to a remote free list
+								// or the thread caches' depot and not yet reclaimed
+	UINT blocksCached;			// Free blocks held in thread caches
+	UINT highWater;				// Most blocks in use or cached at any one time
+	UINT allocations;			// Total blocks allocated to clients by xmalloc() or
+								// xmalloc_aligned(), including those served by thread caches
+	UINT deallocations;			// Total blocks freed by clients with xfree()
+	UINT failedAllocations;		// Allocations refused because a static pool was exhausted
+	size_t bytesReserved;		// Memory obtained for the class's blocks
+	size_t bytesUsed;			// Memory of the blocks in use (blocksInUse x blockSize)
+} XallocStats;
+
+/// Get a consistent snapshot of the statistics of every size class allocator. Thread
+/// safe, so it may be sampled periodically (e.g. from a Timer) while the application
+/// runs. The highWater of each class is the number of blocks a STATIC_POOLS pool of
+/// that block size must hold for the same workload.
+/// @param[out] stats - array receiving one entry per size class allocator.
+/// @param[in] maxStats - the number of entries stats can hold.
+/// @return The number of size class allocators. Only the first maxStats are written.
+size_t xalloc_get_stats(XallocStats* stats, size_t maxStats);
+
+/// Profile of the xmalloc() requests of one bucket of sizes. See xalloc_get_profile().
+typedef struct
+{
+	size_t size;				// Largest requested size of the bucket, or (size_t)-1 for 
+								// requests larger than XALLOC_PROFILE_MAX_SIZE
+	UINT allocations;			// Total requests
+	UINT inUse;					// Blocks in use
+	UINT peak;					// Most blocks in use at any one time
+} XallocProfileEntry;
+
+/// Get the histogram of the sizes requested from xmalloc() recorded when xallocator.cpp
+/// is built with XALLOC_PROFILE. Thread safe.
+/// @param[out] profile - array receiving one entry per requested size bucket.
+/// @param[in] maxEntries - the number of entries profile can hold.
+/// @return The number of requested size buckets, or 0 if not profiling. Only the first 
+/// maxEntries are written.
+size_t xalloc_get_profile(XallocProfileEntry* profile, size_t maxEntries);
+
+/// Write a STATIC_POOLS configuration header with the pools that waste the least memory 
+/// within blocks for a profile, sized to the profiled peaks plus a share of the spare 
+/// budget. The spare budget must also cover the free blocks each thread's cache may 
+/// hold. Build xallocator.cpp with STATIC_POOLS and XALLOC_POOL_CONFIG defined as the 
+/// header path to use the pools.
+/// @param[in] path - the header file to write.
+/// @param[in] profile - the profile entries from xalloc_get_profile().
+/// @param[in] count - the number of profile entries.
+/// @param[in] budget - the memory for all pools in bytes.
+/// @return TRUE if written. FALSE if the profile cannot be pooled within the budget.
+BOOL xalloc_write_pool_config(const char* path, const XallocProfileEntry* profile, size_t count, size_t budget);
+
 // Macro to overload new/delete with xalloc/xfree  
 #define XALLOCATOR \
     public: \
@@ -79,7 +156,7 @@ void xalloc_stats();
         void operator delete(void* pObject) { \
             xfree(pObject); \
         } \
-        void* operator new(size_t size, void* mem) { \
+        void* operator new(size_t, void* mem) { \
             return mem; \
         } \
         void* operator new[](size_t size) { \
@@ -89,6 +166,25 @@ void xalloc_stats();
             xfree(pData); \
         }
 
+// Macro to overload new/delete with xmalloc_aligned/xfree for over-aligned classes
+#define XALLOCATOR_ALIGNED(alignment) \
+    public: \
+        void* operator new(size_t size) { \
+            return xmalloc_aligned(size, alignment); \
+        } \
+        void operator delete(void* pObject) { \
+            xfree(pObject); \
+        } \
+        void* operator new(size_t, void* mem) { \
+            return mem; \
+        } \
+        void* operator new[](size_t size) { \
+            return xmalloc_aligned(size, alignment); \
+        } \
+        void operator delete[](void* pData) { \
+            xfree(pData); \
+        }
+
 #ifdef __cplusplus 
 }
 #endif
@@ -0,0 +1,197 @@
+#include "DelegateOpt.h"
+#if defined(__linux__)
+
+#include "DelegateRecorder.h"
+#include "DelegateReplayer.h"
+#include "Fault.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+using namespace std;
+
+static inline uint64_t AlignRecord(uint64_t size)
+{
+	return (size + 7) & ~(uint64_t)7;
+}
+
+//----------------------------------------------------------------------------
+// DelegateRecorder
+//----------------------------------------------------------------------------
+DelegateRecorder::DelegateRecorder() :
+	m_segmentSize(0),
+	m_maxSegments(0),
+	m_index(0),
+	m_fd(-1),
+	m_header(NULL),
+	m_data(NULL),
+	m_maxRecordSize(DELEGATE_REMOTE_MAX_FRAME_SIZE),
+	m_records(0),
+	m_dropped(0)
+{
+	static_assert(sizeof(SegmentHeader) % 8 == 0 && sizeof(RecordHeader) == 16,
+		"Log layout must keep records 8 byte aligned");
+}
+
+//----------------------------------------------------------------------------
+// ~DelegateRecorder
+//----------------------------------------------------------------------------
+DelegateRecorder::~DelegateRecorder()
+{
+	Close();
+}
+
+//----------------------------------------------------------------------------
+// GetSegmentName
+//----------------------------------------------------------------------------
+std::string DelegateRecorder::GetSegmentName(const std::string& path, UINT32 index)
+{
+	char suffix[16];
+	snprintf(suffix, sizeof(suffix), ".%06u", index);
+	return path + suffix;
+}
+
+//----------------------------------------------------------------------------
+// Open
+//----------------------------------------------------------------------------
+BOOL DelegateRecorder::Open(const CHAR* path, size_t segmentSize, UINT32 maxSegments)
+{
+	lock_guard<mutex> lock(m_lock);
+	ASSERT_TRUE(m_header == NULL);
+
+	// An empty segment must hold the largest record
+	if (segmentSize < sizeof(SegmentHeader) + AlignRecord(sizeof(RecordHeader) + m_maxRecordSize))
+		return FALSE;
+
+	m_path = path;
+	m_segmentSize = segmentSize;
+	m_maxSegments = maxSegments;
+	m_records = 0;
+	m_dropped = 0;
+
+	// Remove segments left by a previous recording so replay starts at this one
+	UINT32 first, count;
+	if (DelegateReplayer::FindSegments(m_path, first, count))
+	{
+		for (UINT32 index = first; index < first + count; index++)
+			unlink(GetSegmentName(m_path, index).c_str());
+	}
+
+	return OpenSegment(0);
+}
+
+//----------------------------------------------------------------------------
+// Close
+//----------------------------------------------------------------------------
+void DelegateRecorder::Close()
+{
+	lock_guard<mutex> lock(m_lock);
+	CloseSegment();
+}
+
+//----------------------------------------------------------------------------
+// OpenSegment
+//----------------------------------------------------------------------------
+BOOL DelegateRecorder::OpenSegment(UINT32 index)
+{
+	std::string name = GetSegmentName(m_path, index);
+	int fd = open(name.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+	if (fd < 0)
+		return FALSE;
+
+	if (ftruncate(fd, m_segmentSize) != 0)
+	{
+		close(fd);
+		return FALSE;
+	}
+
+	void* mem = mmap(NULL, m_segmentSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if (mem == MAP_FAILED)
+	{
+		close(fd);
+		return FALSE;
+	}
+
+	m_fd = fd;
+	m_index = index;
+	m_header = static_cast<SegmentHeader*>(mem);
+	m_data = static_cast<CHAR*>(mem);
+	m_header->magic = MAGIC;
+	m_header->version = VERSION;
+	m_header->size = m_segmentSize;
+	m_header->used.store(sizeof(SegmentHeader), memory_order_release);
+
+	// Keep only the newest segments
+	if (m_maxSegments > 0 && index >= m_maxSegments)
+		unlink(GetSegmentName(m_path, index - m_maxSegments).c_str());
+	return TRUE;
+}
+
+//----------------------------------------------------------------------------
+// CloseSegment
+//----------------------------------------------------------------------------
+void DelegateRecorder::CloseSegment()
+{
+	if (m_header == NULL)
+		return;
+
+	uint64_t used = m_header->used.load(memory_order_relaxed);
+	munmap(m_header, m_segmentSize);
+	if (ftruncate(m_fd, used) != 0)
+	{
+		// The unused tail remains; readers stop at the used size
+	}
+	close(m_fd);
+	m_fd = -1;
+	m_header = NULL;
+	m_data = NULL;
+}
+
+//----------------------------------------------------------------------------
+// Record
+//----------------------------------------------------------------------------
+void DelegateRecorder::Record(const char* data, size_t size)
+{
+	if (size > m_maxRecordSize)
+	{
+		m_dropped.fetch_add(1, memory_order_relaxed);
+		return;
+	}
+
+	int64_t timestamp = chrono::duration_cast<chrono::nanoseconds>(
+		chrono::steady_clock::now().time_since_epoch()).count();
+	uint64_t need = AlignRecord(sizeof(RecordHeader) + size);
+
+	lock_guard<mutex> lock(m_lock);
+	if (m_header == NULL)
+		return;
+
+	uint64_t used = m_header->used.load(memory_order_relaxed);
+	if (used + need > m_segmentSize)
+	{
+		UINT32 next = m_index + 1;
+		CloseSegment();
+		if (!OpenSegment(next))
+		{
+			m_dropped.fetch_add(1, memory_order_relaxed);
+			return;
+		}
+		used = sizeof(SegmentHeader);
+	}
+
+	RecordHeader header;
+	header.timestamp = timestamp;
+	header.length = (uint32_t)size;
+	header.reserved = 0;
+	memcpy(m_data + used, &header, sizeof(header));
+	memcpy(m_data + used + sizeof(header), data, size);
+
+	// Publish the record
+	m_header->used.store(used + need, memory_order_release);
+	m_records.fetch_add(1, memory_order_relaxed);
+}
+
+#endif
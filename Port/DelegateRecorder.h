@@ -0,0 +1,118 @@
+#ifndef _DELEGATE_RECORDER_H
+#define _DELEGATE_RECORDER_H
+
+// DelegateRecorder.h
+// @see https://github.com/endurodave/AsyncMulticastDelegateCpp11
+
+#include "DelegateOpt.h"
+#if defined(__linux__)
+
+#include "DelegateTransport.h"
+#include "DataTypes.h"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+/// @brief Records serialized remote delegate invocations to a log for later replay
+/// with DelegateReplayer. Use the recorder as the transport of a DelegateRemoteSend
+/// to capture outgoing calls, e.g. a DelegateRemoteSend registered on a
+/// MulticastDelegateSafe event, or pass received bytes to Record() to capture
+/// incoming traffic.
+///
+/// The log is a series of fixed size segment files "<path>.000000", "<path>.000001",
+/// ... each memory mapped while written. A record is a steady clock timestamp, the
+/// length and the message bytes (the delegate id followed by the arguments), and is
+/// appended with a memcpy. When a segment is full the recorder trims it to its used
+/// size and rotates to the next one. A message longer than the maximum record size
+/// is dropped and counted rather than recorded.
+class DelegateRecorder : public DelegateLib::IDelegateBufferTransport
+{
+public:
+	/// On disk segment header. The used size is updated after each record, so a
+	/// segment is readable up to the last complete record if the process dies.
+	struct SegmentHeader
+	{
+		uint32_t magic;
+		uint32_t version;
+		uint64_t size;
+		std::atomic<uint64_t> used;
+	};
+
+	/// On disk record header, followed by length bytes and padding to 8 bytes.
+	struct RecordHeader
+	{
+		int64_t timestamp;		// steady_clock nanoseconds
+		uint32_t length;
+		uint32_t reserved;
+	};
+
+	static const uint32_t MAGIC = 0x444C4F47;	// "DLOG"
+	static const uint32_t VERSION = 1;
+
+	/// Constructor
+	DelegateRecorder();
+
+	/// Destructor
+	~DelegateRecorder();
+
+	/// Start a new log. Existing segments with the same path are overwritten.
+	/// @param[in] path - the segment file path prefix.
+	/// @param[in] segmentSize - the size of each segment file in bytes. Must hold a
+	///		record of the maximum record size.
+	/// @param[in] maxSegments - the number of newest segments kept on disk. 0 keeps all.
+	/// @return TRUE if the first segment was created. FALSE if segmentSize is too
+	///		small or the segment could not be created.
+	BOOL Open(const CHAR* path, size_t segmentSize, UINT32 maxSegments = 0);
+
+	/// Finish the current segment and close the log.
+	void Close();
+
+	/// Set the largest message recorded. A longer message is dropped and counted
+	/// by GetDroppedCount(). Defaults to DELEGATE_REMOTE_MAX_FRAME_SIZE. Call before Open().
+	void SetMaxRecordSize(size_t size) { m_maxRecordSize = size; }
+
+	/// Append one serialized remote delegate message to the log. Thread safe.
+	/// @param[in] data - the message bytes starting with the delegate id.
+	/// @param[in] size - the number of bytes.
+	void Record(const char* data, size_t size);
+
+	/// Record a message sent by a DelegateRemoteSend using this transport.
+	virtual void DispatchDelegate(const char* data, size_t size) override { Record(data, size); }
+
+	/// Get the number of records written since Open().
+	uint64_t GetRecordCount() const { return m_records.load(std::memory_order_relaxed); }
+
+	/// Get the number of messages dropped since Open() because they were longer
+	/// than the maximum record size or the next segment could not be created.
+	uint64_t GetDroppedCount() const { return m_dropped.load(std::memory_order_relaxed); }
+
+	/// Get a segment file name.
+	static std::string GetSegmentName(const std::string& path, UINT32 index);
+
+private:
+	DelegateRecorder(const DelegateRecorder&) = delete;
+	DelegateRecorder& operator=(const DelegateRecorder&) = delete;
+
+	/// Create and map a segment file. Caller must hold m_lock.
+	BOOL OpenSegment(UINT32 index);
+
+	/// Unmap the current segment and trim the file to its used size. Caller must hold m_lock.
+	void CloseSegment();
+
+	std::string m_path;
+	size_t m_segmentSize;
+	UINT32 m_maxSegments;
+	UINT32 m_index;
+	int m_fd;
+	SegmentHeader* m_header;
+	CHAR* m_data;
+	size_t m_maxRecordSize;
+	std::atomic<uint64_t> m_records;
+	std::atomic<uint64_t> m_dropped;
+	std::mutex m_lock;
+};
+
+#endif
+
+#endif
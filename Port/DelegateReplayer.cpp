@@ -0,0 +1,155 @@
+#include "DelegateOpt.h"
+#if defined(__linux__)
+
+#include "DelegateReplayer.h"
+#include "DelegateRecorder.h"
+#include "DelegateRemoteInvoker.h"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+using namespace std;
+using namespace DelegateLib;
+
+//----------------------------------------------------------------------------
+// DelegateReplayer
+//----------------------------------------------------------------------------
+DelegateReplayer::DelegateReplayer() :
+	m_first(0),
+	m_count(0)
+{
+}
+
+//----------------------------------------------------------------------------
+// FindSegments
+//----------------------------------------------------------------------------
+BOOL DelegateReplayer::FindSegments(const std::string& path, UINT32& first, UINT32& count)
+{
+	size_t slash = path.rfind('/');
+	std::string dir = (slash == std::string::npos) ? "." : path.substr(0, slash + 1);
+	std::string prefix = (slash == std::string::npos) ? path : path.substr(slash + 1);
+	prefix += ".";
+
+	// Find the oldest segment. Older ones may have been removed by rotation.
+	DIR* d = opendir(dir.c_str());
+	if (d == NULL)
+		return FALSE;
+
+	BOOL found = FALSE;
+	first = 0;
+	while (dirent* entry = readdir(d))
+	{
+		const char* name = entry->d_name;
+		if (strncmp(name, prefix.c_str(), prefix.size()) != 0)
+			continue;
+
+		char* end = NULL;
+		unsigned long index = strtoul(name + prefix.size(), &end, 10);
+		if (end == name + prefix.size() || *end != '\0')
+			continue;
+		if (!found || index < first)
+			first = (UINT32)index;
+		found = TRUE;
+	}
+	closedir(d);
+
+	count = 0;
+	if (!found)
+		return FALSE;
+
+	struct stat st;
+	while (stat(DelegateRecorder::GetSegmentName(path, first + count).c_str(), &st) == 0)
+		count++;
+	return TRUE;
+}
+
+//----------------------------------------------------------------------------
+// Open
+//----------------------------------------------------------------------------
+BOOL DelegateReplayer::Open(const CHAR* path)
+{
+	m_path = path;
+	return FindSegments(m_path, m_first, m_count);
+}
+
+//----------------------------------------------------------------------------
+// Replay
+//----------------------------------------------------------------------------
+uint64_t DelegateReplayer::Replay(Timing timing, IDelegateBufferTransport* target)
+{
+	typedef DelegateRecorder::SegmentHeader SegmentHeader;
+	typedef DelegateRecorder::RecordHeader RecordHeader;
+
+	uint64_t replayed = 0;
+	BOOL started = FALSE;
+	int64_t firstTimestamp = 0;
+	chrono::steady_clock::time_point start;
+
+	for (UINT32 index = m_first; index < m_first + m_count; index++)
+	{
+		int fd = open(DelegateRecorder::GetSegmentName(m_path, index).c_str(), O_RDONLY | O_CLOEXEC);
+		if (fd < 0)
+			break;
+
+		struct stat st;
+		if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(SegmentHeader))
+		{
+			close(fd);
+			break;
+		}
+
+		void* mem = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		close(fd);
+		if (mem == MAP_FAILED)
+			break;
+
+		const CHAR* data = static_cast<const CHAR*>(mem);
+		const SegmentHeader* header = static_cast<const SegmentHeader*>(mem);
+		uint64_t used = header->used.load(memory_order_acquire);
+		if (header->magic != DelegateRecorder::MAGIC || header->version != DelegateRecorder::VERSION ||
+			used > (uint64_t)st.st_size)
+		{
+			munmap(mem, st.st_size);
+			break;
+		}
+
+		uint64_t offset = sizeof(SegmentHeader);
+		while (offset + sizeof(RecordHeader) <= used)
+		{
+			RecordHeader record;
+			memcpy(&record, data + offset, sizeof(record));
+			if (offset + sizeof(RecordHeader) + record.length > used)
+				break;
+
+			if (!started)
+			{
+				started = TRUE;
+				firstTimestamp = record.timestamp;
+				start = chrono::steady_clock::now();
+			}
+			else if (timing == ORIGINAL)
+			{
+				this_thread::sleep_until(start + chrono::nanoseconds(record.timestamp - firstTimestamp));
+			}
+
+			const CHAR* message = data + offset + sizeof(RecordHeader);
+			if (target)
+				target->DispatchDelegate(message, record.length);
+			else
+				DelegateRemoteInvoker::Invoke(message, record.length);
+			replayed++;
+
+			offset += (sizeof(RecordHeader) + record.length + 7) & ~(uint64_t)7;
+		}
+		munmap(mem, st.st_size);
+	}
+	return replayed;
+}
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef _DELEGATE_REPLAYER_H
+#define _DELEGATE_REPLAYER_H
+
+// DelegateReplayer.h
+// @see https://github.com/endurodave/AsyncMulticastDelegateCpp11
+
+#include "DelegateOpt.h"
+#if defined(__linux__)
+
+#include "DelegateTransport.h"
+#include "DataTypes.h"
+#include <cstdint>
+#include <string>
+
+/// @brief Replays a log written by DelegateRecorder. Each recorded message is
+/// invoked on the registered remote delegate receivers with
+/// DelegateRemoteInvoker::Invoke(), or sent to a transport, either with the
+/// original spacing between records or as fast as possible. Segments are memory
+/// mapped and messages are invoked in place without copying.
+class DelegateReplayer
+{
+public:
+	enum Timing
+	{
+		ORIGINAL,		// Reproduce the recorded intervals between messages
+		FAST			// Replay back to back
+	};
+
+	/// Constructor
+	DelegateReplayer();
+
+	/// Locate the segments of a log.
+	/// @param[in] path - the segment file path prefix given to DelegateRecorder::Open().
+	/// @return TRUE if at least one segment exists.
+	BOOL Open(const CHAR* path);
+
+	/// Replay every record in the log, oldest first.
+	/// @param[in] timing - ORIGINAL or FAST.
+	/// @param[in] target - if not NULL, messages are sent to this transport instead
+	///		of invoked locally.
+	/// @return The number of messages replayed.
+	uint64_t Replay(Timing timing, DelegateLib::IDelegateBufferTransport* target = NULL);
+
+	/// Get the number of segments found by Open().
+	UINT32 GetSegmentCount() const { return m_count; }
+
+	/// Find the range of consecutive segment indexes on disk for a path.
+	/// @param[out] first - the oldest segment index.
+	/// @param[out] count - the number of segments.
+	/// @return TRUE if at least one segment exists.
+	static BOOL FindSegments(const std::string& path, UINT32& first, UINT32& count);
+
+private:
+	std::string m_path;
+	UINT32 m_first;
+	UINT32 m_count;
+};
+
+#endif
+
+#endif
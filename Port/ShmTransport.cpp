@@ -0,0 +1,315 @@
+#include "DelegateOpt.h"
+#if defined(__linux__)
+
+#include "ShmTransport.h"
+#include "DelegateRemoteInvoker.h"
+#include "Fault.h"
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include <time.h>
+
+using namespace std;
+using namespace DelegateLib;
+
+// Ring record length marking unused space at the end of the ring. The next
+// record starts at ring offset 0.
+static const uint32_t WRAP_MARKER = 0xFFFFFFFF;
+
+static inline uint64_t AlignRecord(uint64_t size)
+{
+	return (size + 7) & ~(uint64_t)7;
+}
+
+static void FutexWait(std::atomic<uint32_t>* addr, uint32_t value, int timeout)
+{
+	struct timespec ts;
+	struct timespec* pts = NULL;
+	if (timeout >= 0)
+	{
+		ts.tv_sec = timeout / 1000;
+		ts.tv_nsec = (timeout % 1000) * 1000000L;
+		pts = &ts;
+	}
+
+	// Not FUTEX_PRIVATE_FLAG; the futex word is shared between processes
+	syscall(SYS_futex, reinterpret_cast<uint32_t*>(addr), FUTEX_WAIT, value, pts, NULL, 0);
+}
+
+static void FutexWake(std::atomic<uint32_t>* addr)
+{
+	syscall(SYS_futex, reinterpret_cast<uint32_t*>(addr), FUTEX_WAKE, 1, NULL, NULL, 0);
+}
+
+/// Yield while waiting on the peer process.
+/// @param[in] start - the time the wait started.
+/// @param[in] timeout - maximum wait in milliseconds, or less than 0 for infinite.
+/// @return FALSE once the timeout has expired.
+static BOOL WaitPeer(const chrono::steady_clock::time_point& start, int timeout)
+{
+	this_thread::yield();
+	return (timeout < 0 || chrono::steady_clock::now() - start < chrono::milliseconds(timeout)) ? TRUE : FALSE;
+}
+
+//----------------------------------------------------------------------------
+// ShmTransport
+//----------------------------------------------------------------------------
+ShmTransport::ShmTransport() :
+	m_header(NULL),
+	m_ring(NULL),
+	m_mapSize(0),
+	m_mode(SEND),
+	m_sendTimeout(1000),
+	m_dropped(0)
+{
+	static_assert(ATOMIC_LLONG_LOCK_FREE == 2 && ATOMIC_INT_LOCK_FREE == 2,
+		"Shared memory ring requires address-free lock-free atomics");
+}
+
+//----------------------------------------------------------------------------
+// ~ShmTransport
+//----------------------------------------------------------------------------
+ShmTransport::~ShmTransport()
+{
+	Close();
+}
+
+//----------------------------------------------------------------------------
+// Open
+//----------------------------------------------------------------------------
+BOOL ShmTransport::Open(const CHAR* name, size_t size, Mode mode, int timeout)
+{
+	ASSERT_TRUE(m_header == NULL);
+	ASSERT_TRUE(size >= 64 && (size & (size - 1)) == 0);
+
+	m_mode = mode;
+	m_name = name;
+	m_mapSize = sizeof(Header) + size;
+
+	// The first process to open creates and sizes the shared memory object
+	auto start = chrono::steady_clock::now();
+	BOOL creator = TRUE;
+	int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+	if (fd < 0 && errno == EEXIST)
+	{
+		creator = FALSE;
+		fd = shm_open(name, O_RDWR, 0600);
+	}
+	if (fd < 0)
+		return FALSE;
+
+	if (creator)
+	{
+		if (ftruncate(fd, m_mapSize) != 0)
+		{
+			close(fd);
+			shm_unlink(name);
+			return FALSE;
+		}
+	}
+	else
+	{
+		// Wait for the creator to size the object
+		struct stat st;
+		while (fstat(fd, &st) == 0 && (size_t)st.st_size < m_mapSize)
+		{
+			if (!WaitPeer(start, timeout))
+			{
+				close(fd);
+				return FALSE;
+			}
+		}
+	}
+
+	void* mem = mmap(NULL, m_mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if (mem == MAP_FAILED)
+		return FALSE;
+
+	m_header = static_cast<Header*>(mem);
+	m_ring = static_cast<CHAR*>(mem) + sizeof(Header);
+
+	if (creator)
+	{
+		// New shared memory is zero filled; only the size needs initializing
+		m_header->size = (uint32_t)size;
+		m_header->ready.store(1, memory_order_release);
+	}
+	else
+	{
+		while (m_header->ready.load(memory_order_acquire) == 0)
+		{
+			if (!WaitPeer(start, timeout))
+			{
+				Close();
+				return FALSE;
+			}
+		}
+		if (m_header->size != size)
+		{
+			Close();
+			return FALSE;
+		}
+	}
+	return TRUE;
+}
+
+//----------------------------------------------------------------------------
+// Close
+//----------------------------------------------------------------------------
+void ShmTransport::Close()
+{
+	if (m_header == NULL)
+		return;
+
+	munmap(m_header, m_mapSize);
+	m_header = NULL;
+	m_ring = NULL;
+
+	if (m_mode == RECEIVE)
+		shm_unlink(m_name.c_str());
+}
+
+//----------------------------------------------------------------------------
+// Unlink
+//----------------------------------------------------------------------------
+void ShmTransport::Unlink(const CHAR* name)
+{
+	shm_unlink(name);
+}
+
+//----------------------------------------------------------------------------
+// DispatchDelegate
+//----------------------------------------------------------------------------
+void ShmTransport::DispatchDelegate(const char* data, size_t size)
+{
+	if (!Send(data, size))
+		m_dropped++;
+}
+
+//----------------------------------------------------------------------------
+// Send
+//----------------------------------------------------------------------------
+BOOL ShmTransport::Send(const char* data, size_t size)
+{
+	ASSERT_TRUE(m_header != NULL && m_mode == SEND);
+
+	const uint64_t ringSize = m_header->size;
+	const uint64_t need = AlignRecord(sizeof(uint32_t) + size);
+
+	// A message must fit in the ring along with a wrap marker
+	if (need > ringSize / 2)
+		return FALSE;
+
+	uint64_t head = m_header->head.load(memory_order_relaxed);
+	uint64_t offset = head & (ringSize - 1);
+	uint64_t contiguous = ringSize - offset;
+	uint64_t total = (need > contiguous) ? contiguous + need : need;
+
+	// Wait for the consumer to free enough space. Only read the clock once the
+	// ring is found full.
+	if (head + total - m_header->tail.load(memory_order_acquire) > ringSize)
+	{
+		auto start = chrono::steady_clock::now();
+		while (head + total - m_header->tail.load(memory_order_acquire) > ringSize)
+		{
+			if (!WaitPeer(start, m_sendTimeout))
+				return FALSE;
+		}
+	}
+
+	// Skip the unusable space at the end of the ring
+	if (need > contiguous)
+	{
+		memcpy(m_ring + offset, &WRAP_MARKER, sizeof(WRAP_MARKER));
+		head += contiguous;
+		offset = 0;
+	}
+
+	uint32_t length = (uint32_t)size;
+	memcpy(m_ring + offset, &length, sizeof(length));
+	memcpy(m_ring + offset + sizeof(length), data, size);
+
+	// Publish the record then ring the doorbell if the consumer sleeps
+	m_header->head.store(head + need);
+	m_header->doorbell.fetch_add(1);
+	if (m_header->sleeping.load())
+		FutexWake(&m_header->doorbell);
+	return TRUE;
+}
+
+//----------------------------------------------------------------------------
+// Receive
+//----------------------------------------------------------------------------
+int ShmTransport::Receive(int timeout)
+{
+	ASSERT_TRUE(m_header != NULL && m_mode == RECEIVE);
+
+	// Use the size this process mapped, not the size stored in shared memory
+	const uint64_t ringSize = m_mapSize - sizeof(Header);
+	int count = 0;
+
+	for (int pass = 0; pass < 2; pass++)
+	{
+		uint64_t tail = m_header->tail.load(memory_order_relaxed);
+		uint64_t head = m_header->head.load(memory_order_acquire);
+
+		// The peer may be faulty or hostile. Bound every record by the ring and 
+		// by head before reading it; a corrupt ring is discarded up to head.
+		if (head - tail > ringSize)
+		{
+			tail = head;
+			m_header->tail.store(tail, memory_order_release);
+		}
+
+		while (tail != head)
+		{
+			uint64_t offset = tail & (ringSize - 1);
+			uint32_t length = WRAP_MARKER;
+			if (offset + sizeof(length) <= ringSize)
+				memcpy(&length, m_ring + offset, sizeof(length));
+
+			if (length == WRAP_MARKER)
+			{
+				tail += ringSize - offset;
+			}
+			else if (sizeof(length) + (uint64_t)length <= ringSize - offset &&
+				tail + AlignRecord(sizeof(length) + length) <= head)
+			{
+				// Invoke directly from shared memory; no copy
+				DelegateRemoteInvoker::Invoke(m_ring + offset + sizeof(length), length);
+				tail += AlignRecord(sizeof(length) + length);
+				count++;
+			}
+			else
+			{
+				tail = head;
+			}
+			if (tail > head)
+				tail = head;
+
+			// Release the space to the producer
+			m_header->tail.store(tail, memory_order_release);
+		}
+
+		if (count > 0 || timeout == 0 || pass > 0)
+			break;
+
+		// Ring empty. Sleep on the doorbell unless a send raced with the check.
+		uint32_t seq = m_header->doorbell.load();
+		m_header->sleeping.store(1);
+		if (m_header->head.load() == tail)
+			FutexWait(&m_header->doorbell, seq, timeout);
+		m_header->sleeping.store(0);
+	}
+	return count;
+}
+
+#endif
@@ -0,0 +1,109 @@
+#ifndef _SHM_TRANSPORT_H
+#define _SHM_TRANSPORT_H
+
+// ShmTransport.h
+// @see https://github.com/endurodave/AsyncMulticastDelegateCpp11
+
+#include "DelegateOpt.h"
+#if defined(__linux__)
+
+#include "DelegateTransport.h"
+#include "DataTypes.h"
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+/// @brief A remote delegate transport between two processes on the same host.
+/// The processes share a POSIX shared memory single-producer/single-consumer byte
+/// ring. The sending process calls Open(SEND) and uses the transport with
+/// DelegateRemoteSend; the receiving process calls Open(RECEIVE) and calls Receive()
+/// from its receive thread, which invokes DelegateRemoteInvoker::Invoke() directly
+/// on the bytes in shared memory. A futex in the ring header wakes a sleeping
+/// receiver, so an idle receiver costs nothing and a busy one makes no syscalls.
+class ShmTransport : public DelegateLib::IDelegateBufferTransport
+{
+public:
+	enum Mode { SEND, RECEIVE };
+
+	/// Constructor
+	ShmTransport();
+
+	/// Destructor
+	~ShmTransport();
+
+	/// Create or attach to a named ring. The first process to call Open() creates
+	/// and initializes the ring; the other attaches to it.
+	/// @param[in] name - the POSIX shared memory object name, e.g. "/DelegateRing".
+	/// @param[in] size - the ring capacity in bytes. Must be a power of two.
+	/// @param[in] mode - SEND for the producer process, RECEIVE for the consumer.
+	/// @param[in] timeout - maximum wait in milliseconds for the creating process to
+	///		initialize the ring when attaching. If less than 0, wait time is infinite.
+	/// @return TRUE if the ring is ready. FALSE otherwise, including if the creating
+	///		process did not initialize the ring in time.
+	BOOL Open(const CHAR* name, size_t size, Mode mode, int timeout = 5000);
+
+	/// Detach from the ring. The receiver also removes the shared memory name.
+	void Close();
+
+	/// Copy one serialized remote delegate message into the ring. Blocks while
+	/// the ring is full, up to the send timeout. Only call from the SEND side, from
+	/// one thread at a time.
+	/// @param[in] data - the serialized message.
+	/// @param[in] size - the number of bytes.
+	/// @return TRUE if the message was sent. FALSE if the message needs more than
+	///		half the ring, or if the ring stayed full for the send timeout, e.g.
+	///		because the receiving process died or never started.
+	BOOL Send(const char* data, size_t size);
+
+	/// Send a message with Send(). A message that is too large or times out is
+	/// dropped and counted by GetDroppedCount().
+	virtual void DispatchDelegate(const char* data, size_t size) override;
+
+	/// Set how long Send() waits for space in a full ring.
+	/// @param[in] timeout - maximum wait in milliseconds. If less than 0, wait time
+	///		is infinite. Defaults to 1000.
+	void SetSendTimeout(int timeout) { m_sendTimeout = timeout; }
+
+	/// Gets the number of messages DispatchDelegate() dropped as too large or on a
+	/// full ring.
+	uint64_t GetDroppedCount() const { return m_dropped; }
+
+	/// Invoke every message in the ring, waiting for messages if none are present.
+	/// Only call from the RECEIVE side, from one thread at a time.
+	/// @param[in] timeout - maximum wait in milliseconds if the ring is empty. If
+	///		less than 0, wait time is infinite.
+	/// @return The number of messages processed.
+	int Receive(int timeout);
+
+	/// Remove a ring name left behind by a process that did not Close().
+	static void Unlink(const CHAR* name);
+
+private:
+	ShmTransport(const ShmTransport&) = delete;
+	ShmTransport& operator=(const ShmTransport&) = delete;
+
+	/// Shared memory header followed by the ring data. Producer and consumer
+	/// indices sit on separate cache lines. Indices increase without wrapping;
+	/// the ring offset is index & (size - 1).
+	struct Header
+	{
+		std::atomic<uint32_t> ready;
+		uint32_t size;
+		alignas(64) std::atomic<uint64_t> head;			// Written by producer
+		alignas(64) std::atomic<uint64_t> tail;			// Written by consumer
+		alignas(64) std::atomic<uint32_t> doorbell;		// Futex word bumped on each send
+		std::atomic<uint32_t> sleeping;					// Consumer is waiting on doorbell
+	};
+
+	Header* m_header;
+	CHAR* m_ring;
+	size_t m_mapSize;
+	Mode m_mode;
+	std::string m_name;
+	int m_sendTimeout;
+	uint64_t m_dropped;
+};
+
+#endif
+
+#endif
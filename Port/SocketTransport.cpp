@@ -0,0 +1,566 @@
+#include "DelegateOpt.h"
+#if defined(__linux__)
+
+#include "SocketTransport.h"
+#include "DelegateRemoteInvoker.h"
+#include "Fault.h"
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+
+using namespace std;
+using namespace DelegateLib;
+
+// Minimum free space requested from each read() call
+static const size_t RECV_CHUNK = 64 * 1024;
+
+static BOOL SetNonBlocking(int fd)
+{
+	int flags = fcntl(fd, F_GETFL, 0);
+	return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+static BOOL MakeUnixAddress(const CHAR* path, sockaddr_un& addr)
+{
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	if (strlen(path) >= sizeof(addr.sun_path))
+		return FALSE;
+	strcpy(addr.sun_path, path);
+	return TRUE;
+}
+
+static void MakeLoopbackAddress(UINT16 port, sockaddr_in& addr)
+{
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_port = htons(port);
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+}
+
+//----------------------------------------------------------------------------
+// SocketTransport
+//----------------------------------------------------------------------------
+SocketTransport::SocketTransport() :
+	m_listenFd(-1),
+	m_connFd(-1),
+	m_epollFd(-1),
+	m_wakeFd(-1),
+	m_exit(false),
+	m_invokeThread(NULL),
+	m_recvSize(0),
+	m_maxFrameSize(DELEGATE_REMOTE_MAX_FRAME_SIZE),
+	m_sendOffset(0),
+	m_maxSendQueueSize(DELEGATE_REMOTE_MAX_SEND_QUEUE_SIZE),
+	m_dropped(0),
+	m_broken(FALSE)
+{
+	m_epollFd = epoll_create1(EPOLL_CLOEXEC);
+	m_wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	ASSERT_TRUE(m_epollFd >= 0 && m_wakeFd >= 0);
+
+	epoll_event ev;
+	ev.events = EPOLLIN;
+	ev.data.fd = m_wakeFd;
+	epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_wakeFd, &ev);
+}
+
+//----------------------------------------------------------------------------
+// ~SocketTransport
+//----------------------------------------------------------------------------
+SocketTransport::~SocketTransport()
+{
+	Close();
+	close(m_wakeFd);
+	close(m_epollFd);
+}
+
+//----------------------------------------------------------------------------
+// ListenUnix
+//----------------------------------------------------------------------------
+BOOL SocketTransport::ListenUnix(const CHAR* path)
+{
+	sockaddr_un addr;
+	if (m_listenFd >= 0 || !MakeUnixAddress(path, addr))
+		return FALSE;
+
+	int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	if (fd < 0)
+		return FALSE;
+
+	unlink(path);
+	if (bind(fd, (sockaddr*)&addr, sizeof(addr)) != 0 || listen(fd, 1) != 0)
+	{
+		close(fd);
+		return FALSE;
+	}
+
+	m_unixPath = path;
+	m_listenFd = fd;
+
+	epoll_event ev;
+	ev.events = EPOLLIN;
+	ev.data.fd = m_listenFd;
+	epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_listenFd, &ev);
+	return TRUE;
+}
+
+//----------------------------------------------------------------------------
+// ListenTcp
+//----------------------------------------------------------------------------
+BOOL SocketTransport::ListenTcp(UINT16 port)
+{
+	if (m_listenFd >= 0)
+		return FALSE;
+
+	int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	if (fd < 0)
+		return FALSE;
+
+	int on = 1;
+	setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+
+	sockaddr_in addr;
+	MakeLoopbackAddress(port, addr);
+	if (bind(fd, (sockaddr*)&addr, sizeof(addr)) != 0 || listen(fd, 1) != 0)
+	{
+		close(fd);
+		return FALSE;
+	}
+
+	m_listenFd = fd;
+
+	epoll_event ev;
+	ev.events = EPOLLIN;
+	ev.data.fd = m_listenFd;
+	epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_listenFd, &ev);
+	return TRUE;
+}
+
+//----------------------------------------------------------------------------
+// ConnectUnix
+//----------------------------------------------------------------------------
+BOOL SocketTransport::ConnectUnix(const CHAR* path)
+{
+	sockaddr_un addr;
+	if (!MakeUnixAddress(path, addr))
+		return FALSE;
+
+	int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	if (fd < 0)
+		return FALSE;
+	if (connect(fd, (sockaddr*)&addr, sizeof(addr)) != 0)
+	{
+		close(fd);
+		return FALSE;
+	}
+
+	SetConnection(fd);
+	return TRUE;
+}
+
+//----------------------------------------------------------------------------
+// ConnectTcp
+//----------------------------------------------------------------------------
+BOOL SocketTransport::ConnectTcp(UINT16 port)
+{
+	int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	if (fd < 0)
+		return FALSE;
+
+	sockaddr_in addr;
+	MakeLoopbackAddress(port, addr);
+	if (connect(fd, (sockaddr*)&addr, sizeof(addr)) != 0)
+	{
+		close(fd);
+		return FALSE;
+	}
+
+	SetConnection(fd);
+	return TRUE;
+}
+
+//----------------------------------------------------------------------------
+// Start
+//----------------------------------------------------------------------------
+BOOL SocketTransport::Start(DelegateThread* thread)
+{
+	if (m_thread)
+		return FALSE;
+
+	m_invokeThread = thread;
+	m_exit = false;
+	m_thread = std::unique_ptr<std::thread>(new std::thread(&SocketTransport::Process, this));
+	return TRUE;
+}
+
+//----------------------------------------------------------------------------
+// Close
+//----------------------------------------------------------------------------
+void SocketTransport::Close()
+{
+	if (m_thread)
+	{
+		// Wake the receive loop and wait for it to exit
+		m_exit = true;
+		Wake();
+		m_thread->join();
+		m_thread = nullptr;
+	}
+
+	{
+		lock_guard<mutex> lock(m_sendLock);
+		CloseConnection();
+	}
+
+	if (m_listenFd >= 0)
+	{
+		epoll_ctl(m_epollFd, EPOLL_CTL_DEL, m_listenFd, NULL);
+		close(m_listenFd);
+		m_listenFd = -1;
+		if (!m_unixPath.empty())
+			unlink(m_unixPath.c_str());
+		m_unixPath.clear();
+	}
+}
+
+//----------------------------------------------------------------------------
+// IsConnected
+//----------------------------------------------------------------------------
+BOOL SocketTransport::IsConnected()
+{
+	lock_guard<mutex> lock(m_sendLock);
+	return m_connFd >= 0 && !m_broken;
+}
+
+//----------------------------------------------------------------------------
+// DispatchDelegate
+//----------------------------------------------------------------------------
+void SocketTransport::DispatchDelegate(const char* data, size_t size)
+{
+	lock_guard<mutex> lock(m_sendLock);
+
+	// Not connected; the message is dropped
+	if (m_connFd < 0 || m_broken)
+		return;
+
+	uint32_t length = (uint32_t)size;
+	size_t total = sizeof(length) + size;
+	size_t written = 0;
+
+	// A peer that stopped reading; drop the message rather than grow the queue.
+	// Nothing of it is written, so the stream stays framed.
+	size_t queued = m_sendBuf.size() - m_sendOffset;
+	if (queued > 0 && queued + total > m_maxSendQueueSize)
+	{
+		m_dropped++;
+		return;
+	}
+
+	if (m_sendOffset == m_sendBuf.size())
+	{
+		// Nothing queued. Write header and message with one syscall, no copy.
+		iovec iov[2];
+		iov[0].iov_base = &length;
+		iov[0].iov_len = sizeof(length);
+		iov[1].iov_base = const_cast<char*>(data);
+		iov[1].iov_len = size;
+
+		ssize_t n;
+		do {
+			n = writev(m_connFd, iov, 2);
+		} while (n < 0 && errno == EINTR);
+
+		if (n < 0)
+		{
+			if (errno != EAGAIN && errno != EWOULDBLOCK)
+			{
+				FailConnection();
+				return;
+			}
+			n = 0;
+		}
+		written = (size_t)n;
+		if (written == total)
+			return;
+
+		m_sendBuf.clear();
+		m_sendOffset = 0;
+	}
+
+	// Queue the unwritten remainder behind anything already queued
+	const char* header = reinterpret_cast<const char*>(&length);
+	if (written < sizeof(length))
+	{
+		m_sendBuf.insert(m_sendBuf.end(), header + written, header + sizeof(length));
+		m_sendBuf.insert(m_sendBuf.end(), data, data + size);
+	}
+	else
+	{
+		m_sendBuf.insert(m_sendBuf.end(), data + (written - sizeof(length)), data + size);
+	}
+
+	if (m_thread)
+	{
+		// Receive loop writes the queue when the socket is writable
+		UpdateEvents();
+	}
+	else
+	{
+		// No receive loop; wait for the socket to drain
+		while (m_connFd >= 0 && m_sendOffset < m_sendBuf.size())
+		{
+			pollfd pfd;
+			pfd.fd = m_connFd;
+			pfd.events = POLLOUT;
+			poll(&pfd, 1, -1);
+			if (!WriteQueued())
+				FailConnection();
+		}
+	}
+}
+
+//----------------------------------------------------------------------------
+// WriteQueued
+//----------------------------------------------------------------------------
+BOOL SocketTransport::WriteQueued()
+{
+	while (m_sendOffset < m_sendBuf.size())
+	{
+		ssize_t n = write(m_connFd, &m_sendBuf[m_sendOffset], m_sendBuf.size() - m_sendOffset);
+		if (n < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			return errno == EAGAIN || errno == EWOULDBLOCK;
+		}
+		m_sendOffset += (size_t)n;
+	}
+
+	// Queue drained; keep the capacity
+	m_sendBuf.clear();
+	m_sendOffset = 0;
+	return TRUE;
+}
+
+//----------------------------------------------------------------------------
+// UpdateEvents
+//----------------------------------------------------------------------------
+void SocketTransport::UpdateEvents()
+{
+	if (m_connFd < 0)
+		return;
+
+	epoll_event ev;
+	ev.events = EPOLLIN | EPOLLRDHUP;
+	if (m_sendOffset < m_sendBuf.size())
+		ev.events |= EPOLLOUT;
+	ev.data.fd = m_connFd;
+	epoll_ctl(m_epollFd, EPOLL_CTL_MOD, m_connFd, &ev);
+}
+
+//----------------------------------------------------------------------------
+// SetConnection
+//----------------------------------------------------------------------------
+void SocketTransport::SetConnection(int fd)
+{
+	SetNonBlocking(fd);
+
+	// Latency over bandwidth; queued writes are coalesced by this class instead.
+	// Fails harmlessly on Unix domain sockets.
+	int on = 1;
+	setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+
+	lock_guard<mutex> lock(m_sendLock);
+	CloseConnection();
+	m_connFd = fd;
+	m_recvSize = 0;
+
+	epoll_event ev;
+	ev.events = EPOLLIN | EPOLLRDHUP;
+	ev.data.fd = m_connFd;
+	epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_connFd, &ev);
+}
+
+//----------------------------------------------------------------------------
+// CloseConnection
+//----------------------------------------------------------------------------
+void SocketTransport::CloseConnection()
+{
+	if (m_connFd < 0)
+		return;
+
+	epoll_ctl(m_epollFd, EPOLL_CTL_DEL, m_connFd, NULL);
+	close(m_connFd);
+	m_connFd = -1;
+	m_sendBuf.clear();
+	m_sendOffset = 0;
+	m_broken = FALSE;
+}
+
+//----------------------------------------------------------------------------
+// FailConnection
+//----------------------------------------------------------------------------
+void SocketTransport::FailConnection()
+{
+	if (!m_thread)
+	{
+		CloseConnection();
+		return;
+	}
+
+	// The loop thread may be reading the socket; let it close the descriptor
+	m_broken = TRUE;
+	m_sendBuf.clear();
+	m_sendOffset = 0;
+	Wake();
+}
+
+//----------------------------------------------------------------------------
+// Wake
+//----------------------------------------------------------------------------
+void SocketTransport::Wake()
+{
+	uint64_t one = 1;
+	ssize_t n = write(m_wakeFd, &one, sizeof(one));
+	(void)n;
+}
+
+//----------------------------------------------------------------------------
+// Accept
+//----------------------------------------------------------------------------
+void SocketTransport::Accept()
+{
+	int fd = accept4(m_listenFd, NULL, NULL, SOCK_CLOEXEC);
+	if (fd >= 0)
+		SetConnection(fd);
+}
+
+//----------------------------------------------------------------------------
+// Read
+//----------------------------------------------------------------------------
+BOOL SocketTransport::Read()
+{
+	while (1)
+	{
+		if (m_recvBuf.size() - m_recvSize < RECV_CHUNK)
+			m_recvBuf.resize(m_recvSize + RECV_CHUNK);
+
+		ssize_t n = read(m_connFd, &m_recvBuf[m_recvSize], m_recvBuf.size() - m_recvSize);
+		if (n == 0)
+			return FALSE;
+		if (n < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			return errno == EAGAIN || errno == EWOULDBLOCK;
+		}
+		m_recvSize += (size_t)n;
+
+		// Invoke each complete frame
+		size_t offset = 0;
+		while (m_recvSize - offset >= sizeof(uint32_t))
+		{
+			uint32_t length;
+			memcpy(&length, &m_recvBuf[offset], sizeof(length));
+
+			// A length beyond the limit means a corrupt or hostile peer
+			if (length > m_maxFrameSize)
+				return FALSE;
+			if (m_recvSize - offset - sizeof(length) < length)
+				break;
+
+			const char* frame = &m_recvBuf[offset + sizeof(length)];
+			if (m_invokeThread)
+			{
+				auto copy = std::make_shared<std::string>(frame, length);
+				DelegateFreeAsync<void(std::shared_ptr<std::string>)> invoke(&SocketTransport::InvokeFrame, *m_invokeThread);
+				invoke(copy);
+			}
+			else
+			{
+				DelegateRemoteInvoker::Invoke(frame, length);
+			}
+			offset += sizeof(length) + length;
+		}
+
+		// Keep the partial frame, if any, at the front of the buffer
+		if (offset > 0)
+		{
+			memmove(&m_recvBuf[0], &m_recvBuf[offset], m_recvSize - offset);
+			m_recvSize -= offset;
+		}
+	}
+}
+
+//----------------------------------------------------------------------------
+// InvokeFrame
+//----------------------------------------------------------------------------
+void SocketTransport::InvokeFrame(std::shared_ptr<std::string> frame)
+{
+	DelegateRemoteInvoker::Invoke(frame->data(), frame->size());
+}
+
+//----------------------------------------------------------------------------
+// Process
+//----------------------------------------------------------------------------
+void SocketTransport::Process()
+{
+	epoll_event events[8];
+
+	while (!m_exit)
+	{
+		int n = epoll_wait(m_epollFd, events, 8, -1);
+		for (int i = 0; i < n && !m_exit; i++)
+		{
+			int fd = events[i].data.fd;
+			if (fd == m_wakeFd)
+			{
+				uint64_t value;
+				ssize_t r = read(m_wakeFd, &value, sizeof(value));
+				(void)r;
+
+				// Close a connection a sender found broken
+				lock_guard<mutex> lock(m_sendLock);
+				if (m_broken)
+					CloseConnection();
+			}
+			else if (fd == m_listenFd)
+			{
+				Accept();
+			}
+			else if (fd == m_connFd)
+			{
+				if (events[i].events & EPOLLOUT)
+				{
+					lock_guard<mutex> lock(m_sendLock);
+					if (!WriteQueued())
+						CloseConnection();
+					else
+						UpdateEvents();
+				}
+				if (events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR))
+				{
+					if (!Read())
+					{
+						lock_guard<mutex> lock(m_sendLock);
+						CloseConnection();
+					}
+				}
+			}
+		}
+	}
+}
+
+#endif
@@ -0,0 +1,146 @@
+#ifndef _SOCKET_TRANSPORT_H
+#define _SOCKET_TRANSPORT_H
+
+// SocketTransport.h
+// @see https://github.com/endurodave/AsyncMulticastDelegateCpp11
+
+#include "DelegateOpt.h"
+#if defined(__linux__)
+
+#include "DelegateTransport.h"
+#include "DelegateAsync.h"
+#include "DataTypes.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/// @brief A remote delegate transport over one AF_UNIX or loopback TCP stream
+/// socket connection. Each message is framed with a 32-bit host byte order length.
+///
+/// Start() runs a non-blocking epoll receive loop on its own thread. The loop
+/// accepts the peer (listening side), reassembles frames from partial reads and
+/// calls DelegateRemoteInvoker::Invoke() for each, either on the loop thread or,
+/// if a DelegateThread is given, marshalled onto that thread. Sends write
+/// directly to the socket when nothing is queued; a partial write queues the
+/// remainder and later sends are appended to it, so queued messages go out
+/// coalesced in one write when the socket becomes writable. A message that would
+/// grow the queue past its limit is dropped and counted, so a stalled peer cannot
+/// grow the queue without bound.
+///
+/// While the receive loop runs, only the loop thread closes the connection. A
+/// send that fails marks the connection broken and wakes the loop to close it.
+/// Connect before calling Start().
+class SocketTransport : public DelegateLib::IDelegateBufferTransport
+{
+public:
+	/// Constructor
+	SocketTransport();
+
+	/// Destructor
+	~SocketTransport();
+
+	/// Listen on a Unix domain socket path. The peer is accepted by the receive loop.
+	BOOL ListenUnix(const CHAR* path);
+
+	/// Listen on a 127.0.0.1 TCP port. The peer is accepted by the receive loop.
+	BOOL ListenTcp(UINT16 port);
+
+	/// Connect to a Unix domain socket path.
+	BOOL ConnectUnix(const CHAR* path);
+
+	/// Connect to a 127.0.0.1 TCP port.
+	BOOL ConnectTcp(UINT16 port);
+
+	/// Start the receive loop thread.
+	/// @param[in] thread - if not NULL, received messages are invoked on this
+	///		thread instead of the receive loop thread.
+	/// @return TRUE if the loop started.
+	BOOL Start(DelegateLib::DelegateThread* thread = NULL);
+
+	/// Stop the receive loop thread and close all sockets.
+	void Close();
+
+	/// Returns TRUE if connected to a peer.
+	BOOL IsConnected();
+
+	/// Set the largest frame accepted from the peer. A longer frame drops the
+	/// connection. Defaults to DELEGATE_REMOTE_MAX_FRAME_SIZE. Call before Start().
+	void SetMaxFrameSize(size_t size) { m_maxFrameSize = size; }
+
+	/// Set the most bytes queued for a peer that is not reading. A message sent while
+	/// queued bytes plus the message would exceed the limit is dropped. Defaults to
+	/// DELEGATE_REMOTE_MAX_SEND_QUEUE_SIZE. Call before sending.
+	void SetMaxSendQueueSize(size_t size) { m_maxSendQueueSize = size; }
+
+	/// Gets the number of messages DispatchDelegate() dropped on a full send queue.
+	uint64_t GetDroppedCount() const { return m_dropped; }
+
+	/// Send one serialized remote delegate message to the peer.
+	virtual void DispatchDelegate(const char* data, size_t size) override;
+
+private:
+	SocketTransport(const SocketTransport&) = delete;
+	SocketTransport& operator=(const SocketTransport&) = delete;
+
+	/// Receive loop thread entry point
+	void Process();
+
+	/// Accept a pending peer connection
+	void Accept();
+
+	/// Read available bytes and invoke each complete frame
+	/// @return FALSE if the peer closed the connection or sent an oversize frame
+	BOOL Read();
+
+	/// Write queued bytes. Caller must hold m_sendLock.
+	/// @return FALSE on a socket error
+	BOOL WriteQueued();
+
+	/// Register or re-arm the connection with epoll. Caller must hold m_sendLock.
+	void UpdateEvents();
+
+	/// Adopt a connected socket
+	void SetConnection(int fd);
+
+	/// Close the connection and discard queued bytes
+	void CloseConnection();
+
+	/// Handle a send error. Closes the connection if there is no receive loop,
+	/// otherwise marks it broken and wakes the loop to close it. Caller must 
+	/// hold m_sendLock.
+	void FailConnection();
+
+	/// Wake the receive loop
+	void Wake();
+
+	/// Invoke a received frame on the target DelegateThread
+	static void InvokeFrame(std::shared_ptr<std::string> frame);
+
+	int m_listenFd;
+	int m_connFd;
+	int m_epollFd;
+	int m_wakeFd;
+	std::string m_unixPath;
+
+	std::unique_ptr<std::thread> m_thread;
+	std::atomic<bool> m_exit;
+	DelegateLib::DelegateThread* m_invokeThread;
+
+	std::vector<char> m_recvBuf;
+	size_t m_recvSize;
+	size_t m_maxFrameSize;
+
+	std::vector<char> m_sendBuf;
+	size_t m_sendOffset;
+	size_t m_maxSendQueueSize;
+	std::atomic<uint64_t> m_dropped;
+	BOOL m_broken;				// Send failed; the loop closes the connection
+	std::mutex m_sendLock;
+};
+
+#endif
+
+#endif
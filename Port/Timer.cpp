@@ -4,32 +4,26 @@
 
 using namespace std;
 
-LOCK Timer::m_lock;
-bool Timer::m_lockInit = false;
-bool Timer::m_timerStopped = false;
-list<Timer*> Timer::m_timers;
-
-//------------------------------------------------------------------------------
-// TimerDisabled
-//------------------------------------------------------------------------------
-static bool TimerDisabled (Timer* value)
-{
-	return !(value->Enabled());
-}
+std::recursive_mutex Timer::m_lock;
+Timer* Timer::m_wheel[WHEEL_LEVELS][WHEEL_SLOTS];
+Timer* Timer::m_expired = NULL;
+uint64_t Timer::m_tick = 0;
+uint64_t Timer::m_targetTick = 0;
+unsigned long Timer::m_lastTime = 0;
+bool Timer::m_processing = false;
+unsigned long Timer::m_activeTimers = 0;
 
 //------------------------------------------------------------------------------
 // Constructor
 //------------------------------------------------------------------------------
 Timer::Timer() 
 {
-	// Create the thread mutex
-	if (m_lockInit == false)
-	{
-		LockGuard::Create(&m_lock);
-		m_lockInit = true;
-	}
-
-	LockGuard lockGuard(&m_lock);
+	lock_guard<recursive_mutex> lockGuard(m_lock);
+	m_timeout = 0;
+	m_expireTick = 0;
+	m_pNext = NULL;
+	m_pPrev = NULL;
+	m_pList = NULL;
 	m_enabled = false;
 }
 
@@ -38,8 +32,7 @@ Timer::Timer()
 //------------------------------------------------------------------------------
 Timer::~Timer()
 {
-	LockGuard lockGuard(&m_lock);
-	m_timers.remove(this);
+	Stop();
 }
 
 //------------------------------------------------------------------------------
@@ -47,18 +40,25 @@ Timer::~Timer()
 //------------------------------------------------------------------------------
 void Timer::Start(unsigned long timeout)
 {
-	LockGuard lockGuard(&m_lock);
+	lock_guard<recursive_mutex> lockGuard(m_lock);
 
 	m_timeout = timeout;
     ASSERT_TRUE(m_timeout != 0);
-	m_expireTime = GetTime();
+
+	if (m_enabled)
+		Unlink();
+	else
+		m_activeTimers++;
 	m_enabled = true;
 
-	// Remove the existing entry, if any, to prevent duplicates in the list
-	m_timers.remove(this);
+	// With no other timers running the wheel is idle, so bring it up to date
+	if (m_activeTimers == 1)
+		m_lastTime = GetTime();
 
-	// Add this timer to the list for servicing
-	m_timers.push_back(this);
+	// Expire relative to now. m_lastTime matches the tick being caught up to, 
+	// which is ahead of m_tick when started from an Expired callback.
+	m_expireTick = m_targetTick + Difference(m_lastTime, GetTime()) + m_timeout;
+	Insert();
 }
 
 //------------------------------------------------------------------------------
@@ -66,37 +66,116 @@ void Timer::Start(unsigned long timeout)
 //------------------------------------------------------------------------------
 void Timer::Stop()
 {
-	LockGuard lockGuard(&m_lock);
+	lock_guard<recursive_mutex> lockGuard(m_lock);
 
+	if (m_enabled)
+	{
+		Unlink();
+		m_activeTimers--;
+	}
 	m_enabled = false;
-	m_timerStopped = true;
 }
 
 //------------------------------------------------------------------------------
-// CheckExpired
+// Insert
 //------------------------------------------------------------------------------
-void Timer::CheckExpired()
+void Timer::Insert()
 {
-	if (!m_enabled)
+	uint64_t expire = m_expireTick < m_tick ? m_tick : m_expireTick;
+	uint64_t delta = expire - m_tick;
+
+	// Pick the lowest level whose range covers the delta. Beyond the top level
+	// the timer waits in the furthest slot and is placed again when cascaded.
+	int level = 0;
+	while (level < WHEEL_LEVELS - 1 && delta >> (WHEEL_BITS * (level + 1)))
+		level++;
+	if (delta >> (WHEEL_BITS * WHEEL_LEVELS))
+		expire = m_tick + (((uint64_t)1 << (WHEEL_BITS * WHEEL_LEVELS)) - 1);
+
+	m_pList = &m_wheel[level][(expire >> (WHEEL_BITS * level)) & WHEEL_MASK];
+	m_pPrev = NULL;
+	m_pNext = *m_pList;
+	if (m_pNext)
+		m_pNext->m_pPrev = this;
+	*m_pList = this;
+}
+
+//------------------------------------------------------------------------------
+// Unlink
+//------------------------------------------------------------------------------
+void Timer::Unlink()
+{
+	if (!m_pList)
 		return;
 
-	// Has the timer expired?
-    if (Difference(m_expireTime, GetTime()) < m_timeout)
-        return;
+	if (m_pPrev)
+		m_pPrev->m_pNext = m_pNext;
+	else
+		*m_pList = m_pNext;
+	if (m_pNext)
+		m_pNext->m_pPrev = m_pPrev;
 
-    // Increment the timer to the next expiration
-	m_expireTime += m_timeout;
+	m_pNext = NULL;
+	m_pPrev = NULL;
+	m_pList = NULL;
+}
 
-	// Is the timer already expired after we incremented above?
-    if (Difference(m_expireTime, GetTime()) > m_timeout)
+//------------------------------------------------------------------------------
+// Cascade
+//------------------------------------------------------------------------------
+int Timer::Cascade(int level)
+{
+	int index = (int)((m_tick >> (WHEEL_BITS * level)) & WHEEL_MASK);
+	Timer* timer = m_wheel[level][index];
+	m_wheel[level][index] = NULL;
+
+	// Each timer now expires within the range of a lower level
+	while (timer)
 	{
-		// The timer has fallen behind so set time expiration further forward.
-		m_expireTime = GetTime();
+		Timer* next = timer->m_pNext;
+		timer->Insert();
+		timer = next;
 	}
+	return index;
+}
 
-	// Call the client's expired callback function
-	if (Expired)
-		Expired();
+//------------------------------------------------------------------------------
+// ProcessTick
+//------------------------------------------------------------------------------
+void Timer::ProcessTick()
+{
+	m_tick++;
+
+	// When a level wraps, bring down the next slot of the level above
+	int index = (int)(m_tick & WHEEL_MASK);
+	for (int level = 1; index == 0 && level < WHEEL_LEVELS; level++)
+		index = Cascade(level);
+
+	// Take the whole slot as this tick's batch of expirations
+	Timer** slot = &m_wheel[0][m_tick & WHEEL_MASK];
+	if (!*slot)
+		return;
+	m_expired = *slot;
+	*slot = NULL;
+	for (Timer* timer = m_expired; timer; timer = timer->m_pNext)
+		timer->m_pList = &m_expired;
+
+	while (m_expired)
+	{
+		Timer* timer = m_expired;
+		timer->Unlink();
+
+		// Schedule the next period. If the timer has fallen behind by a whole 
+		// period, skip the missed expirations and set the expiration forward.
+		timer->m_expireTick += timer->m_timeout;
+		if (timer->m_expireTick <= m_targetTick)
+			timer->m_expireTick = m_targetTick + timer->m_timeout;
+		timer->Insert();
+
+		// Call the client's expired callback function
+		if (timer->Expired)
+			timer->Expired();
+	}
 }
 
 //------------------------------------------------------------------------------
@@ -112,22 +191,34 @@ unsigned long Timer::Difference(unsigned long time1, unsigned long time2)
 //------------------------------------------------------------------------------
 void Timer::ProcessTimers()
 {
-	LockGuard lockGuard(&m_lock);
+	lock_guard<recursive_mutex> lockGuard(m_lock);
 
-	// Remove disabled timer from the list if stopped
-	if (m_timerStopped)
-	{
-		m_timers.remove_if(TimerDisabled);
-		m_timerStopped = false;
-	}
+	// An Expired callback is already catching up on this thread
+	if (m_processing)
+		return;
 
-	// Iterate through each timer and check for expirations
-	TimersIterator it;
-	for (it = m_timers.begin() ; it != m_timers.end(); it++ )
-	{
-		if ((*it) != NULL)
-			(*it)->CheckExpired();
-	}
+	unsigned long now = GetTime();
+	unsigned long elapsed = Difference(m_lastTime, now);
+	m_lastTime = now;
+
+	// Nothing to expire, or the clock has been set back
+	if (m_activeTimers == 0 || (long)elapsed < 0)
+		return;
+
+	m_processing = true;
+	m_targetTick = m_tick + elapsed;
+	while (m_tick < m_targetTick)
+		ProcessTick();
+	m_processing = false;
+}
+
+//------------------------------------------------------------------------------
+// GetActiveTimers
+//------------------------------------------------------------------------------
+unsigned long Timer::GetActiveTimers()
+{
+	lock_guard<recursive_mutex> lockGuard(m_lock);
+	return m_activeTimers;
 }
 
 unsigned long Timer::GetTime()
@@ -2,13 +2,20 @@
 #define _TIMER_H
 
 #include "DelegateLib.h"
-#include "LockGuard.h"
-#include <list>
+#include <mutex>
+#include <stdint.h>
 
 using namespace DelegateLib;
 
 /// @brief A timer class provides periodic timer callbacks on the client's 
 /// thread of control. Timer is thread safe.
+///
+/// Active timers are kept in a hierarchical timing wheel of 1 ms ticks: four 
+/// levels of 256 slots, each slot a doubly linked list of the timers expiring
+/// in it. Start() and Stop() link and unlink a timer in O(1), and ProcessTimers()
+/// only visits the slot of each elapsed tick, moving the timers of a higher level
+/// slot down a level when the lower level wraps. The timers expiring on a tick 
+/// are collected and their callbacks invoked as one batch.
 class Timer 
 {
 public:
@@ -43,31 +50,72 @@ public:
 	/// @return		The time difference in ticks.
 	static unsigned long Difference(unsigned long time1, unsigned long time2);
 
-	/// Called on a periodic basic to service all timer instances. 
+	/// Called on a periodic basic to service all timer instances. Expired 
+	/// callbacks are invoked on the calling thread with the timer lock held. 
+	/// The lock is recursive, so a callback may Start() or Stop() any timer; a
+	/// timer started while the wheel catches up expires relative to the time 
+	/// being caught up to. A nested ProcessTimers() call returns immediately.
 	static void ProcessTimers();
 
+	/// Gets the number of started timers.
+	/// @return The number of enabled timers.
+	static unsigned long GetActiveTimers();
+
 private:
 	// Prevent inadvertent copying of this object
 	Timer(const Timer&);
 	Timer& operator=(const Timer&);
 
-	/// Called to check for expired timers and callback registered clients.
-	void CheckExpired();
+	static const int WHEEL_LEVELS = 4;
+	static const int WHEEL_BITS = 8;
+	static const int WHEEL_SLOTS = 1 << WHEEL_BITS;
+	static const uint64_t WHEEL_MASK = WHEEL_SLOTS - 1;
+
+	/// Link the timer into the wheel slot for its expiration tick.
+	void Insert();
+
+	/// Unlink the timer from its wheel slot or the expired batch.
+	void Unlink();
+
+	/// Move the timers of a higher level slot down the wheel. 
+	/// @return The slot index, zero when the level has wrapped.
+	static int Cascade(int level);
+
+	/// Advance the wheel one tick and invoke the expired timers.
+	static void ProcessTick();
+
+	/// The timing wheel slots. Each is the head of a list of timers.
+	static Timer* m_wheel[WHEEL_LEVELS][WHEEL_SLOTS];
+
+	/// The batch of timers expiring on the tick being processed.
+	static Timer* m_expired;
+
+	/// The last processed tick.
+	static uint64_t m_tick;
+
+	/// The tick matching m_lastTime. Ahead of m_tick while ProcessTimers() 
+	/// catches up, equal otherwise.
+	static uint64_t m_targetTick;
+
+	/// GetTime() at the last ProcessTimers() call, or when the idle wheel restarted.
+	static unsigned long m_lastTime;
 
-	/// List of all system timers to be serviced.
-	static std::list<Timer*> m_timers;
-	typedef std::list<Timer*>::iterator TimersIterator;
+	/// TRUE while ProcessTimers() steps the wheel.
+	static bool m_processing;
 
-	/// A lock to make this class thread safe.
-	static LOCK m_lock;
+	/// Number of started timers.
+	static unsigned long m_activeTimers;
 
-	/// TRUE if lock initialized.
-	static bool m_lockInit;
+	/// A lock to make this class thread safe. Recursive so that Expired 
+	/// callbacks, invoked with the lock held, may start and stop timers.
+	static std::recursive_mutex m_lock;
 
 	unsigned long m_timeout;		// in ticks
-	unsigned long m_expireTime;		// in ticks
+	uint64_t m_expireTick;
+	Timer* m_pNext;
+	Timer* m_pPrev;
+	Timer** m_pList;				// list head holding the timer, or NULL
 	bool m_enabled;
-	static bool m_timerStopped;
 };
 
 #endif
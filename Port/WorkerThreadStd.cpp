@@ -21,7 +21,7 @@ using namespace std::chrono;
 //----------------------------------------------------------------------------
 // WorkerThread
 //----------------------------------------------------------------------------
-WorkerThread::WorkerThread(const CHAR* threadName) : m_thread(nullptr), m_timerExit(false), THREAD_NAME(threadName)
+WorkerThread::WorkerThread(const CHAR* threadName) : m_thread(nullptr), m_allocator(nullptr), m_timerExit(false), THREAD_NAME(threadName)
 {
 }
 
@@ -97,6 +97,24 @@ void WorkerThread::ExitThread()
     m_thread = nullptr;
 }
 
+//----------------------------------------------------------------------------
+// EnableMessageArena
+//----------------------------------------------------------------------------
+void WorkerThread::EnableMessageArena(size_t chunkSize, UINT chunks)
+{
+	ASSERT_TRUE(!m_thread && !m_arena);
+	m_arena.reset(new MessageArena(chunkSize, chunks));
+}
+
+//----------------------------------------------------------------------------
+// SetAllocator
+//----------------------------------------------------------------------------
+void WorkerThread::SetAllocator(IDelegateAllocator* allocator)
+{
+	ASSERT_TRUE(!m_thread);
+	m_allocator = allocator;
+}
+
 //----------------------------------------------------------------------------
 // DispatchDelegate
 //----------------------------------------------------------------------------
@@ -104,8 +122,14 @@ void WorkerThread::DispatchDelegate(std::shared_ptr<DelegateLib::DelegateMsgBase
 {
 	ASSERT_TRUE(m_thread);
 
-	// Create a new ThreadMsg
-    std::shared_ptr<ThreadMsg> threadMsg(new ThreadMsg(MSG_DISPATCH_DELEGATE, msg));
+	// Create a new ThreadMsg, from the allocator or message arena if enabled
+	std::shared_ptr<ThreadMsg> threadMsg;
+	if (m_allocator)
+		threadMsg = std::allocate_shared<ThreadMsg>(DelegateAllocatorAdapter<ThreadMsg>(m_allocator), MSG_DISPATCH_DELEGATE, msg);
+	else if (m_arena)
+		threadMsg = std::allocate_shared<ThreadMsg>(MessageArenaAllocator<ThreadMsg>(m_arena.get()), MSG_DISPATCH_DELEGATE, msg);
+	else
+		threadMsg.reset(new ThreadMsg(MSG_DISPATCH_DELEGATE, msg));
 
 	// Add dispatch delegate msg to queue and notify worker thread
 	std::unique_lock<std::mutex> lk(m_mutex);
@@ -39,8 +39,27 @@ public:
 	/// Get the ID of the currently executing thread
 	static std::thread::id GetCurrentThreadId();
 
+	/// Allocate the messages dispatched to this thread from a message arena of
+	/// chunks x chunkSize bytes instead of the heap. Call before CreateThread().
+	/// Messages must not be kept beyond the life of the thread; the arena asserts
+	/// on destruction if any are still held.
+	/// @param[in] chunkSize - size of each arena chunk in bytes.
+	/// @param[in] chunks - number of chunks in the arena ring.
+	void EnableMessageArena(size_t chunkSize, UINT chunks);
+
+	/// Allocate the messages, delegate clones and argument copies of asynchronous
+	/// delegates targeting this thread from allocator, unless the delegate was
+	/// created with its own. Call before CreateThread().
+	/// @param[in] allocator - the allocator, or nullptr for the default allocation.
+	///		Must outlive the thread.
+	void SetAllocator(DelegateLib::IDelegateAllocator* allocator);
+
 	virtual void DispatchDelegate(std::shared_ptr<DelegateLib::DelegateMsgBase> msg);
 
+	virtual DelegateLib::MessageArena* GetMessageArena() { return m_arena.get(); }
+
+	virtual DelegateLib::IDelegateAllocator* GetAllocator() { return m_allocator; }
+
 private:
 	WorkerThread(const WorkerThread&) = delete;
 	WorkerThread& operator=(const WorkerThread&) = delete;
@@ -52,6 +71,11 @@ private:
     void TimerThread();
 
 	std::unique_ptr<std::thread> m_thread;
+
+	// Messages allocated from the arena refer to it by raw pointer. Declared
+	// before m_queue so messages left in the queue are destroyed first.
+	std::unique_ptr<DelegateLib::MessageArena> m_arena;
+	DelegateLib::IDelegateAllocator* m_allocator;
 	std::queue<std::shared_ptr<ThreadMsg>> m_queue;
 	std::mutex m_mutex;
 	std::condition_variable m_cv;
@@ -6,6 +6,9 @@
 #include <sstream>
 #include <thread>
 #include <algorithm>
+#ifdef USE_XALLOCATOR
+#include "xallocator.h"
+#endif
 #if USE_STD_THREADS
 #include "WorkerThreadStd.h"
 #elif USE_WIN32_THREADS
@@ -205,6 +208,24 @@ void TimerExpiredCb(void)
     cout << "TimerExpiredCb " << count++ << endl;
 }
 
+// Define XALLOC_STATS_DEMO with USE_XALLOCATOR to print the xallocator statistics
+// every second while the demo runs
+#if defined(USE_XALLOCATOR) && defined(XALLOC_STATS_DEMO)
+/// Periodically sample the xallocator statistics. Logging the high water marks 
+/// of a production run gives the blocks needed per size class with STATIC_POOLS.
+void XallocStatsCb(void)
+{
+    const size_t MAX_STATS = 64;
+    XallocStats stats[MAX_STATS];
+    size_t count = xalloc_get_stats(stats, MAX_STATS);
+    for (size_t i = 0; i < count && i < MAX_STATS; i++)
+    {
+        cout << "XallocStatsCb Block Size: " << stats[i].blockSize << " In Use: " << stats[i].blocksInUse
+            << " High Water: " << stats[i].highWater << " Failed: " << stats[i].failedAllocations << endl;
+    }
+}
+#endif
+
 class RemoteData
 {
 public:
@@ -218,19 +239,8 @@ private:
 	int m_x = 0;
 	int m_y = 0;
 
-	friend std::ostream& operator<< (std::ostream& out, const RemoteData& data)
-	{
-		out << data.m_x << std::endl;
-		out << data.m_y << std::endl;
-		return out;
-	}
-
-	friend std::istream& operator>> (std::istream& in, RemoteData& data)
-	{
-		in >> data.m_x;
-		in >> data.m_y;
-		return in;
-	}
+	// Generate the binary remote delegate serialization
+	DELEGATE_FIELDS(m_x, m_y)
 };
 
 class RemoteRecv
@@ -296,6 +306,7 @@ void CoordinatesChangedCallbackError3(std::shared_ptr<const Coordinates>* c) {}
 void CoordinatesChangedCallbackError4(const std::shared_ptr<const Coordinates>* c) {}
 
 extern void DelegateUnitTests();
+extern void DelegateBenchmarks();
 
 //------------------------------------------------------------------------------
 // main
@@ -308,6 +319,11 @@ int main(void)
 
 	TestClass testClass;
 
+	// Run benchmarks before any thread is created, as some fork
+#ifdef DELEGATE_BENCHMARKS
+	DelegateBenchmarks();
+#endif
+
 	// Create the worker threads
 	workerThread1.CreateThread();
 	SysDataNoLock::GetInstance();
@@ -323,6 +339,13 @@ int main(void)
     timer.Expired = MakeDelegate(&TimerExpiredCb, workerThread1);
     timer.Start(250);
 
+#if defined(USE_XALLOCATOR) && defined(XALLOC_STATS_DEMO)
+    // Sample the xallocator statistics every second on workerThread1
+    Timer statsTimer;
+    statsTimer.Expired = MakeDelegate(&XallocStatsCb, workerThread1);
+    statsTimer.Start(1000);
+#endif
+
 	// Run all unit tests (uncomment to run unit tests)
 #ifdef DELEGATE_UNIT_TESTS
 	DelegateUnitTests();
@@ -628,6 +651,10 @@ int main(void)
 
     timer.Stop();
     timer.Expired.Clear();
+#if defined(USE_XALLOCATOR) && defined(XALLOC_STATS_DEMO)
+    statsTimer.Stop();
+    statsTimer.Expired.Clear();
+#endif
 
     std::this_thread::sleep_for(std::chrono::seconds(1));
 